@@ -0,0 +1,265 @@
+/* Aaron Gallagher's Spell System Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunChannelSpellBenchmark(const TArray<FString>& Args);
+
+// Spells.ChannelBench <Channelers> <Targets> <Seconds>, times the batched pass against one overlap test per beam and target
+static FAutoConsoleCommandWithArgs GChannelSpellBenchCommand(
+	TEXT("Spells.ChannelBench"),
+	TEXT("Spells.ChannelBench <Channelers> <Targets> <Seconds>: times batched channel ticks against a per beam overlap pass"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunChannelSpellBenchmark));
+#endif
+
+// Ticks happen at every multiple of 1 / TicksPerSecond of the World time, whatever the frame rate
+void FChannelSpellBatch::SetTickRate(float TicksPerSecond)
+{
+	const double NewInterval = 1.0 / FMath::Max(TicksPerSecond, 1.f);
+	if (NewInterval == TickInterval) return;
+	const double NextTickTime = NextTick * TickInterval;
+	TickInterval = NewInterval;
+	NextTick = (int64)FMath::CeilToDouble(NextTickTime / TickInterval); // ticks already run are not run again at the new rate
+}
+
+// Adds a beam from Start to End with Radius that deals DamagePerSecond, split evenly over the ticks, to every target it overlaps
+// Only ticks at or after DamageStartTime deal damage, CasterID is never damaged by its own beam
+// Returns an ID that can be passed to UpdateChannel() and EndChannel()
+int32 FChannelSpellBatch::BeginChannel(int32 ContextIndex, int32 CasterID, const FVector& Start, const FVector& End, float Radius, float DamagePerSecond, double DamageStartTime)
+{
+	FChannel& Channel = Channels.AddDefaulted_GetRef();
+	Channel.Start = Start;
+	Channel.End = End;
+	Channel.Radius = Radius;
+	Channel.DamagePerSecond = DamagePerSecond;
+	Channel.DamageStartTime = DamageStartTime;
+	Channel.EndTime = MAX_dbl;
+	Channel.ChannelID = NextChannelID++;
+	Channel.ContextIndex = ContextIndex;
+	Channel.CasterID = CasterID;
+	return Channel.ChannelID;
+}
+
+// Moves a beam, used by every tick of the next Step()
+void FChannelSpellBatch::UpdateChannel(int32 ChannelID, const FVector& Start, const FVector& End)
+{
+	if (FChannel* Channel = FindChannel(ChannelID))
+	{
+		Channel->Start = Start;
+		Channel->End = End;
+	}
+}
+
+// Ticks after EndTime deal no damage, the channel is removed by the first Step() that reaches EndTime
+// A channel that ends before its DamageStartTime never deals damage
+void FChannelSpellBatch::EndChannel(int32 ChannelID, double EndTime)
+{
+	if (FChannel* Channel = FindChannel(ChannelID))
+	{
+		Channel->EndTime = FMath::Min(Channel->EndTime, EndTime);
+	}
+}
+
+// Runs every tick due at or before Now with one overlap query per channel
+// Appends the damage of each channel to each target in ChannelID then TargetID order, and the ContextIndex of every channel removed to OutEnded
+// A beam does not move between the ticks of one step, so every tick of the step overlaps the same targets and is counted instead of queried again
+void FChannelSpellBatch::Step(double Now, const FSpellSpatialHash& SpatialHash, TArray<FChannelSpellDamage>& OutDamage, TArray<int32>& OutEnded)
+{
+	const int64 LastTick = (int64)FMath::FloorToDouble(Now / TickInterval);
+
+	int32 WriteIndex = 0;
+	for (int32 i = 0; i < Channels.Num(); i++)
+	{
+		FChannel& Channel = Channels[i];
+		const bool bHasEnded = (Channel.EndTime != MAX_dbl);
+		const int64 EndTick = bHasEnded ? (int64)FMath::FloorToDouble(Channel.EndTime / TickInterval) : LastTick;
+		const int64 FirstTick = FMath::Max(NextTick, (int64)FMath::CeilToDouble(Channel.DamageStartTime / TickInterval));
+		const int64 NumTicks = FMath::Min(LastTick, EndTick) - FirstTick + 1;
+		if (NumTicks > 0)
+		{
+			Overlaps.Reset();
+			SpatialHash.OverlapCapsule(Channel.Start, Channel.End, Channel.Radius, Channel.CasterID, Overlaps);
+			for (int32 TargetIndex : Overlaps)
+			{
+				FChannelSpellDamage& Damage = OutDamage.AddDefaulted_GetRef();
+				Damage.ChannelID = Channel.ChannelID;
+				Damage.ContextIndex = Channel.ContextIndex;
+				Damage.TargetID = SpatialHash.GetTarget(TargetIndex).TargetID;
+				Damage.Amount = (float)(Channel.DamagePerSecond * TickInterval * NumTicks);
+				Damage.NumTicks = (int32)NumTicks;
+			}
+		}
+		if (bHasEnded && EndTick <= LastTick)
+		{
+			OutEnded.Add(Channel.ContextIndex);
+			continue;
+		}
+
+		if (WriteIndex != i) Channels[WriteIndex] = Channel;
+		++WriteIndex;
+	}
+	Channels.SetNum(WriteIndex, false);
+	NextTick = FMath::Max(NextTick, LastTick + 1);
+}
+
+void FChannelSpellBatch::Reset()
+{
+	Channels.Reset();
+	NextTick = 0;
+}
+
+FChannelSpellBatch::FChannel* FChannelSpellBatch::FindChannel(int32 ChannelID)
+{
+	// Channels are appended with increasing IDs and removed in place, so the array stays sorted
+	const int32 Index = Algo::BinarySearchBy(Channels, ChannelID, [](const FChannel& Channel) { return Channel.ChannelID; });
+	return (Index != INDEX_NONE) ? &Channels[Index] : nullptr;
+}
+
+#if !UE_BUILD_SHIPPING
+// NumChannelers beams over NumTargets targets stepped at 60 frames per second
+// Uses generated beams and targets so it runs without a World
+static void RunChannelSpellBenchmark(const TArray<FString>& Args)
+{
+	const int32 NumChannelers = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 500;
+	const int32 NumTargets = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 2000;
+	const float Seconds = Args.IsValidIndex(2) ? FMath::Max(FCString::Atof(*Args[2]), 0.1f) : 10.f;
+	const float FrameTime = 1.f / 60.f;
+	const float TicksPerSecond = 10.f;
+
+	TArray<FChannelSpellDamage> Damage;
+	TArray<int32> Ended;
+
+	// Channelers in a field of targets, each beam turns a little every frame
+	FRandomStream Random(NumChannelers);
+	TArray<FSpellTargetBounds> Targets;
+	for (int32 i = 0; i < NumTargets; i++)
+	{
+		Targets.Add({ FVector(Random.FRandRange(0.f, 10000.f), Random.FRandRange(0.f, 10000.f), 0.f), 50.f, NumChannelers + i });
+	}
+	TArray<FVector> Origins;
+	TArray<float> Yaws;
+	for (int32 i = 0; i < NumChannelers; i++)
+	{
+		Origins.Add(FVector(Random.FRandRange(0.f, 10000.f), Random.FRandRange(0.f, 10000.f), 0.f));
+		Yaws.Add(Random.FRandRange(0.f, 2.f * PI));
+	}
+	const float BeamLength = 1500.f;
+	const float BeamRadius = 30.f;
+	auto GetBeamEnd = [&](int32 Channeler, double Now) { return Origins[Channeler] + (BeamLength * FVector(FMath::Cos(Yaws[Channeler] + Now), FMath::Sin(Yaws[Channeler] + Now), 0.f)); };
+
+	FSpellSpatialHash SpatialHash;
+	SpatialHash.Build(Targets, 200.f);
+	FChannelSpellBatch Batch;
+	Batch.SetTickRate(TicksPerSecond);
+	TArray<int32> ChannelIDs;
+	for (int32 i = 0; i < NumChannelers; i++)
+	{
+		ChannelIDs.Add(Batch.BeginChannel(i, i, Origins[i], GetBeamEnd(i, 0.0), BeamRadius, 10.f, 0.0));
+	}
+
+	double BatchedDamage = 0.0;
+	int32 BatchedEntries = 0;
+	const double BatchedStart = FPlatformTime::Seconds();
+	for (double Now = FrameTime; Now <= Seconds; Now += FrameTime)
+	{
+		for (int32 i = 0; i < NumChannelers; i++)
+		{
+			Batch.UpdateChannel(ChannelIDs[i], Origins[i], GetBeamEnd(i, Now));
+		}
+		Damage.Reset();
+		Batch.Step(Now, SpatialHash, Damage, Ended);
+		for (const FChannelSpellDamage& Entry : Damage)
+		{
+			BatchedDamage += Entry.Amount;
+		}
+		BatchedEntries += Damage.Num();
+	}
+	const double BatchedSeconds = FPlatformTime::Seconds() - BatchedStart;
+
+	// Same beams tested against every target on every tick, the way one overlapping capsule per channel applies damage
+	double PerBeamDamage = 0.0;
+	int32 PerBeamApplications = 0;
+	const double PerBeamStart = FPlatformTime::Seconds();
+	int64 NextTick = 0;
+	for (double Now = FrameTime; Now <= Seconds; Now += FrameTime)
+	{
+		for (const int64 LastTick = (int64)FMath::FloorToDouble(Now / Batch.GetTickInterval()); NextTick <= LastTick; NextTick++)
+		{
+			for (int32 i = 0; i < NumChannelers; i++)
+			{
+				const FVector End = GetBeamEnd(i, Now);
+				for (const FSpellTargetBounds& Target : Targets)
+				{
+					if (FMath::PointDistToSegmentSquared(Target.Center, Origins[i], End) > FMath::Square(BeamRadius + Target.Radius)) continue;
+					PerBeamDamage += 10.f * Batch.GetTickInterval();
+					PerBeamApplications++;
+				}
+			}
+		}
+	}
+	const double PerBeamSeconds = FPlatformTime::Seconds() - PerBeamStart;
+
+	UE_LOG(LogTemp, Log, TEXT("Spells.ChannelBench: %d channelers, %d targets, %.1f seconds at %.0f ticks per second"), NumChannelers, NumTargets, Seconds, TicksPerSecond);
+	UE_LOG(LogTemp, Log, TEXT("Spells.ChannelBench: batched %.3f ms, %d damage applications, %.1f damage"), BatchedSeconds * 1000.0, BatchedEntries, BatchedDamage);
+	UE_LOG(LogTemp, Log, TEXT("Spells.ChannelBench: per beam %.3f ms, %d damage applications, %.1f damage, %s"), PerBeamSeconds * 1000.0, PerBeamApplications, PerBeamDamage,
+		FMath::IsNearlyEqual(BatchedDamage, PerBeamDamage, FMath::Max(PerBeamDamage, 1.0) * 0.001) ? TEXT("matches batched") : TEXT("DOES NOT MATCH BATCHED"));
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChannelSpellEdgesTest, "Spells.Channel.Edges", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// Cast start and end edges, 10 damage per second at 10 ticks per second against one target in front of the beam, stepped at 60 frames per second
+bool FChannelSpellEdgesTest::RunTest(const FString& Parameters)
+{
+	const float FrameTime = 1.f / 60.f;
+	TArray<FChannelSpellDamage> Damage;
+	TArray<int32> Ended;
+	TArray<FSpellTargetBounds> EdgeTargets = { { FVector(100.f, 0.f, 0.f), 50.f, 2 } };
+	FSpellSpatialHash EdgeHash;
+	EdgeHash.Build(EdgeTargets, 200.f);
+	struct FEdgeCase
+	{
+		const TCHAR* Name;
+		double BeginTime;
+		double DamageStartTime;
+		double EndTime;
+		int32 ExpectedTicks;
+	};
+	const FEdgeCase EdgeCases[] =
+	{
+		{ TEXT("Released before the blast activates"), 0.0, 0.5, 0.3, 0 },
+		{ TEXT("Released on the activation tick"), 0.0, 0.5, 0.5, 1 },
+		{ TEXT("Held between two ticks"), 0.02, 0.02, 0.08, 0 },
+		{ TEXT("Held for one second"), 0.05, 0.05, 1.05, 10 },
+		{ TEXT("Begun and released mid frame"), 1.01, 1.01, 1.31, 3 },
+	};
+	for (const FEdgeCase& EdgeCase : EdgeCases)
+	{
+		FChannelSpellBatch Batch;
+		Batch.SetTickRate(10.f);
+		Batch.Step(EdgeCase.BeginTime, EdgeHash, Damage, Ended); // the frame the cast starts on
+		const int32 ChannelID = Batch.BeginChannel(0, 1, FVector::ZeroVector, FVector(200.f, 0.f, 0.f), 20.f, 10.f, EdgeCase.DamageStartTime);
+		bool bEndedThisRun = false;
+		int32 Ticks = 0;
+		Ended.Reset();
+		for (double Now = EdgeCase.BeginTime + FrameTime; Batch.Num() > 0 && Now < 3.0; Now += FrameTime)
+		{
+			if (!bEndedThisRun && Now >= EdgeCase.EndTime)
+			{
+				Batch.EndChannel(ChannelID, EdgeCase.EndTime); // EndCasting lands inside a frame, its time is used rather than the frame's
+				bEndedThisRun = true;
+			}
+			Damage.Reset();
+			Batch.Step(Now, EdgeHash, Damage, Ended);
+			for (const FChannelSpellDamage& Entry : Damage)
+			{
+				Ticks += Entry.NumTicks;
+			}
+		}
+		TestEqual(FString(EdgeCase.Name) + TEXT(": ticks"), Ticks, EdgeCase.ExpectedTicks);
+		TestEqual(FString(EdgeCase.Name) + TEXT(": channels ended"), Ended.Num(), 1);
+	}
+	return true;
+}
+#endif
+#endif
@@ -0,0 +1,86 @@
+#pragma once
+/* Aaron Gallagher's Spell System Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Damage a channel dealt to one target during FChannelSpellBatch::Step(), every tick of the step is merged into one entry */
+struct FChannelSpellDamage
+{
+	int32 ChannelID;
+
+	int32 ContextIndex; // caller data passed to BeginChannel(), used to find the spell and damage type
+
+	int32 TargetID;
+
+	float Amount;
+
+	int32 NumTicks;
+};
+
+
+/* Every active channel spell beam, stepped at a fixed tick rate against the spatial hash in one pass */
+/* Replaces a collision capsule and overlap events per channel, a target overlapped by a beam is damaged once per tick */
+/* Only uses Core types so it can be driven without a World */
+class FChannelSpellBatch
+{
+public:
+
+	FChannelSpellBatch()
+	{
+		TickInterval = 0.1;
+		NextTick = 0;
+		NextChannelID = 1;
+	}
+
+	// Ticks happen at every multiple of 1 / TicksPerSecond of the World time, whatever the frame rate
+	void SetTickRate(float TicksPerSecond);
+
+	double GetTickInterval() const { return TickInterval; }
+
+	// Adds a beam from Start to End with Radius that deals DamagePerSecond, split evenly over the ticks, to every target it overlaps
+	// Only ticks at or after DamageStartTime deal damage, CasterID is never damaged by its own beam
+	// Returns an ID that can be passed to UpdateChannel() and EndChannel()
+	int32 BeginChannel(int32 ContextIndex, int32 CasterID, const FVector& Start, const FVector& End, float Radius, float DamagePerSecond, double DamageStartTime);
+
+	// Moves a beam, used by every tick of the next Step()
+	void UpdateChannel(int32 ChannelID, const FVector& Start, const FVector& End);
+
+	// Ticks after EndTime deal no damage, the channel is removed by the first Step() that reaches EndTime
+	// A channel that ends before its DamageStartTime never deals damage
+	void EndChannel(int32 ChannelID, double EndTime);
+
+	// Runs every tick due at or before Now with one overlap query per channel
+	// Appends the damage of each channel to each target in ChannelID then TargetID order, and the ContextIndex of every channel removed to OutEnded
+	void Step(double Now, const FSpellSpatialHash& SpatialHash, TArray<FChannelSpellDamage>& OutDamage, TArray<int32>& OutEnded);
+
+	int32 Num() const { return Channels.Num(); }
+
+	void Reset();
+
+private:
+
+	struct FChannel
+	{
+		FVector Start;
+		FVector End;
+		float Radius;
+		float DamagePerSecond;
+		double DamageStartTime;
+		double EndTime; // MAX_dbl until EndChannel()
+		int32 ChannelID;
+		int32 ContextIndex;
+		int32 CasterID;
+	};
+
+	FChannel* FindChannel(int32 ChannelID);
+
+	TArray<FChannel> Channels; // kept in ChannelID order
+
+	TArray<int32> Overlaps; // reused by Step()
+
+	int64 NextTick; // index of the first tick Step() has not run, tick N happens at N * TickInterval
+
+	double TickInterval; // double so tick times match the World time they are compared to
+
+	int32 NextChannelID;
+};
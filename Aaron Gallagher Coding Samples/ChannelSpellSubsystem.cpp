@@ -0,0 +1,109 @@
+/* Aaron Gallagher's Spell System Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+// Starts damaging every character Beam overlaps with DamagePerSecond of DamageType, from DamageDelay seconds after now until EndChannel()
+// Beam is read every frame so the channel follows the caster
+void UChannelSpellSubsystem::BeginChannel(AChannelSpellBase* Spell, UCapsuleComponent* Beam, float DamagePerSecond, TSubclassOf<UDamageType> DamageType, float DamageDelay)
+{
+	if (!Spell || !Beam) return;
+	EndChannel(Spell); // a spell only has one channel, casting again restarts it
+
+	FVector Start;
+	FVector End;
+	GetBeamSegment(Beam, Start, End);
+	const AActor* Caster = Spell->GetOwner();
+	const int32 CasterID = Caster ? (int32)Caster->GetUniqueID() : INDEX_NONE;
+
+	FChannelContext Context;
+	Context.Spell = Spell;
+	Context.Beam = Beam;
+	Context.DamageType = DamageType;
+	const int32 ContextIndex = Contexts.Add(Context);
+
+	Batch.SetTickRate(TickRate);
+	Contexts[ContextIndex].ChannelID = Batch.BeginChannel(ContextIndex, CasterID, Start, End, Beam->GetScaledCapsuleRadius(), DamagePerSecond, GetWorld()->GetTimeSeconds() + DamageDelay);
+	ContextsBySpell.Add(Spell, ContextIndex);
+}
+
+// Stops Spell's channel, damage ticks up to now are still applied by the next Tick()
+void UChannelSpellSubsystem::EndChannel(AChannelSpellBase* Spell)
+{
+	int32 ContextIndex = INDEX_NONE;
+	if (!ContextsBySpell.RemoveAndCopyValue(Spell, ContextIndex)) return;
+	Batch.EndChannel(Contexts[ContextIndex].ChannelID, GetWorld()->GetTimeSeconds()); // the context is removed when the batch reports the channel ended
+}
+
+// Moves every beam, runs the ticks due this frame in one overlap pass and applies one damage event per beam and character
+void UChannelSpellSubsystem::Tick(float DeltaTime)
+{
+	UWorld* World = GetWorld();
+	if (!World) return;
+	const double Now = World->GetTimeSeconds();
+
+	for (TSparseArray<FChannelContext>::TIterator It(Contexts); It; ++It)
+	{
+		const UCapsuleComponent* Beam = It->Beam.Get();
+		if (!Beam || !It->Spell.IsValid())
+		{
+			Batch.EndChannel(It->ChannelID, Now); // destroyed while channeling
+			continue;
+		}
+		FVector Start;
+		FVector End;
+		GetBeamSegment(Beam, Start, End);
+		Batch.UpdateChannel(It->ChannelID, Start, End);
+	}
+
+	BuildTargets();
+
+	PendingDamage.Reset();
+	EndedContexts.Reset();
+	Batch.SetTickRate(TickRate);
+	Batch.Step(Now, SpatialHash, PendingDamage, EndedContexts);
+
+	for (const FChannelSpellDamage& Damage : PendingDamage)
+	{
+		const FChannelContext& Context = Contexts[Damage.ContextIndex];
+		ACharacter* Character = CharactersByTargetID.FindRef(Damage.TargetID).Get();
+		AChannelSpellBase* Spell = Context.Spell.Get();
+		if (!Character || !Spell) continue;
+		UGameplayStatics::ApplyDamage(Character, Damage.Amount, Spell->GetInstigatorController(), Spell, Context.DamageType);
+	}
+
+	for (int32 ContextIndex : EndedContexts)
+	{
+		// The spell may already have begun a new channel with a different context
+		const TWeakObjectPtr<AChannelSpellBase> Spell = Contexts[ContextIndex].Spell;
+		if (ContextsBySpell.FindRef(Spell) == ContextIndex) ContextsBySpell.Remove(Spell);
+		Contexts.RemoveAt(ContextIndex);
+	}
+}
+
+// Segment along the capsule's axis between the centres of its end caps
+void UChannelSpellSubsystem::GetBeamSegment(const UCapsuleComponent* Beam, FVector& OutStart, FVector& OutEnd)
+{
+	const FVector Axis = Beam->GetUpVector() * (Beam->GetScaledCapsuleHalfHeight() - Beam->GetScaledCapsuleRadius());
+	OutStart = Beam->GetComponentLocation() - Axis;
+	OutEnd = Beam->GetComponentLocation() + Axis;
+}
+
+// Rebuilds the spatial hash from the capsule of every character in the World
+void UChannelSpellSubsystem::BuildTargets()
+{
+	TargetBounds.Reset();
+	CharactersByTargetID.Reset();
+	for (TActorIterator<ACharacter> It(GetWorld()); It; ++It)
+	{
+		ACharacter* Character = *It;
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+		if (!Capsule) continue;
+
+		FSpellTargetBounds& Bounds = TargetBounds.AddDefaulted_GetRef();
+		Bounds.Center = Capsule->GetComponentLocation();
+		Bounds.Radius = Capsule->GetScaledCapsuleHalfHeight(); // sphere around the whole capsule
+		Bounds.TargetID = (int32)Character->GetUniqueID();
+		CharactersByTargetID.Add(Bounds.TargetID, Character);
+	}
+	SpatialHash.Build(TargetBounds, CellSize);
+}
@@ -0,0 +1,69 @@
+#pragma once
+/* Aaron Gallagher's Spell System Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Deals the damage of every channel spell in the World from one batched overlap pass at a fixed tick rate */
+/* Replaces overlap events on each channel's collision capsule, a character inside several beams is still found once per beam */
+UCLASS()
+class RPGFIX_API UChannelSpellSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	// Starts damaging every character Beam overlaps with DamagePerSecond of DamageType, from DamageDelay seconds after now until EndChannel()
+	// Beam is read every frame so the channel follows the caster
+	void BeginChannel(AChannelSpellBase* Spell, UCapsuleComponent* Beam, float DamagePerSecond, TSubclassOf<UDamageType> DamageType, float DamageDelay);
+
+	// Stops Spell's channel, damage ticks up to now are still applied by the next Tick()
+	void EndChannel(AChannelSpellBase* Spell);
+
+	UFUNCTION(BlueprintPure, Category = "Spells")
+	int32 GetActiveChannelCount() const { return Batch.Num(); }
+
+	// Damage ticks per second, independent of the frame rate
+	UPROPERTY(EditAnywhere, Category = "Spells")
+	float TickRate = 10.f;
+
+	// Size of a grid cell, roughly the diameter of the largest character
+	UPROPERTY(EditAnywhere, Category = "Spells")
+	float CellSize = 200.f;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return !IsTemplate() && Batch.Num() > 0; }
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UChannelSpellSubsystem, STATGROUP_Tickables); }
+
+private:
+
+	struct FChannelContext
+	{
+		TWeakObjectPtr<AChannelSpellBase> Spell;
+		TWeakObjectPtr<UCapsuleComponent> Beam;
+		TSubclassOf<UDamageType> DamageType;
+		int32 ChannelID;
+	};
+
+	// Segment along the capsule's axis between the centres of its end caps
+	static void GetBeamSegment(const UCapsuleComponent* Beam, FVector& OutStart, FVector& OutEnd);
+
+	// Rebuilds the spatial hash from the capsule of every character in the World
+	void BuildTargets();
+
+	FChannelSpellBatch Batch;
+
+	FSpellSpatialHash SpatialHash;
+
+	TSparseArray<FChannelContext> Contexts; // indexed by FChannelSpellDamage::ContextIndex
+
+	TMap<TWeakObjectPtr<AChannelSpellBase>, int32> ContextsBySpell;
+
+	TMap<int32, TWeakObjectPtr<ACharacter>> CharactersByTargetID; // rebuilt every frame with the spatial hash
+
+	TArray<FSpellTargetBounds> TargetBounds; // reused every frame
+
+	TArray<FChannelSpellDamage> PendingDamage; // reused every frame
+
+	TArray<int32> EndedContexts; // reused every frame
+};
@@ -0,0 +1,237 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunCharacterStatCacheBenchmark(const TArray<FString>& Args);
+
+// Inventory.StatCacheBench <Characters> <Frames>, times per frame stat reads from the cache against summing the stats on every read
+static FAutoConsoleCommandWithArgs GCharacterStatCacheBenchCommand(
+	TEXT("Inventory.StatCacheBench"),
+	TEXT("Inventory.StatCacheBench <Characters> <Frames>: times per frame stat reads of cached character stats against summing them with FCharacterStats::operator += on every read"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunCharacterStatCacheBenchmark));
+#endif
+
+FCharacterStatCache::FCharacterStatCache()
+{
+	SourceStats.Add(FPackedCharacterStats());
+	SlotByStatsIndex.Add(INDEX_NONE);
+	NextExpireTime = 0.0;
+	NextSerial = 1;
+	Version = 0;
+	bIsDirty = false;
+}
+
+void FCharacterStatCache::SetBaseStats(const FCharacterStats& Stats)
+{
+	SourceStats[0] = FPackedCharacterStats(Stats);
+	MarkDirty();
+}
+
+// Adds the stats of an equipped item or a modifier, a modifier with an ExpireTime above 0 is removed by the first RemoveExpired() at or after it
+FStatSourceHandle FCharacterStatCache::AddSource(const FCharacterStats& Stats, double ExpireTime)
+{
+	FSourceSlot Slot;
+	Slot.StatsIndex = SourceStats.Add(FPackedCharacterStats(Stats));
+	Slot.Serial = NextSerial++;
+	Slot.ExpireTime = FMath::Max(ExpireTime, 0.0);
+	const int32 SlotIndex = Slots.Add(Slot);
+	SlotByStatsIndex.Add(SlotIndex);
+	if (Slot.ExpireTime > 0.0 && (NextExpireTime <= 0.0 || Slot.ExpireTime < NextExpireTime)) NextExpireTime = Slot.ExpireTime;
+	MarkDirty();
+	return FStatSourceHandle(SlotIndex, Slot.Serial);
+}
+
+// Replaces the stats of a source, returns false if the handle no longer matches a source
+bool FCharacterStatCache::UpdateSource(FStatSourceHandle Handle, const FCharacterStats& Stats)
+{
+	const FSourceSlot* Slot = FindSlot(Handle);
+	if (!Slot) return false;
+	SourceStats[Slot->StatsIndex] = FPackedCharacterStats(Stats);
+	MarkDirty();
+	return true;
+}
+
+// Returns false if the handle no longer matches a source
+// The last source takes the removed one's place so the sources stay contiguous
+bool FCharacterStatCache::RemoveSource(FStatSourceHandle Handle)
+{
+	const FSourceSlot* Slot = FindSlot(Handle);
+	if (!Slot) return false;
+	const int32 StatsIndex = Slot->StatsIndex;
+	const int32 LastIndex = SourceStats.Num() - 1;
+	if (StatsIndex != LastIndex)
+	{
+		Slots[SlotByStatsIndex[LastIndex]].StatsIndex = StatsIndex;
+	}
+	SourceStats.RemoveAtSwap(StatsIndex, 1, false);
+	SlotByStatsIndex.RemoveAtSwap(StatsIndex, 1, false);
+	Slots.RemoveAt(Handle.Index);
+	MarkDirty();
+	return true;
+}
+
+// Removes every modifier whose ExpireTime is at or before Now, free when nothing is due
+void FCharacterStatCache::RemoveExpired(double Now)
+{
+	if (NextExpireTime <= 0.0 || Now < NextExpireTime) return;
+	NextExpireTime = 0.0;
+	TArray<FStatSourceHandle, TInlineAllocator<8>> Expired;
+	for (TSparseArray<FSourceSlot>::TConstIterator It(Slots); It; ++It)
+	{
+		if (It->ExpireTime <= 0.0) continue;
+		if (It->ExpireTime <= Now) Expired.Add(FStatSourceHandle(It.GetIndex(), It->Serial));
+		else if (NextExpireTime <= 0.0 || It->ExpireTime < NextExpireTime) NextExpireTime = It->ExpireTime;
+	}
+	for (const FStatSourceHandle& Handle : Expired)
+	{
+		RemoveSource(Handle);
+	}
+}
+
+bool FCharacterStatCache::IsValidSource(FStatSourceHandle Handle) const
+{
+	return FindSlot(Handle) != nullptr;
+}
+
+// Base stats plus every source, summed again only if something changed since the last read
+const FCharacterStats& FCharacterStatCache::GetStats()
+{
+	if (bIsDirty)
+	{
+		CachedStats = ComputeStats();
+		bIsDirty = false;
+	}
+	return CachedStats;
+}
+
+// Sums every source without reading or updating the cache
+FCharacterStats FCharacterStatCache::ComputeStats() const
+{
+	FPackedCharacterStats Total;
+	FPackedCharacterStats::Sum(SourceStats.GetData(), SourceStats.Num(), Total);
+	return Total.ToCharacterStats();
+}
+
+void FCharacterStatCache::MarkDirty()
+{
+	bIsDirty = true;
+	Version++;
+}
+
+// Resolves a handle to its slot, nullptr if it no longer matches a source
+const FCharacterStatCache::FSourceSlot* FCharacterStatCache::FindSlot(FStatSourceHandle Handle) const
+{
+	if (Handle.Index < 0 || Handle.Index >= Slots.GetMaxIndex() || !Slots.IsAllocated(Handle.Index)) return nullptr;
+	const FSourceSlot& Slot = Slots[Handle.Index];
+	return (Slot.Serial == Handle.Serial) ? &Slot : nullptr;
+}
+
+#if !UE_BUILD_SHIPPING
+// Every character has base stats, four equipped items and a few timed modifiers, and its stats are read ReadsPerFrame times a frame
+// Each frame a few characters change an item and a few gain a modifier, the cache only sums those characters again
+// The recomputed side sums the same stats with FCharacterStats::operator += on every read, as every caller had to before the cache
+static void RunCharacterStatCacheBenchmark(const TArray<FString>& Args)
+{
+	const int32 NumCharacters = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 2000;
+	const int32 NumFrames = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 300;
+	const int32 ReadsPerFrame = 4; // damage, UI, AI and replication
+	const int32 NumEquipSlots = 4;
+	const double FrameTime = 1.0 / 60.0;
+
+	// Whole and quarter values only, so both sides add up to exactly the same stats in any order
+	FRandomStream Random(NumCharacters);
+	auto MakeStats = [&Random]()
+	{
+		FCharacterStats Stats;
+		Stats.Armor = Random.RandRange(0, 20);
+		Stats.PhysicalAttack = Random.RandRange(0, 20);
+		Stats.Fortitude = Random.RandRange(0, 20);
+		Stats.Agility = Random.RandRange(0, 20);
+		Stats.MagicAttack = Random.RandRange(0, 20);
+		Stats.DamageAmount = 0.25f * Random.RandRange(0, 40);
+		return Stats;
+	};
+
+	struct FBenchCharacter
+	{
+		FCharacterStatCache Cache;
+		TArray<FStatSourceHandle> EquipSlots;
+		FCharacterStats BaseStats;
+		TArray<FCharacterStats> Equipped;
+		TArray<TPair<double, FCharacterStats>> Modifiers; // expire time and stats
+	};
+	TArray<FBenchCharacter> Characters;
+	Characters.SetNum(NumCharacters);
+	for (FBenchCharacter& Character : Characters)
+	{
+		Character.BaseStats = MakeStats();
+		Character.Cache.SetBaseStats(Character.BaseStats);
+		for (int32 Slot = 0; Slot < NumEquipSlots; Slot++)
+		{
+			Character.Equipped.Add(MakeStats());
+			Character.EquipSlots.Add(Character.Cache.AddSource(Character.Equipped[Slot]));
+		}
+	}
+
+	double CachedSeconds = 0.0;
+	double RecomputedSeconds = 0.0;
+	int32 Checksum = 0; // keeps the reads from being optimised away
+	int32 NumMismatches = 0;
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		const double Now = Frame * FrameTime;
+
+		// Equip, unequip and buff events for about 1% of the characters
+		for (int32 i = 0; i < FMath::Max(NumCharacters / 100, 1); i++)
+		{
+			FBenchCharacter& Character = Characters[Random.RandHelper(NumCharacters)];
+			if (Random.RandHelper(2) == 0)
+			{
+				const int32 Slot = Random.RandHelper(NumEquipSlots);
+				Character.Equipped[Slot] = MakeStats();
+				Character.Cache.RemoveSource(Character.EquipSlots[Slot]);
+				Character.EquipSlots[Slot] = Character.Cache.AddSource(Character.Equipped[Slot]);
+			}
+			else
+			{
+				const double ExpireTime = Now + Random.FRandRange(0.5f, 3.f);
+				Character.Modifiers.Add(TPair<double, FCharacterStats>(ExpireTime, MakeStats()));
+				Character.Cache.AddSource(Character.Modifiers.Last().Value, ExpireTime);
+			}
+		}
+
+		double StartTime = FPlatformTime::Seconds();
+		for (FBenchCharacter& Character : Characters)
+		{
+			Character.Cache.RemoveExpired(Now);
+			for (int32 Read = 0; Read < ReadsPerFrame; Read++)
+			{
+				Checksum += Character.Cache.GetStats().Armor;
+			}
+		}
+		CachedSeconds += FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (FBenchCharacter& Character : Characters)
+		{
+			Character.Modifiers.RemoveAll([Now](const TPair<double, FCharacterStats>& Modifier) { return Modifier.Key <= Now; });
+			for (int32 Read = 0; Read < ReadsPerFrame; Read++)
+			{
+				FCharacterStats Total = Character.BaseStats;
+				for (const FCharacterStats& Stats : Character.Equipped) Stats += Total;
+				for (const TPair<double, FCharacterStats>& Modifier : Character.Modifiers) Modifier.Value += Total;
+				Checksum -= Total.Armor;
+				if (Read == 0 && !(Total == Character.Cache.GetStats())) NumMismatches++;
+			}
+		}
+		RecomputedSeconds += FPlatformTime::Seconds() - StartTime;
+	}
+
+	const int32 NumReads = NumCharacters * NumFrames * ReadsPerFrame;
+	UE_LOG(LogTemp, Log, TEXT("Inventory.StatCacheBench: %d characters, %d frames, %d reads a frame each"), NumCharacters, NumFrames, ReadsPerFrame);
+	UE_LOG(LogTemp, Log, TEXT("Inventory.StatCacheBench: cached %.3f ms a frame, recomputed %.3f ms a frame, %.2fx, %.1f ns a read cached"),
+		CachedSeconds * 1000.0 / NumFrames, RecomputedSeconds * 1000.0 / NumFrames, (CachedSeconds > 0.0) ? (RecomputedSeconds / CachedSeconds) : 0.0, CachedSeconds * 1e9 / NumReads);
+	UE_LOG(LogTemp, Log, TEXT("Inventory.StatCacheBench: %s, checksum %d"), (NumMismatches == 0) ? TEXT("cached stats matched every recompute") : TEXT("CACHED STATS DID NOT MATCH"), Checksum);
+}
+#endif
@@ -0,0 +1,105 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Refers to one source of a character's stats, stays valid while other sources are added and removed */
+/* Serials are never reused, so a handle kept after its source was removed matches nothing */
+struct FStatSourceHandle
+{
+public:
+
+	FStatSourceHandle()
+	{
+		Index = INDEX_NONE;
+		Serial = 0;
+	}
+
+	FStatSourceHandle(int32 InIndex, uint32 InSerial)
+	{
+		Index = InIndex;
+		Serial = InSerial;
+	}
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+
+	bool operator == (const FStatSourceHandle& HandleB) const
+	{
+		return (Index == HandleB.Index) && (Serial == HandleB.Serial);
+	}
+
+	int32 Index;
+
+	uint32 Serial;
+};
+
+
+/* Effective stats of one character, its base stats plus every equipped item and active modifier */
+/* Every change only marks the cache dirty, the total is summed again by the first read after it and every other read returns the cached total */
+/* Sources are kept packed and contiguous so a recompute is a single FPackedCharacterStats::Sum */
+/* Only uses Core types so it can be built and driven without a World */
+class FCharacterStatCache
+{
+public:
+
+	FCharacterStatCache();
+
+	void SetBaseStats(const FCharacterStats& Stats);
+
+	// Adds the stats of an equipped item or a modifier, a modifier with an ExpireTime above 0 is removed by the first RemoveExpired() at or after it
+	FStatSourceHandle AddSource(const FCharacterStats& Stats, double ExpireTime = 0.0);
+
+	// Replaces the stats of a source, returns false if the handle no longer matches a source
+	bool UpdateSource(FStatSourceHandle Handle, const FCharacterStats& Stats);
+
+	// Returns false if the handle no longer matches a source
+	bool RemoveSource(FStatSourceHandle Handle);
+
+	// Removes every modifier whose ExpireTime is at or before Now, free when nothing is due
+	void RemoveExpired(double Now);
+
+	bool IsValidSource(FStatSourceHandle Handle) const;
+
+	// Base stats plus every source, summed again only if something changed since the last read
+	const FCharacterStats& GetStats();
+
+	// Sums every source without reading or updating the cache
+	FCharacterStats ComputeStats() const;
+
+	// Changes every time a source changes, so anything derived from the stats can tell it is out of date without comparing them
+	uint32 GetVersion() const { return Version; }
+
+	bool IsDirty() const { return bIsDirty; }
+
+	int32 NumSources() const { return SourceStats.Num() - 1; }
+
+private:
+
+	struct FSourceSlot
+	{
+		int32 StatsIndex; // in SourceStats
+		uint32 Serial;
+		double ExpireTime; // 0 for sources that never expire
+	};
+
+	void MarkDirty();
+
+	// Resolves a handle to its slot, nullptr if it no longer matches a source
+	const FSourceSlot* FindSlot(FStatSourceHandle Handle) const;
+
+	TArray<FPackedCharacterStats, TAlignedHeapAllocator<32>> SourceStats; // the base stats first, then every source in no particular order
+
+	TArray<int32> SlotByStatsIndex; // slot of every entry of SourceStats, INDEX_NONE for the base stats
+
+	TSparseArray<FSourceSlot> Slots; // indices stay stable while other sources are removed
+
+	FCharacterStats CachedStats;
+
+	double NextExpireTime; // earliest ExpireTime of any modifier, 0 when none expire
+
+	uint32 NextSerial;
+
+	uint32 Version;
+
+	bool bIsDirty;
+};
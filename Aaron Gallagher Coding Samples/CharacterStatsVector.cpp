@@ -0,0 +1,319 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+#if CHARACTER_STATS_USE_AVX2
+#include <immintrin.h>
+#elif CHARACTER_STATS_USE_SSE
+#include <emmintrin.h>
+#endif
+
+#if !UE_BUILD_SHIPPING
+static void RunCharacterStatsRollupBenchmark(const TArray<FString>& Args);
+
+// Inventory.StatRollupBench <Characters> <Items>, times summing every equipped item of every character packed against FCharacterStats::operator +=
+static FAutoConsoleCommandWithArgs GCharacterStatsRollupBenchCommand(
+	TEXT("Inventory.StatRollupBench"),
+	TEXT("Inventory.StatRollupBench <Characters> <Items>: logs ns per character rollup for FPackedCharacterStats::Sum against FCharacterStats::operator +=, on aligned and unaligned storage"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunCharacterStatsRollupBenchmark));
+#endif
+
+// Loads and stores are unaligned, TArray's default allocator only guarantees 16 byte alignment
+// On data that is 32 byte aligned anyway they cost the same as aligned ones
+namespace CharacterStatsVector
+{
+#if CHARACTER_STATS_USE_AVX2
+	// All ones in the float lane, zero everywhere else
+	FORCEINLINE __m256 FloatLaneMask()
+	{
+		return _mm256_castsi256_ps(_mm256_setr_epi32(0, 0, 0, 0, 0, -1, 0, 0));
+	}
+
+	FORCEINLINE __m256i Load(const FPackedCharacterStats& Stats)
+	{
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&Stats));
+	}
+
+	FORCEINLINE void Store(FPackedCharacterStats& Stats, __m256i Value)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&Stats), Value);
+	}
+
+	// Integer add for the int lanes and float add for the float lane
+	FORCEINLINE __m256i Add(__m256i A, __m256i B)
+	{
+		const __m256 IntSum = _mm256_castsi256_ps(_mm256_add_epi32(A, B));
+		const __m256 FloatSum = _mm256_add_ps(_mm256_castsi256_ps(A), _mm256_castsi256_ps(B));
+		return _mm256_castps_si256(_mm256_blendv_ps(IntSum, FloatSum, FloatLaneMask()));
+	}
+
+	FORCEINLINE bool Equal(__m256i A, __m256i B)
+	{
+		const __m256 IntEqual = _mm256_castsi256_ps(_mm256_cmpeq_epi32(A, B));
+		const __m256 FloatEqual = _mm256_cmp_ps(_mm256_castsi256_ps(A), _mm256_castsi256_ps(B), _CMP_EQ_OQ);
+		return _mm256_movemask_ps(_mm256_blendv_ps(IntEqual, FloatEqual, FloatLaneMask())) == 0xFF;
+	}
+#elif CHARACTER_STATS_USE_SSE
+	// The block is split in two registers, the float lane is lane 1 of the high half
+	FORCEINLINE __m128 FloatLaneMask()
+	{
+		return _mm_castsi128_ps(_mm_setr_epi32(0, -1, 0, 0));
+	}
+
+	FORCEINLINE __m128 Select(__m128 Mask, __m128 IfSet, __m128 IfClear)
+	{
+		return _mm_or_ps(_mm_and_ps(Mask, IfSet), _mm_andnot_ps(Mask, IfClear));
+	}
+
+	FORCEINLINE __m128i LoadLow(const FPackedCharacterStats& Stats)
+	{
+		return _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Stats));
+	}
+
+	FORCEINLINE __m128i LoadHigh(const FPackedCharacterStats& Stats)
+	{
+		return _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Stats) + 1);
+	}
+
+	FORCEINLINE void Store(FPackedCharacterStats& Stats, __m128i Low, __m128i High)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Stats), Low);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Stats) + 1, High);
+	}
+
+	FORCEINLINE __m128i AddHigh(__m128i A, __m128i B)
+	{
+		const __m128 IntSum = _mm_castsi128_ps(_mm_add_epi32(A, B));
+		const __m128 FloatSum = _mm_add_ps(_mm_castsi128_ps(A), _mm_castsi128_ps(B));
+		return _mm_castps_si128(Select(FloatLaneMask(), FloatSum, IntSum));
+	}
+
+	FORCEINLINE bool Equal(const FPackedCharacterStats& A, const FPackedCharacterStats& B)
+	{
+		const __m128i LowEqual = _mm_cmpeq_epi32(LoadLow(A), LoadLow(B));
+		const __m128i HighA = LoadHigh(A);
+		const __m128i HighB = LoadHigh(B);
+		const __m128 HighEqual = Select(FloatLaneMask(), _mm_cmpeq_ps(_mm_castsi128_ps(HighA), _mm_castsi128_ps(HighB)), _mm_castsi128_ps(_mm_cmpeq_epi32(HighA, HighB)));
+		return (_mm_movemask_ps(_mm_castsi128_ps(LowEqual)) & _mm_movemask_ps(HighEqual)) == 0xF;
+	}
+
+	// SSE2 has no 32 bit integer min and max, built from a compare and a select
+	FORCEINLINE __m128i ClampInt(__m128i Value, __m128i Min, __m128i Max)
+	{
+		const __m128 BelowMin = _mm_castsi128_ps(_mm_cmplt_epi32(Value, Min));
+		Value = _mm_castps_si128(Select(BelowMin, _mm_castsi128_ps(Min), _mm_castsi128_ps(Value)));
+		const __m128 AboveMax = _mm_castsi128_ps(_mm_cmpgt_epi32(Value, Max));
+		return _mm_castps_si128(Select(AboveMax, _mm_castsi128_ps(Max), _mm_castsi128_ps(Value)));
+	}
+#endif
+}
+
+FCharacterStats FPackedCharacterStats::ToCharacterStats() const
+{
+	FCharacterStats Stats;
+	Stats.Armor = Armor;
+	Stats.PhysicalAttack = PhysicalAttack;
+	Stats.Fortitude = Fortitude;
+	Stats.Agility = Agility;
+	Stats.MagicAttack = MagicAttack;
+	Stats.DamageAmount = DamageAmount;
+	return Stats;
+}
+
+// Adds the sum of Num stats to OutTotal
+void FPackedCharacterStats::Sum(const FPackedCharacterStats* Stats, int32 Num, FPackedCharacterStats& OutTotal)
+{
+#if CHARACTER_STATS_USE_AVX2
+	using namespace CharacterStatsVector;
+	// Int and float lanes are accumulated separately and only blended once at the end
+	__m256i IntTotal = Load(OutTotal);
+	__m256 FloatTotal = _mm256_castsi256_ps(IntTotal);
+	for (int32 i = 0; i < Num; i++)
+	{
+		const __m256i Value = Load(Stats[i]);
+		IntTotal = _mm256_add_epi32(IntTotal, Value);
+		FloatTotal = _mm256_add_ps(FloatTotal, _mm256_castsi256_ps(Value));
+	}
+	Store(OutTotal, _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(IntTotal), FloatTotal, FloatLaneMask())));
+#elif CHARACTER_STATS_USE_SSE
+	using namespace CharacterStatsVector;
+	__m128i LowTotal = LoadLow(OutTotal);
+	__m128i HighIntTotal = LoadHigh(OutTotal);
+	__m128 HighFloatTotal = _mm_castsi128_ps(HighIntTotal);
+	for (int32 i = 0; i < Num; i++)
+	{
+		const __m128i High = LoadHigh(Stats[i]);
+		LowTotal = _mm_add_epi32(LowTotal, LoadLow(Stats[i]));
+		HighIntTotal = _mm_add_epi32(HighIntTotal, High);
+		HighFloatTotal = _mm_add_ps(HighFloatTotal, _mm_castsi128_ps(High));
+	}
+	Store(OutTotal, LowTotal, _mm_castps_si128(Select(FloatLaneMask(), HighFloatTotal, _mm_castsi128_ps(HighIntTotal))));
+#else
+	for (int32 i = 0; i < Num; i++)
+	{
+		OutTotal.Armor += Stats[i].Armor;
+		OutTotal.PhysicalAttack += Stats[i].PhysicalAttack;
+		OutTotal.Fortitude += Stats[i].Fortitude;
+		OutTotal.Agility += Stats[i].Agility;
+		OutTotal.MagicAttack += Stats[i].MagicAttack;
+		OutTotal.DamageAmount += Stats[i].DamageAmount;
+	}
+#endif
+}
+
+// Dest[i] += Src[i] for every i below Num
+void FPackedCharacterStats::AddArrays(FPackedCharacterStats* Dest, const FPackedCharacterStats* Src, int32 Num)
+{
+	for (int32 i = 0; i < Num; i++)
+	{
+#if CHARACTER_STATS_USE_AVX2
+		CharacterStatsVector::Store(Dest[i], CharacterStatsVector::Add(CharacterStatsVector::Load(Dest[i]), CharacterStatsVector::Load(Src[i])));
+#elif CHARACTER_STATS_USE_SSE
+		using namespace CharacterStatsVector;
+		Store(Dest[i], _mm_add_epi32(LoadLow(Dest[i]), LoadLow(Src[i])), AddHigh(LoadHigh(Dest[i]), LoadHigh(Src[i])));
+#else
+		Sum(&Src[i], 1, Dest[i]);
+#endif
+	}
+}
+
+// Returns the first index whose stats are identical to Key, or INDEX_NONE, same rules as FCharacterStats::operator ==
+int32 FPackedCharacterStats::FindIndexOf(const FPackedCharacterStats* Stats, int32 Num, const FPackedCharacterStats& Key)
+{
+#if CHARACTER_STATS_USE_AVX2
+	const __m256i KeyValue = CharacterStatsVector::Load(Key);
+	for (int32 i = 0; i < Num; i++)
+	{
+		if (CharacterStatsVector::Equal(CharacterStatsVector::Load(Stats[i]), KeyValue)) return i;
+	}
+#elif CHARACTER_STATS_USE_SSE
+	for (int32 i = 0; i < Num; i++)
+	{
+		if (CharacterStatsVector::Equal(Stats[i], Key)) return i;
+	}
+#else
+	for (int32 i = 0; i < Num; i++)
+	{
+		if ((Stats[i].Armor == Key.Armor) &&
+			(Stats[i].PhysicalAttack == Key.PhysicalAttack) &&
+			(Stats[i].Fortitude == Key.Fortitude) &&
+			(Stats[i].Agility == Key.Agility) &&
+			(Stats[i].MagicAttack == Key.MagicAttack) &&
+			(Stats[i].DamageAmount == Key.DamageAmount)
+			) return i;
+	}
+#endif
+	return INDEX_NONE;
+}
+
+// Clamps every field of every element between the matching fields of Min and Max
+void FPackedCharacterStats::ClampArray(FPackedCharacterStats* Stats, int32 Num, const FPackedCharacterStats& Min, const FPackedCharacterStats& Max)
+{
+#if CHARACTER_STATS_USE_AVX2
+	using namespace CharacterStatsVector;
+	const __m256i MinValue = Load(Min);
+	const __m256i MaxValue = Load(Max);
+	const __m256 Mask = FloatLaneMask();
+	for (int32 i = 0; i < Num; i++)
+	{
+		const __m256i Value = Load(Stats[i]);
+		const __m256 IntClamped = _mm256_castsi256_ps(_mm256_min_epi32(_mm256_max_epi32(Value, MinValue), MaxValue));
+		const __m256 FloatClamped = _mm256_min_ps(_mm256_max_ps(_mm256_castsi256_ps(Value), _mm256_castsi256_ps(MinValue)), _mm256_castsi256_ps(MaxValue));
+		Store(Stats[i], _mm256_castps_si256(_mm256_blendv_ps(IntClamped, FloatClamped, Mask)));
+	}
+#elif CHARACTER_STATS_USE_SSE
+	using namespace CharacterStatsVector;
+	const __m128i MinLow = LoadLow(Min);
+	const __m128i MaxLow = LoadLow(Max);
+	const __m128i MinHigh = LoadHigh(Min);
+	const __m128i MaxHigh = LoadHigh(Max);
+	for (int32 i = 0; i < Num; i++)
+	{
+		const __m128i High = LoadHigh(Stats[i]);
+		const __m128 IntClamped = _mm_castsi128_ps(ClampInt(High, MinHigh, MaxHigh));
+		const __m128 FloatClamped = _mm_min_ps(_mm_max_ps(_mm_castsi128_ps(High), _mm_castsi128_ps(MinHigh)), _mm_castsi128_ps(MaxHigh));
+		Store(Stats[i], ClampInt(LoadLow(Stats[i]), MinLow, MaxLow), _mm_castps_si128(Select(FloatLaneMask(), FloatClamped, IntClamped)));
+	}
+#else
+	for (int32 i = 0; i < Num; i++)
+	{
+		Stats[i].Armor = FMath::Clamp(Stats[i].Armor, Min.Armor, Max.Armor);
+		Stats[i].PhysicalAttack = FMath::Clamp(Stats[i].PhysicalAttack, Min.PhysicalAttack, Max.PhysicalAttack);
+		Stats[i].Fortitude = FMath::Clamp(Stats[i].Fortitude, Min.Fortitude, Max.Fortitude);
+		Stats[i].Agility = FMath::Clamp(Stats[i].Agility, Min.Agility, Max.Agility);
+		Stats[i].MagicAttack = FMath::Clamp(Stats[i].MagicAttack, Min.MagicAttack, Max.MagicAttack);
+		Stats[i].DamageAmount = FMath::Clamp(Stats[i].DamageAmount, Min.DamageAmount, Max.DamageAmount);
+	}
+#endif
+}
+
+#if !UE_BUILD_SHIPPING
+// Every character has Items equipped items, one rollup sums all of them into the character's total
+// The unaligned run offsets the packed array by 16 bytes, the case the aligned loads used to fault on
+// Passes when every packed total matches the FCharacterStats total, whole and quarter values only so both sides add up exactly
+static void RunCharacterStatsRollupBenchmark(const TArray<FString>& Args)
+{
+	const int32 NumCharacters = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+	const int32 NumItems = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 8;
+	const int32 NumStats = NumCharacters * NumItems;
+
+	FRandomStream Random(NumStats);
+	TArray<FCharacterStats> Stats;
+	Stats.SetNum(NumStats);
+	for (FCharacterStats& Item : Stats)
+	{
+		Item.Armor = Random.RandRange(0, 20);
+		Item.PhysicalAttack = Random.RandRange(0, 20);
+		Item.Fortitude = Random.RandRange(0, 20);
+		Item.Agility = Random.RandRange(0, 20);
+		Item.MagicAttack = Random.RandRange(0, 20);
+		Item.DamageAmount = 0.25f * Random.RandRange(0, 40);
+	}
+	TArray<FPackedCharacterStats, TAlignedHeapAllocator<32>> Aligned;
+	Aligned.Reserve(NumStats);
+	for (const FCharacterStats& Item : Stats) Aligned.Add(FPackedCharacterStats(Item));
+
+	// Same stats 16 bytes past a 32 byte boundary
+	TArray<uint8, TAlignedHeapAllocator<32>> UnalignedBytes;
+	UnalignedBytes.SetNumZeroed(NumStats * sizeof(FPackedCharacterStats) + 16);
+	FPackedCharacterStats* Unaligned = reinterpret_cast<FPackedCharacterStats*>(UnalignedBytes.GetData() + 16);
+	FMemory::Memcpy(Unaligned, Aligned.GetData(), NumStats * sizeof(FPackedCharacterStats));
+
+	TArray<FCharacterStats> ScalarTotals;
+	ScalarTotals.SetNum(NumCharacters);
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 Character = 0; Character < NumCharacters; Character++)
+	{
+		FCharacterStats Total;
+		for (int32 Item = 0; Item < NumItems; Item++) Stats[Character * NumItems + Item] += Total;
+		ScalarTotals[Character] = Total;
+	}
+	const double ScalarSeconds = FPlatformTime::Seconds() - StartTime;
+
+	auto RunPacked = [NumCharacters, NumItems, &ScalarTotals](const FPackedCharacterStats* Items, double& OutSeconds)
+	{
+		int32 NumMismatches = 0;
+		TArray<FPackedCharacterStats, TAlignedHeapAllocator<32>> Totals;
+		Totals.SetNum(NumCharacters);
+		const double Start = FPlatformTime::Seconds();
+		for (int32 Character = 0; Character < NumCharacters; Character++)
+		{
+			FPackedCharacterStats::Sum(Items + Character * NumItems, NumItems, Totals[Character]);
+		}
+		OutSeconds = FPlatformTime::Seconds() - Start;
+		for (int32 Character = 0; Character < NumCharacters; Character++)
+		{
+			if (!(Totals[Character].ToCharacterStats() == ScalarTotals[Character])) NumMismatches++;
+		}
+		return NumMismatches;
+	};
+	double AlignedSeconds = 0.0;
+	double UnalignedSeconds = 0.0;
+	const int32 NumMismatches = RunPacked(Aligned.GetData(), AlignedSeconds) + RunPacked(Unaligned, UnalignedSeconds);
+
+	UE_LOG(LogTemp, Log, TEXT("Inventory.StatRollupBench: %d characters, %d items each, %s kernel"), NumCharacters, NumItems,
+		CHARACTER_STATS_USE_AVX2 ? TEXT("AVX2") : (CHARACTER_STATS_USE_SSE ? TEXT("SSE2") : TEXT("scalar")));
+	UE_LOG(LogTemp, Log, TEXT("Inventory.StatRollupBench: operator += %.1f ns a rollup, packed %.1f ns a rollup aligned, %.1f ns unaligned, %.2fx, %s"),
+		ScalarSeconds * 1e9 / NumCharacters, AlignedSeconds * 1e9 / NumCharacters, UnalignedSeconds * 1e9 / NumCharacters,
+		(AlignedSeconds > 0.0) ? (ScalarSeconds / AlignedSeconds) : 0.0, (NumMismatches == 0) ? TEXT("passed") : TEXT("FAILED"));
+}
+#endif
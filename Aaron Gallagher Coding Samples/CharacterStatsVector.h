@@ -0,0 +1,82 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+// Selects the widest kernel the target was compiled for, the scalar kernel is always available as a fallback
+// The choice is made at compile time only, the AVX2 kernel is used when the module is built with AVX2 enabled (/arch:AVX2 or -mavx2)
+// Such a build already requires an AVX2 CPU for the compiler's own code, default x64 builds use the SSE2 kernel, which every x64 CPU has
+#if defined(__AVX2__)
+#define CHARACTER_STATS_USE_AVX2 1
+#define CHARACTER_STATS_USE_SSE 0
+#elif PLATFORM_ENABLE_VECTORINTRINSICS && !PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#define CHARACTER_STATS_USE_AVX2 0
+#define CHARACTER_STATS_USE_SSE 1
+#else
+#define CHARACTER_STATS_USE_AVX2 0
+#define CHARACTER_STATS_USE_SSE 0
+#endif
+
+
+/* FCharacterStats packed into one 32 byte block so a whole set of stats is added, compared or clamped with one or two vector instructions */
+/* Used for stat rollups across every equipped item of many characters, convert back to FCharacterStats for Blueprint */
+/* The kernels use unaligned loads and stores, so the raw pointer functions accept stats from any allocator, 32 byte aligned storage only makes them faster */
+struct alignas(32) FPackedCharacterStats
+{
+public:
+
+	FPackedCharacterStats()
+	{
+		Armor = 0;
+		PhysicalAttack = 0;
+		Fortitude = 0;
+		Agility = 0;
+		MagicAttack = 0;
+		DamageAmount = 0.f;
+		Padding[0] = 0;
+		Padding[1] = 0;
+	}
+
+	explicit FPackedCharacterStats(const FCharacterStats& Stats)
+	{
+		Armor = Stats.Armor;
+		PhysicalAttack = Stats.PhysicalAttack;
+		Fortitude = Stats.Fortitude;
+		Agility = Stats.Agility;
+		MagicAttack = Stats.MagicAttack;
+		DamageAmount = Stats.DamageAmount;
+		Padding[0] = 0;
+		Padding[1] = 0;
+	}
+
+	FCharacterStats ToCharacterStats() const;
+
+	// Adds the sum of Num stats to OutTotal
+	static void Sum(const FPackedCharacterStats* Stats, int32 Num, FPackedCharacterStats& OutTotal);
+
+	// Dest[i] += Src[i] for every i below Num
+	static void AddArrays(FPackedCharacterStats* Dest, const FPackedCharacterStats* Src, int32 Num);
+
+	// Returns the first index whose stats are identical to Key, or INDEX_NONE, same rules as FCharacterStats::operator ==
+	static int32 FindIndexOf(const FPackedCharacterStats* Stats, int32 Num, const FPackedCharacterStats& Key);
+
+	// Clamps every field of every element between the matching fields of Min and Max
+	static void ClampArray(FPackedCharacterStats* Stats, int32 Num, const FPackedCharacterStats& Min, const FPackedCharacterStats& Max);
+
+	bool operator == (const FPackedCharacterStats& StatB) const
+	{
+		return FindIndexOf(this, 1, StatB) == 0;
+	}
+
+	// Layout is fixed, the kernels treat lane 5 as the only float lane
+	int32 Armor;
+	int32 PhysicalAttack;
+	int32 Fortitude;
+	int32 Agility;
+	int32 MagicAttack;
+	float DamageAmount;
+	int32 Padding[2]; // always 0, pads the block to 8 lanes
+
+	static constexpr int32 FloatLane = 5;
+};
+
+static_assert(sizeof(FPackedCharacterStats) == 32, "FPackedCharacterStats must fill exactly one AVX register");
@@ -0,0 +1,158 @@
+/* Aaron Gallagher's Spell System Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunDamageOverTimeSchedulerBenchmark(const TArray<FString>& Args);
+
+// Spells.DotSchedulerBench <Effects> <Seconds>, runs the same damage over time effects through the scheduler and through one FTimerManager timer each
+static FAutoConsoleCommandWithArgs GDamageOverTimeSchedulerBenchCommand(
+	TEXT("Spells.DotSchedulerBench"),
+	TEXT("Spells.DotSchedulerBench <Effects> <Seconds>: times FDamageOverTimeScheduler against one looping FTimerManager timer per effect at 60 frames a second, and checks both deal the same ticks"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunDamageOverTimeSchedulerBenchmark));
+#endif
+
+// Adds an effect that deals Amount every Interval seconds, starting at StartTime + Interval, for Duration seconds
+// Returns an ID that can be passed to Cancel()
+int32 FDamageOverTimeScheduler::Schedule(int32 ContextIndex, float Amount, float Interval, float Duration, double StartTime)
+{
+	FScheduledEffect Effect;
+	Effect.Interval = FMath::Max(Interval, KINDA_SMALL_NUMBER);
+	Effect.NextFireTime = StartTime + Effect.Interval;
+	Effect.EndTime = StartTime + FMath::Max(Duration, Effect.Interval); // every effect ticks at least once
+	Effect.Amount = Amount;
+	Effect.EffectID = NextEffectID++;
+	Effect.ContextIndex = ContextIndex;
+	Effects.HeapPush(Effect, FFiresBefore());
+	ActiveEffectIDs.Add(Effect.EffectID);
+	return Effect.EffectID;
+}
+
+// Stops an effect, no further events are produced for it
+// Does nothing if the effect already produced its final tick
+void FDamageOverTimeScheduler::Cancel(int32 EffectID)
+{
+	if (ActiveEffectIDs.Remove(EffectID) > 0) Cancelled.Add(EffectID);
+}
+
+// Appends every tick due at or before Now to OutEvents in fire time order, ties are broken by EffectID so replays are deterministic
+void FDamageOverTimeScheduler::Advance(double Now, TArray<FDamageOverTimeEvent>& OutEvents)
+{
+	while (Effects.Num() > 0 && Effects.HeapTop().NextFireTime <= Now)
+	{
+		FScheduledEffect Effect;
+		Effects.HeapPop(Effect, FFiresBefore(), false);
+		if (Cancelled.Remove(Effect.EffectID) > 0) continue;
+
+		FDamageOverTimeEvent& Event = OutEvents.AddDefaulted_GetRef();
+		Event.EffectID = Effect.EffectID;
+		Event.ContextIndex = Effect.ContextIndex;
+		Event.Amount = Effect.Amount;
+		Event.FireTime = Effect.NextFireTime;
+
+		// Small tolerance so accumulated intervals do not drop the last tick
+		Effect.NextFireTime += Effect.Interval;
+		Event.bIsFinalTick = Effect.NextFireTime > Effect.EndTime + KINDA_SMALL_NUMBER;
+		if (!Event.bIsFinalTick)
+		{
+			Effects.HeapPush(Effect, FFiresBefore());
+		}
+		else ActiveEffectIDs.Remove(Effect.EffectID);
+	}
+}
+
+void FDamageOverTimeScheduler::Reset()
+{
+	Effects.Reset();
+	Cancelled.Reset();
+	ActiveEffectIDs.Reset();
+}
+
+#if !UE_BUILD_SHIPPING
+// Effects all start at once with intervals of 0.25 to 2 seconds and durations of 1 to 10 seconds, as after a large area spell
+// The timer side gives every effect its own looping timer on a private FTimerManager, the way each Dot Particle used to
+// FTimerManager only ticks once per GFrameCounter, so the counter is stepped for each simulated frame and restored at the end
+static void RunDamageOverTimeSchedulerBenchmark(const TArray<FString>& Args)
+{
+	check(IsInGameThread());
+	const int32 NumEffects = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+	const float NumSeconds = Args.IsValidIndex(1) ? FMath::Max(FCString::Atof(*Args[1]), 1.f) : 12.f;
+	const float FrameTime = 1.f / 60.f;
+	const int32 NumFrames = FMath::CeilToInt(NumSeconds / FrameTime);
+
+	struct FBenchEffect
+	{
+		float Interval;
+		float Duration;
+		int32 NumTicks; // ticks the effect deals, at least one
+	};
+	FRandomStream Random(NumEffects);
+	TArray<FBenchEffect> BenchEffects;
+	for (int32 i = 0; i < NumEffects; i++)
+	{
+		FBenchEffect& Effect = BenchEffects.AddDefaulted_GetRef();
+		Effect.Interval = 0.25f * Random.RandRange(1, 8);
+		Effect.Duration = (float)Random.RandRange(1, 10);
+		Effect.NumTicks = FMath::Max(FMath::FloorToInt((Effect.Duration + KINDA_SMALL_NUMBER) / Effect.Interval), 1);
+	}
+
+	FDamageOverTimeScheduler Scheduler;
+	TArray<FDamageOverTimeEvent> Events;
+	int32 SchedulerTicks = 0;
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumEffects; i++)
+	{
+		Scheduler.Schedule(i, 1.f, BenchEffects[i].Interval, BenchEffects[i].Duration, 0.0);
+	}
+	for (int32 Frame = 1; Frame <= NumFrames; Frame++)
+	{
+		Events.Reset();
+		Scheduler.Advance(Frame * (double)FrameTime, Events);
+		SchedulerTicks += Events.Num();
+	}
+	const double SchedulerSeconds = FPlatformTime::Seconds() - StartTime;
+
+	// Cancelling an effect after its final tick must not count against the effects still running
+	const int32 ActiveBefore = Scheduler.Num();
+	const int32 LateEffectID = Scheduler.Schedule(0, 1.f, 0.5f, 0.5f, 0.0);
+	Events.Reset();
+	Scheduler.Advance(1.0, Events);
+	Scheduler.Cancel(LateEffectID);
+	const bool bIsLateCancelIgnored = (Scheduler.Num() == ActiveBefore);
+
+	TUniquePtr<FTimerManager> TimerManager = MakeUnique<FTimerManager>();
+	TArray<FTimerHandle> TimerHandles;
+	TimerHandles.SetNum(NumEffects);
+	TArray<int32> TicksLeft;
+	int32 TimerTicks = 0;
+	const uint64 SavedFrameCounter = GFrameCounter;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumEffects; i++)
+	{
+		TicksLeft.Add(BenchEffects[i].NumTicks);
+		FTimerManager* Timers = TimerManager.Get();
+		FTimerDelegate OnTick = FTimerDelegate::CreateLambda([i, Timers, &TimerHandles, &TicksLeft, &TimerTicks]()
+		{
+			TimerTicks++;
+			if (--TicksLeft[i] <= 0) Timers->ClearTimer(TimerHandles[i]);
+		});
+		TimerManager->SetTimer(TimerHandles[i], OnTick, BenchEffects[i].Interval, true);
+	}
+	for (int32 Frame = 1; Frame <= NumFrames; Frame++)
+	{
+		GFrameCounter++;
+		TimerManager->Tick(FrameTime);
+	}
+	const double TimerSeconds = FPlatformTime::Seconds() - StartTime;
+	GFrameCounter = SavedFrameCounter;
+
+	int32 ExpectedTicks = 0;
+	for (const FBenchEffect& Effect : BenchEffects) ExpectedTicks += Effect.NumTicks;
+	const bool bPassed = (SchedulerTicks == ExpectedTicks) && (TimerTicks == ExpectedTicks) && bIsLateCancelIgnored;
+	UE_LOG(LogTemp, Log, TEXT("Spells.DotSchedulerBench: %d effects, %d frames, %d damage ticks expected, scheduler %d, timers %d"),
+		NumEffects, NumFrames, ExpectedTicks, SchedulerTicks, TimerTicks);
+	UE_LOG(LogTemp, Log, TEXT("Spells.DotSchedulerBench: scheduler %.3f ms a frame, one timer per effect %.3f ms a frame, %.2fx, late cancel %s, %s"),
+		SchedulerSeconds * 1000.0 / NumFrames, TimerSeconds * 1000.0 / NumFrames, (SchedulerSeconds > 0.0) ? (TimerSeconds / SchedulerSeconds) : 0.0,
+		bIsLateCancelIgnored ? TEXT("ignored") : TEXT("COUNTED"), bPassed ? TEXT("passed") : TEXT("FAILED"));
+}
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+/* Aaron Gallagher's Spell System Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* One damage tick produced by FDamageOverTimeScheduler::Advance() */
+struct FDamageOverTimeEvent
+{
+	int32 EffectID;
+
+	int32 ContextIndex; // caller data passed to Schedule(), used to find the target and instigator
+
+	float Amount;
+
+	double FireTime; // time the tick was due, may be earlier than the Advance() time when a frame is long
+
+	bool bIsFinalTick; // the effect has ended and its EffectID is no longer valid after this event
+};
+
+
+/* All active damage over time effects in one contiguous min-heap ordered by next fire time */
+/* Replaces one FTimerHandle per effect, a frame only touches the effects that are due */
+/* Only uses Core containers so it can be driven without a World */
+class FDamageOverTimeScheduler
+{
+public:
+
+	FDamageOverTimeScheduler()
+	{
+		NextEffectID = 1;
+	}
+
+	// Adds an effect that deals Amount every Interval seconds, starting at StartTime + Interval, for Duration seconds
+	// Returns an ID that can be passed to Cancel()
+	int32 Schedule(int32 ContextIndex, float Amount, float Interval, float Duration, double StartTime);
+
+	// Stops an effect, no further events are produced for it
+	// Does nothing if the effect already produced its final tick
+	void Cancel(int32 EffectID);
+
+	// Appends every tick due at or before Now to OutEvents in fire time order, ties are broken by EffectID so replays are deterministic
+	void Advance(double Now, TArray<FDamageOverTimeEvent>& OutEvents);
+
+	int32 Num() const { return ActiveEffectIDs.Num(); }
+
+	void Reset();
+
+private:
+
+	struct FScheduledEffect
+	{
+		double NextFireTime;
+		double EndTime;
+		float Interval;
+		float Amount;
+		int32 EffectID;
+		int32 ContextIndex;
+	};
+
+	struct FFiresBefore
+	{
+		bool operator()(const FScheduledEffect& A, const FScheduledEffect& B) const
+		{
+			return (A.NextFireTime < B.NextFireTime) || ((A.NextFireTime == B.NextFireTime) && (A.EffectID < B.EffectID));
+		}
+	};
+
+	TArray<FScheduledEffect> Effects; // min-heap on FFiresBefore
+
+	TSet<int32> Cancelled; // removed lazily when the effect reaches the top of the heap
+
+	TSet<int32> ActiveEffectIDs; // scheduled and not yet ended or cancelled, so a late Cancel() never leaves an ID in Cancelled
+
+	int32 NextEffectID;
+};
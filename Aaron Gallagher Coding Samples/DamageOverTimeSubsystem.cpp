@@ -0,0 +1,82 @@
+/* Aaron Gallagher's Spell System Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+// Deals Amount of DamageType to Target every Interval seconds for Duration seconds
+// VisualParticle, if set, is returned to the Dot Particle pool when the effect ends
+// Returns an ID that can be passed to CancelEffect()
+int32 UDamageOverTimeSubsystem::ScheduleEffect(AActor* Target, AActor* DamageCauser, TSubclassOf<UDamageType> DamageType, float Amount, float Interval, float Duration, ADotParticleBase* VisualParticle)
+{
+	if (!Target) return INDEX_NONE;
+
+	FEffectContext Context;
+	Context.Target = Target;
+	Context.DamageCauser = DamageCauser;
+	Context.DamageType = DamageType;
+	Context.VisualParticle = VisualParticle;
+	const int32 ContextIndex = Contexts.Add(Context);
+
+	const int32 EffectID = Scheduler.Schedule(ContextIndex, Amount, Interval, Duration, GetWorld()->GetTimeSeconds());
+	Contexts[ContextIndex].EffectID = EffectID;
+	ContextsByEffectID.Add(EffectID, ContextIndex);
+	return EffectID;
+}
+
+// Stops an effect early and releases its particle
+void UDamageOverTimeSubsystem::CancelEffect(int32 EffectID)
+{
+	int32 ContextIndex = INDEX_NONE;
+	if (!ContextsByEffectID.RemoveAndCopyValue(EffectID, ContextIndex)) return;
+	Scheduler.Cancel(EffectID);
+	EndEffect(ContextIndex);
+}
+
+// Advances every effect at once and applies the damage of all ticks that came due this frame
+void UDamageOverTimeSubsystem::Tick(float DeltaTime)
+{
+	UWorld* World = GetWorld();
+	if (!World) return;
+
+	PendingEvents.Reset();
+	Scheduler.Advance(World->GetTimeSeconds(), PendingEvents);
+
+	// A damage handler can cancel any effect or schedule a new one in the slot that freed, so every event checks its context still belongs to its effect
+	// The context is read into locals first, scheduling from a handler can grow Contexts
+	for (const FDamageOverTimeEvent& Event : PendingEvents)
+	{
+		if (!IsContextOf(Event)) continue; // cancelled by an earlier event's handler
+		const FEffectContext& Context = Contexts[Event.ContextIndex];
+		AActor* Target = Context.Target.Get();
+		AActor* DamageCauser = Context.DamageCauser.Get();
+		const TSubclassOf<UDamageType> DamageType = Context.DamageType;
+		if (Target)
+		{
+			UGameplayStatics::ApplyDamage(Target, Event.Amount, DamageCauser ? DamageCauser->GetInstigatorController() : nullptr, DamageCauser, DamageType);
+		}
+		if (Event.bIsFinalTick && IsContextOf(Event))
+		{
+			ContextsByEffectID.Remove(Event.EffectID);
+			EndEffect(Event.ContextIndex);
+		}
+	}
+}
+
+// True while the event's context slot still holds the effect that produced it
+bool UDamageOverTimeSubsystem::IsContextOf(const FDamageOverTimeEvent& Event) const
+{
+	return Contexts.IsValidIndex(Event.ContextIndex) && (Contexts[Event.ContextIndex].EffectID == Event.EffectID);
+}
+
+// Removes the context and returns its particle to the pool
+void UDamageOverTimeSubsystem::EndEffect(int32 ContextIndex)
+{
+	if (!Contexts.IsValidIndex(ContextIndex)) return;
+	if (ADotParticleBase* VisualParticle = Contexts[ContextIndex].VisualParticle.Get())
+	{
+		if (UDotParticlePoolSubsystem* DotParticlePool = GetWorld()->GetSubsystem<UDotParticlePoolSubsystem>())
+		{
+			DotParticlePool->Release(VisualParticle);
+		}
+	}
+	Contexts.RemoveAt(ContextIndex);
+}
@@ -0,0 +1,55 @@
+#pragma once
+/* Aaron Gallagher's Spell System Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Applies the damage of every active damage over time effect in the World from one batched pass per frame */
+/* Effects are stored in FDamageOverTimeScheduler instead of each Dot Particle owning its own timer */
+UCLASS()
+class RPGFIX_API UDamageOverTimeSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	// Deals Amount of DamageType to Target every Interval seconds for Duration seconds
+	// VisualParticle, if set, is returned to the Dot Particle pool when the effect ends
+	// Returns an ID that can be passed to CancelEffect()
+	int32 ScheduleEffect(AActor* Target, AActor* DamageCauser, TSubclassOf<UDamageType> DamageType, float Amount, float Interval, float Duration, ADotParticleBase* VisualParticle = nullptr);
+
+	// Stops an effect early and releases its particle
+	void CancelEffect(int32 EffectID);
+
+	UFUNCTION(BlueprintPure, Category = "Spells")
+	int32 GetActiveEffectCount() const { return Scheduler.Num(); }
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return !IsTemplate() && Scheduler.Num() > 0; }
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UDamageOverTimeSubsystem, STATGROUP_Tickables); }
+
+private:
+
+	struct FEffectContext
+	{
+		TWeakObjectPtr<AActor> Target;
+		TWeakObjectPtr<AActor> DamageCauser;
+		TSubclassOf<UDamageType> DamageType;
+		TWeakObjectPtr<ADotParticleBase> VisualParticle;
+		int32 EffectID;
+	};
+
+	// Removes the context and returns its particle to the pool
+	void EndEffect(int32 ContextIndex);
+
+	// True while the event's context slot still holds the effect that produced it
+	bool IsContextOf(const FDamageOverTimeEvent& Event) const;
+
+	FDamageOverTimeScheduler Scheduler;
+
+	TSparseArray<FEffectContext> Contexts; // indexed by FDamageOverTimeEvent::ContextIndex
+
+	TMap<int32, int32> ContextsByEffectID;
+
+	TArray<FDamageOverTimeEvent> PendingEvents; // reused every frame
+};
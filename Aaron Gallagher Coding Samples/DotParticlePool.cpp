@@ -0,0 +1,202 @@
+/* Aaron Gallagher's Spell System Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunDotParticlePoolStress(const TArray<FString>& Args, UWorld* World);
+
+// Spells.DotPoolStress <Hits> <Concurrent>, hits the first player with Dot Particles spawned and destroyed per hit and then with pooled ones, and logs the latency and actors spawned of each
+static FAutoConsoleCommandWithWorldAndArgs GDotParticlePoolStressCommand(
+	TEXT("Spells.DotPoolStress"),
+	TEXT("Spells.DotPoolStress <Hits> <Concurrent>: logs the latency per hit and the actors spawned with SpawnActor and Destroy for every hit against the Dot Particle pool"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunDotParticlePoolStress));
+#endif
+
+// Spawns Count idle instances of DotParticleClass up front, usually from the spell's BeginPlay
+void UDotParticlePoolSubsystem::Prewarm(TSubclassOf<ADotParticleBase> DotParticleClass, int32 Count)
+{
+	if (!DotParticleClass) return;
+	TArray<ADotParticleBase*>& Idle = IdleParticles.FindOrAdd(DotParticleClass).Particles;
+	Idle.Reserve(Idle.Num() + Count);
+	for (int32 i = 0; i < Count; i++)
+	{
+		if (ADotParticleBase* DotParticle = SpawnPooledParticle(DotParticleClass))
+		{
+			Deactivate(DotParticle);
+			Idle.Add(DotParticle);
+		}
+	}
+}
+
+// Returns an idle instance attached to Hit, reinitialized with the damage values, or spawns one if the pool is empty
+// The instance ends its effect and returns to the pool after LifeTime seconds
+ADotParticleBase* UDotParticlePoolSubsystem::Acquire(TSubclassOf<ADotParticleBase> DotParticleClass, ACharacter* Hit, float EffectAmount, TSubclassOf<UDamageType> DamageType, float LifeTime)
+{
+	if (!DotParticleClass || !Hit) return nullptr;
+
+	ADotParticleBase* DotParticle = nullptr;
+	TArray<ADotParticleBase*>& Idle = IdleParticles.FindOrAdd(DotParticleClass).Particles;
+	while (Idle.Num() > 0 && !DotParticle)
+	{
+		DotParticle = Idle.Pop(false);
+		if (DotParticle && DotParticle->IsPendingKill()) DotParticle = nullptr; // destroyed by something outside the pool, nulled once it is collected
+	}
+	if (DotParticle)
+	{
+		++Stats.Hits;
+	}
+	else
+	{
+		DotParticle = SpawnPooledParticle(DotParticleClass);
+		if (!DotParticle) return nullptr;
+		++Stats.Misses;
+	}
+
+	DotParticle->SetActorLocationAndRotation(Hit->GetActorLocation(), Hit->GetActorRotation());
+	DotParticle->SetActorHiddenInGame(false);
+	DotParticle->SetActorTickEnabled(true);
+	DotParticle->SetEffectAmount(EffectAmount);
+	DotParticle->SetDamageType(DamageType);
+	DotParticle->LifeTime = LifeTime;
+	DotParticle->SetOwner(Hit);
+	DotParticle->AttachToActor(Hit, FAttachmentTransformRules::SnapToTargetIncludingScale);
+
+	// The pool owns the instance, so the lifetime timer returns it instead of letting it be destroyed
+	// Without a LifeTime the caller is responsible for calling Release()
+	if (LifeTime > 0.f)
+	{
+		FTimerDelegate ExpireDelegate = FTimerDelegate::CreateUObject(this, &UDotParticlePoolSubsystem::OnParticleExpired, TWeakObjectPtr<ADotParticleBase>(DotParticle));
+		GetWorld()->GetTimerManager().SetTimer(DotParticle->_OTLifeTimer, ExpireDelegate, LifeTime, false);
+	}
+
+	++Stats.Active;
+	Stats.HighWaterMark = FMath::Max(Stats.HighWaterMark, Stats.Active);
+	return DotParticle;
+}
+
+// Ends the effect early and returns the instance to the pool
+void UDotParticlePoolSubsystem::Release(ADotParticleBase* DotParticle)
+{
+	if (!DotParticle || DotParticle->IsPendingKill()) return;
+	GetWorld()->GetTimerManager().ClearTimer(DotParticle->_OTLifeTimer);
+	DotParticle->EndOverTimeEffect();
+	Deactivate(DotParticle);
+	IdleParticles.FindOrAdd(DotParticle->GetClass()).Particles.Add(DotParticle);
+	Stats.Active = FMath::Max(Stats.Active - 1, 0);
+	++Stats.Released;
+}
+
+ADotParticleBase* UDotParticlePoolSubsystem::SpawnPooledParticle(TSubclassOf<ADotParticleBase> DotParticleClass)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	ADotParticleBase* DotParticle = GetWorld()->SpawnActor<ADotParticleBase>(DotParticleClass, FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+	if (!ensure(DotParticle != nullptr)) return nullptr;
+	GAMEPLAY_PROFILE_COUNT(ActorsSpawned, 1);
+	RemoveDestroyedParticles(); // only on a miss, so the pool never walks its instances on the hot path
+	PooledParticles.Add(DotParticle);
+	return DotParticle;
+}
+
+// Forgets instances destroyed by something outside the pool, garbage collection has already nulled the pointers to the ones it freed
+void UDotParticlePoolSubsystem::RemoveDestroyedParticles()
+{
+	auto IsDestroyed = [](const ADotParticleBase* DotParticle) { return !DotParticle || DotParticle->IsPendingKill(); };
+	PooledParticles.RemoveAllSwap(IsDestroyed);
+	for (TPair<UClass*, FDotParticleIdleList>& Idle : IdleParticles)
+	{
+		Idle.Value.Particles.RemoveAll(IsDestroyed);
+	}
+}
+
+// Hides, detaches and disables the instance without destroying it
+void UDotParticlePoolSubsystem::Deactivate(ADotParticleBase* DotParticle)
+{
+	DotParticle->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	DotParticle->SetOwner(nullptr);
+	DotParticle->SetActorHiddenInGame(true);
+	DotParticle->SetActorTickEnabled(false);
+}
+
+// Timer callback for the end of an instance's LifeTime
+void UDotParticlePoolSubsystem::OnParticleExpired(TWeakObjectPtr<ADotParticleBase> DotParticle)
+{
+	if (DotParticle.IsValid()) Release(DotParticle.Get());
+	else Stats.Active = FMath::Max(Stats.Active - 1, 0);
+}
+
+#if !UE_BUILD_SHIPPING
+// Concurrent effects are alive at once, every time that many have landed they all end together
+// Without the pool each hit spawns an actor and each end destroys it, with the pool each hit is an Acquire and each end a Release after one Prewarm
+// Also destroys an idle instance behind the pool's back and checks the next Acquire skips it
+static void RunDotParticlePoolStress(const TArray<FString>& Args, UWorld* World)
+{
+	ACharacter* Hit = World ? UGameplayStatics::GetPlayerCharacter(World, 0) : nullptr;
+	UDotParticlePoolSubsystem* Pool = World ? World->GetSubsystem<UDotParticlePoolSubsystem>() : nullptr;
+	if (!Hit || !Pool) return;
+
+	const int32 NumHits = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 2000;
+	const int32 NumConcurrent = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 64;
+	const TSubclassOf<ADotParticleBase> DotParticleClass = ADotParticleBase::StaticClass();
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	TArray<ADotParticleBase*> Live;
+	int32 NumSpawned = 0;
+	double SpawnSeconds = 0.0;
+	for (int32 i = 0; i < NumHits; i++)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		ADotParticleBase* DotParticle = World->SpawnActor<ADotParticleBase>(DotParticleClass, Hit->GetActorLocation(), Hit->GetActorRotation(), SpawnParams);
+		if (DotParticle)
+		{
+			DotParticle->AttachToActor(Hit, FAttachmentTransformRules::SnapToTargetIncludingScale);
+			Live.Add(DotParticle);
+			NumSpawned++;
+		}
+		if (Live.Num() >= NumConcurrent || i == NumHits - 1)
+		{
+			for (ADotParticleBase* Expired : Live) Expired->Destroy();
+			Live.Reset();
+		}
+		SpawnSeconds += FPlatformTime::Seconds() - StartTime;
+	}
+
+	const FDotParticlePoolStats StatsBefore = Pool->GetPoolStats();
+	double StartTime = FPlatformTime::Seconds();
+	Pool->Prewarm(DotParticleClass, NumConcurrent);
+	const double PrewarmSeconds = FPlatformTime::Seconds() - StartTime;
+	double PooledSeconds = 0.0;
+	for (int32 i = 0; i < NumHits; i++)
+	{
+		StartTime = FPlatformTime::Seconds();
+		if (ADotParticleBase* DotParticle = Pool->Acquire(DotParticleClass, Hit, 0.f, nullptr, 0.f))
+		{
+			Live.Add(DotParticle);
+		}
+		if (Live.Num() >= NumConcurrent || i == NumHits - 1)
+		{
+			for (ADotParticleBase* Expired : Live) Pool->Release(Expired);
+			Live.Reset();
+		}
+		PooledSeconds += FPlatformTime::Seconds() - StartTime;
+	}
+	const FDotParticlePoolStats StatsAfter = Pool->GetPoolStats();
+	const int32 NumMisses = StatsAfter.Misses - StatsBefore.Misses;
+
+	// An instance destroyed while idle must never be handed out again
+	ADotParticleBase* Destroyed = Pool->Acquire(DotParticleClass, Hit, 0.f, nullptr, 0.f);
+	Pool->Release(Destroyed);
+	if (Destroyed) Destroyed->Destroy();
+	ADotParticleBase* Reused = Pool->Acquire(DotParticleClass, Hit, 0.f, nullptr, 0.f);
+	const bool bIsDestroyedSkipped = Destroyed && Reused && (Reused != Destroyed);
+	Pool->Release(Reused);
+
+	const bool bPassed = (NumMisses == 0) && (StatsAfter.Active == StatsBefore.Active) && bIsDestroyedSkipped;
+	UE_LOG(LogTemp, Log, TEXT("Spells.DotPoolStress: %d hits, %d at once, spawn and destroy %.2f us a hit with %d actors spawned"),
+		NumHits, NumConcurrent, SpawnSeconds * 1e6 / NumHits, NumSpawned);
+	UE_LOG(LogTemp, Log, TEXT("Spells.DotPoolStress: pooled %.2f us a hit with %d actors spawned, prewarm %.2f ms, %d hits, high water mark %d, destroyed instance %s, %s"),
+		PooledSeconds * 1e6 / NumHits, NumConcurrent + NumMisses, PrewarmSeconds * 1000.0, StatsAfter.Hits - StatsBefore.Hits, StatsAfter.HighWaterMark,
+		bIsDestroyedSkipped ? TEXT("skipped") : TEXT("HANDED OUT"), bPassed ? TEXT("passed") : TEXT("FAILED"));
+}
+#endif
@@ -0,0 +1,99 @@
+#pragma once
+/* Aaron Gallagher's Spell System Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Pool usage counters, readable from Blueprint for debug displays */
+USTRUCT(BlueprintType)
+struct FDotParticlePoolStats
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	FDotParticlePoolStats()
+	{
+		Hits = 0;
+		Misses = 0;
+		Active = 0;
+		HighWaterMark = 0;
+		Released = 0;
+	}
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pool Stats")
+		int32 Hits; // Acquires served from an idle instance
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pool Stats")
+		int32 Misses; // Acquires that had to spawn a new actor
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pool Stats")
+		int32 Active; // Instances currently attached to a character
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pool Stats")
+		int32 HighWaterMark; // Most instances that were ever active at once
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pool Stats")
+		int32 Released; // Instances returned to the pool instead of being destroyed
+};
+
+
+/* Idle instances of one DotParticleClass, wrapped so the pool's map of them can be a UPROPERTY that garbage collection sees */
+USTRUCT()
+struct FDotParticleIdleList
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	UPROPERTY()
+	TArray<ADotParticleBase*> Particles;
+};
+
+
+/* Keeps expired Dot Particles hidden and detached so the next hit re-uses them instead of spawning a new actor */
+/* One pool per DotParticleClass, instances are only destroyed with the World */
+/* ADotParticleBase::EndOverTimeEffect must stop dealing damage without destroying the actor, the pool decides when an instance goes away */
+UCLASS()
+class RPGFIX_API UDotParticlePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	// Spawns Count idle instances of DotParticleClass up front, usually from the spell's BeginPlay
+	UFUNCTION(BlueprintCallable, Category = "Spells")
+	void Prewarm(TSubclassOf<ADotParticleBase> DotParticleClass, int32 Count);
+
+	// Returns an idle instance attached to Hit, reinitialized with the damage values, or spawns one if the pool is empty
+	// The instance ends its effect and returns to the pool after LifeTime seconds, or when Release() is called if LifeTime is 0
+	ADotParticleBase* Acquire(TSubclassOf<ADotParticleBase> DotParticleClass, ACharacter* Hit, float EffectAmount, TSubclassOf<UDamageType> DamageType, float LifeTime);
+
+	// Ends the effect early and returns the instance to the pool
+	void Release(ADotParticleBase* DotParticle);
+
+	UFUNCTION(BlueprintPure, Category = "Spells")
+	FDotParticlePoolStats GetPoolStats() const { return Stats; }
+
+private:
+
+	ADotParticleBase* SpawnPooledParticle(TSubclassOf<ADotParticleBase> DotParticleClass);
+
+	// Hides, detaches and disables the instance without destroying it
+	void Deactivate(ADotParticleBase* DotParticle);
+
+	// Timer callback for the end of an instance's LifeTime
+	void OnParticleExpired(TWeakObjectPtr<ADotParticleBase> DotParticle);
+
+	// Forgets instances destroyed by something outside the pool, garbage collection has already nulled the pointers to the ones it freed
+	void RemoveDestroyedParticles();
+
+	// Idle instances per class
+	UPROPERTY()
+	TMap<UClass*, FDotParticleIdleList> IdleParticles;
+
+	// Every instance the pool owns, active or idle
+	UPROPERTY()
+	TArray<ADotParticleBase*> PooledParticles;
+
+	FDotParticlePoolStats Stats;
+};
@@ -12,34 +12,65 @@ void ADamageOverTimeSpellBase::LaunchSpell()
 	SpellCollisionCapsule->RemoveFromRoot();
 	SpellBlastParticle->RemoveFromRoot();
 	SpellBlastParticle->AttachToComponent(SpellCollisionCapsule, FAttachmentTransformRules::SnapToTargetIncludingScale);
+	if (bUseAnalyticProjectile)
+	{
+		if (USpellProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<USpellProjectileSubsystem>())
+		{
+			// Detached like the simulated capsule, the projectile subsystem moves it every tick and ReturnSpellMesh reattaches it
+			SpellCollisionCapsule->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+			Projectiles->LaunchProjectile(this, SpellCollisionCapsule->GetComponentLocation(), GetLaunchVelocity(), SpellCollisionCapsule->GetScaledCapsuleRadius(), ProjectileLifeTime);
+			bHasFiredSpell = true;
+			return;
+		}
+	}
 	SpellCollisionCapsule->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
 	SpellCollisionCapsule->SetSimulatePhysics(true);
-	SpellCollisionCapsule->AddImpulse(SpellSpeed * GetOwner()->GetActorForwardVector());
+	SpellCollisionCapsule->AddImpulse(GetLaunchImpulse());
 	bHasFiredSpell = true;
 }
 
+// Impulse the physics path applies to the collision capsule
+FVector ADamageOverTimeSpellBase::GetLaunchImpulse() const
+{
+	return SpellSpeed * GetOwner()->GetActorForwardVector();
+}
+
+// Velocity the capsule leaves with when the physics path applies GetLaunchImpulse(), an impulse changes velocity by impulse / mass
+// The mass is worked out from the capsule's shape and physical material, the capsule is not simulating physics yet so it has no body mass
+FVector ADamageOverTimeSpellBase::GetLaunchVelocity() const
+{
+	return GetLaunchImpulse() / FMath::Max(SpellCollisionCapsule->CalculateMass(), KINDA_SMALL_NUMBER);
+}
+
+// Called by the projectile subsystem every tick an analytic projectile is in flight
+// Moves the collision capsule, and the spell blast particle attached to it, to where the projectile is
+void ADamageOverTimeSpellBase::OnProjectileMoved(const FVector& Location, const FVector& Velocity)
+{
+	SpellCollisionCapsule->SetWorldLocationAndRotation(Location, Velocity.IsNearlyZero() ? SpellCollisionCapsule->GetComponentQuat() : Velocity.ToOrientationQuat());
+}
+
 // Spawns an object that is attached to the enemy object detected by the collision capsule
 // Object begins dealing damage to enemy object according to Damage Aount and Damage Type variables from the Stats struct 
+// Instances come from the World's Dot Particle pool and are returned to it when DotLifeTime runs out, instead of being destroyed
+// Damage ticks are applied by the World's damage over time scheduler, the Dot Particle is only the visual
 void ADamageOverTimeSpellBase::SpawnDotParticle(ACharacter * Hit)
 {
-	FActorSpawnParameters SpawnParams;
+	GAMEPLAY_PROFILE_SCOPE(SpawnDotParticle);
 	if (!Hit || (Hit == GetOwner())) return;
 
 	if (!ensure(DotParticleClass != nullptr)) return;
-	DotParticle = GetWorld()->SpawnActor<ADotParticleBase>(DotParticleClass, Hit->GetActorLocation(), Hit->GetActorRotation(), SpawnParams);
-	if (!ensure(DotParticle != nullptr)) return;
-	DotParticle->SetEffectAmount(Stats.DamageAmount);
-	DotParticle->SetDamageType(Stats.DamageType);
-	DotParticle->GetWorld()->GetTimerManager().SetTimer(DotParticle->_OTLifeTimer, DotParticle, &ADotParticleBase::EndOverTimeEffect, DotLifeTime, false); // sets rate of damage being delt with a maximum lifetime
-	DotParticle->LifeTime = DotLifeTime; // sets maximum lifetime of object (garbage collection)
-	DotParticle->SetOwner(Hit);
-	DotParticle->AttachToActor(Hit, FAttachmentTransformRules::SnapToTargetIncludingScale);
+	UDotParticlePoolSubsystem* DotParticlePool = GetWorld()->GetSubsystem<UDotParticlePoolSubsystem>();
+	UDamageOverTimeSubsystem* DamageOverTime = GetWorld()->GetSubsystem<UDamageOverTimeSubsystem>();
+	if (!ensure(DotParticlePool != nullptr && DamageOverTime != nullptr)) return;
+	DotParticle = DotParticlePool->Acquire(DotParticleClass, Hit, 0.f, Stats.DamageType, 0.f); // released by the scheduler when the effect ends
+	DamageOverTime->ScheduleEffect(Hit, GetOwner(), Stats.DamageType, Stats.DamageAmount, DotTickInterval, DotLifeTime, DotParticle);
 }
 
 // When the collision capsule overlaps with an enemy object, the Dot Particle Object is spawned and attached to the enemy object
 // Collision Capsule is returned to the original position and reattached to the parent
 void ADamageOverTimeSpellBase::OnSpellOverlap(UPrimitiveComponent * OverlappedComp, AActor * OtherActor, UPrimitiveComponent * OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult & SweepResult)
 {
+	GAMEPLAY_PROFILE_SCOPE(OnSpellOverlap);
 	if (!bHasFiredSpell) return;
 	if (OtherActor && OtherActor != GetOwner())// ensurance that DealDamageOverTime() only effects enemy objects and not the object firing the spell
 	{
@@ -55,23 +86,45 @@ void ADamageOverTimeSpellBase::OnSpellOverlap(UPrimitiveComponent * OverlappedCo
 	CharacterHit = nullptr;
 }
 
+// Called by the projectile subsystem with the first character an analytic projectile reaches
+// Same result as OnSpellOverlap without the collision capsule, the owner is already filtered out by the subsystem
+void ADamageOverTimeSpellBase::OnProjectileHit(ACharacter* Hit, const FVector& HitLocation)
+{
+	if (!bHasFiredSpell || !Hit) return;
+	HitResult = FHitResult(Hit, nullptr, HitLocation, FVector::ZeroVector);
+	SpawnDotParticle(Hit);
+	ReturnSpellMesh();
+}
+
 /* These functions are used for a spell that, instead of casting, is channeled as long as the player is pressing the corresponding button */
 
 // Enables collision and particle effects as well as sets the timer that calls the function which deals damage on collision detected
+// In batched channel mode the capsule is only read for its position, the channel spell subsystem finds what it overlaps
 void AChannelSpellBase::BeginCasting()
 {
 	Super::BeginCasting();
-	SpellCollisionCapsule->Activate();
+	UChannelSpellSubsystem* Channels = bUseBatchedChannel ? GetWorld()->GetSubsystem<UChannelSpellSubsystem>() : nullptr;
+	if (Channels)
+	{
+		Channels->BeginChannel(this, SpellCollisionCapsule, Stats.DamageAmount, Stats.DamageType, SpellBlastParticle ? SBActivationTime : 0.f);
+	}
+	else SpellCollisionCapsule->Activate();
 	if (!SpellBlastParticle) return;
 	GetWorld()->GetTimerManager().SetTimer(_SBTimer, this, &AChannelSpellBase::ActivateSpellBlastParticle, SBActivationTime, false);
 }
 
 // Disables collision and particle effects as well as ends the timer for dealing damage on collision detected
+// Releasing before the spell blast particle activates clears its timer, so the blast never starts after the button is released
 void AChannelSpellBase::EndCasting()
 {
 	Super::EndCasting();
+	if (UChannelSpellSubsystem* Channels = GetWorld()->GetSubsystem<UChannelSpellSubsystem>())
+	{
+		Channels->EndChannel(this);
+	}
 	SpellCollisionCapsule->Deactivate();
 	bIsCasting = false;
+	GetWorld()->GetTimerManager().ClearTimer(_SBTimer);
 	if (!SpellBlastParticle) return;
 	SpellBlastParticle->Deactivate();
 	StopCastingAnimation();
@@ -83,215 +136,668 @@ void AChannelSpellBase::EndCasting()
 
 
 
+#if !UE_BUILD_SHIPPING
+static void RunInventoryTransactionBench(const TArray<FString>& Args, UWorld* World);
+
+// Inventory.TransactionBench <Items>, loots a pile into the first player's Inventory one AddItemtoInventoryByID at a time and then as one transaction
+static FAutoConsoleCommandWithWorldAndArgs GInventoryTransactionBenchCommand(
+	TEXT("Inventory.TransactionBench"),
+	TEXT("Inventory.TransactionBench <Items>: loots a pile into the first player's Inventory one AddItemtoInventoryByID at a time and then as one transaction, and logs the RPCs, drops and time of each"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunInventoryTransactionBench));
+#endif
+
+// Inventory is not a replicated property, its first state reaches the owner through ClientReceiveInventoryDelta like every change after it
+// Unacked slots are resent on a timer, so a client whose channel is not open yet still receives them
+void UInventoryComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	if (GetOwnerRole() != ROLE_Authority) return;
+	BuildInventoryCaches();
+	FlushInventoryDelta();
+}
+
 // Replicated function that finds an item from the item data table using the interactable object seen by the player and adds it to the inventory
 // Checks the interacatble object's struct for stackability
 // If an element is found and has not reached the max stack size, the stack size is increased
 // If the max stack size has been reached, a new element is created and the quantity is set to the leftover amount
 // If the Object is not stackable, a number of new elements are added equal to the Object's quantity
+// Only the quantity that fits is claimed from the pickup, players looting the same pickup in the same frame each get a different part of it
+// Stacking follows the shared core, the same rules replays and batched jobs run
+// A static Inventory goes through the same call, the core's policy fills its lowest empty slots instead of appending
 void UInventoryComponent::AddItemtoInventoryByID_Implementation(FName ID)
 {
-	if (IsInventoryStatic()) // Checks to see which type of inventory system is being used
+	GAMEPLAY_PROFILE_SCOPE(AddItemtoInventoryByID);
+	APickup* Pickup = Cast<APickup>(CurrentInteractable);
+	if (!Pickup) return;
+
+	FItemDefinitionRegistry* ItemRegistry = GetItemRegistry();
+	if (!ItemRegistry) return;
+
+	const FItemDefinitionHandle Handle = ItemRegistry->Resolve(ID);
+	if (!Handle.IsValid()) return;
+	BuildInventoryCaches();
+
+	UPickupClaimSubsystem* PickupClaims = GetWorld()->GetSubsystem<UPickupClaimSubsystem>();
+	const int32 Quantity = PickupClaims ? PickupClaims->ClaimPickup(Pickup, InventoryCore.GetRoomForItem(Handle, Pickup->Quantity)) : Pickup->Quantity;
+	if (Quantity <= 0)
 	{
-		AddItemToInventoryWhenStaticByID(ID); // Implements a different version of AddItemToInventoryByID
+		GAMEPLAY_PROFILE_COUNT(ClaimsLost, 1); // another player emptied the pickup first, or none of it fits
 		return;
 	}
-	int32 Index = 0;
-	APickup* Pickup = Cast<APickup>(CurrentInteractable);
 
+	// Modified pickups pass their stats on to every element of an unstackable item
+	const int32 Leftover = InventoryCore.AddItem(Handle, Quantity, Pickup->bIsModifiedPickup ? &Pickup->PickupCStats : nullptr);
+	if (Leftover > 0)
+	{
+		// Only without the claim subsystem, the whole pickup was taken so the rest cannot stay in it
+		DropItemAtLocation(FInventoryElement(Handle, 0), Leftover);
+	}
+	RefreshEncumbrance();
+	FlushInventoryDelta();
+}
+
+// Failing validation disconnects the client, so a client that lost a contested pickup to another player is not rejected here
+// The claim in AddItemtoInventoryByID_Implementation settles who gets what without a further round trip
+bool UInventoryComponent::AddItemtoInventoryByID_Validate(FName ID)
+{
+	BuildInventoryCaches(); // the free slots are the core's, an unbuilt core has none
+	if (GetFreeSlotCount() > 0) return true;
+	GAMEPLAY_PROFILE_COUNT(ValidateRejections, 1);
+	return false;
+}
+
+//Function that increases the quantity variable of a specific copy of the inventory instruct that is located in the inventory
+// Once the struct variable quantity reaches the maximum stack size, new items are added to the inventory with the remaining quantity
+// The split is the core's, this only drops what it could not fit
+FInventoryStackDistribution UInventoryComponent::IncreaseQuantityAtIndex(FItemDefinitionHandle Handle, int32 Quantity, int32 Index)
+{
+	GAMEPLAY_PROFILE_SCOPE(IncreaseQuantityAtIndex);
+	BuildInventoryCaches();
+	if (!GetInventory().IsValidIndex(Index) || (GetInventory()[Index].Handle != Handle)) return FInventoryStackDistribution();
+
+	const FInventoryStackDistribution Result = InventoryCore.AddToStack(Index, Quantity);
+	GAMEPLAY_PROFILE_COUNT(StacksSplit, Result.GetNumNewStacks());
+	if (Result.Leftover > 0)
+	{
+		// The overflow never entered the Inventory, so nothing is removed from the element, it is only dropped with the element's data
+		//	Prevents the incorrect element from being dropped
+		DropItemAtLocation(GetInventory()[Index], Result.Leftover);
+	}
+	return Result;
+}
+
+// Adds new stacks of an item that has no open stack in the Inventory, anything that does not fit is dropped
+FInventoryStackDistribution UInventoryComponent::AddStackableItem(FItemDefinitionHandle Handle, int32 Quantity)
+{
+	BuildInventoryCaches();
+	const FInventoryStackDistribution Result = InventoryCore.AddNewStacks(Handle, Quantity);
+	if (Result.Leftover > 0)
+	{
+		DropItemAtLocation(FInventoryElement(Handle, 0), Result.Leftover);
+	}
+	return Result;
+}
+
+// Checks every staged add and remove against the free slots and weight limit once, then applies all of them or none
+// The Inventory is only replicated and its encumbrance refreshed once, after the last operation
+// Server only, loot all, trade and craft requests validate their source and then build a transaction to call this with
+EInventoryTransactionResult UInventoryComponent::CommitTransaction(const FInventoryTransaction& Transaction)
+{
+	if (GetOwnerRole() != ROLE_Authority) return EInventoryTransactionResult::ITR_NotAuthority;
+	const EInventoryTransactionResult Result = CanCommitTransaction(Transaction);
+	if (Result != EInventoryTransactionResult::ITR_Committed) return Result; // nothing has been changed yet, so there is nothing to roll back
+
+	InventoryCore.Commit(Transaction);
+	RefreshEncumbrance();
+	FlushInventoryDelta();
+	return EInventoryTransactionResult::ITR_Committed;
+}
+
+// Runs only the checks of CommitTransaction, the Inventory is not changed
+// The core only looks Item IDs up, so any definition that is not loaded yet is resolved here on the game thread first
+EInventoryTransactionResult UInventoryComponent::CanCommitTransaction(const FInventoryTransaction& Transaction)
+{
+	FItemDefinitionRegistry* ItemRegistry = GetItemRegistry();
+	if (!ItemRegistry) return EInventoryTransactionResult::ITR_InvalidItem;
+	for (const FInventoryTransactionOp& Op : Transaction.Ops)
+	{
+		if ((Op.Op == EInventoryTransactionOp::ITO_Add) && !ItemRegistry->Resolve(Op.ItemID).IsValid()) return EInventoryTransactionResult::ITR_InvalidItem;
+	}
+	BuildInventoryCaches();
+	InventoryCore.SetWeightLimit(MaxCarryWeight);
+	return InventoryCore.CanCommit(Transaction);
+}
+
+
+// Resolves the shared item definition registry from the item catalog, or from the GameMode's item data table when no catalog is set
+// The registries are owned by the game instance's UItemRegistrySubsystem and rebuilt in place when their data table changes
+// Clients have no GameMode and use the ItemTable set on the component instead
+// Elements hold handles into the registry, so once one is found the component keeps using it
+FItemDefinitionRegistry* UInventoryComponent::GetItemRegistry()
+{
+	if (ItemRegistryCache) return ItemRegistryCache;
+	UItemRegistrySubsystem* Registries = UItemRegistrySubsystem::Get(this);
+	if (!Registries) return nullptr;
+	if (!ItemCatalogPath.IsEmpty())
+	{
+		ItemRegistryCache = Registries->GetCatalogRegistry(FPaths::ProjectContentDir() / ItemCatalogPath);
+		if (ItemRegistryCache) return ItemRegistryCache; // falls back to the data table while the catalog is missing
+	}
 	AInventoryGameMode* GameMode = (AInventoryGameMode*)GetWorld()->GetAuthGameMode();
-	if (!GameMode) return;
+	ItemRegistryCache = Registries->GetTableRegistry(GameMode ? GameMode->GetItemDB() : ItemTable);
+	return ItemRegistryCache;
+}
 
-	UDataTable* ItemTable = GameMode->GetItemDB();
-	if (!ItemTable) return;
+// Number of new elements that can be added before the Inventory is full, the empty slots of a static layout
+int32 UInventoryComponent::GetFreeSlotCount() const
+{
+	return InventoryCore.GetFreeSlotCount();
+}
 
-	FInventoryItem* ItemToAdd = ItemTable->FindRow<FInventoryItem>(ID, "");
-	if (!ItemToAdd) return;
+// Gives the shared core the registry and the component's limits the first time it is needed
+// Without a registry the core stays unbuilt, every path that changes the Inventory needs one first
+void UInventoryComponent::BuildInventoryCaches()
+{
+	if (InventoryCore.IsBuilt()) return;
+	const FItemDefinitionRegistry* ItemRegistry = GetItemRegistry();
+	if (!ItemRegistry) return;
+	InventoryCore.SetListener(this);
+	InventoryCore.Configure(ItemRegistry, InventorySize, MaxStackSize, MaxCarryWeight);
+	RebuildReplicatedSlots();
+}
 
-	ItemToAdd->Quantity = Pickup->Quantity;
+// Replaces the whole Inventory, the core does not report the elements one by one so the query index is rebuilt by the next query
+void UInventoryComponent::ReplaceInventory(const TArray<FInventoryElement>& NewInventory)
+{
+	BuildInventoryCaches();
+	if (!InventoryCore.IsBuilt()) return;
+	InventoryCore.Reset(NewInventory);
+	QueryIndex.Invalidate();
+	RebuildReplicatedSlots();
+}
 
-	if (ItemToAdd->bIsStackable)
+// Copies every element into ReplicatedSlots, the next delta only sends what differs from the client's last ack
+// Clients fill ReplicatedSlots from the deltas they receive instead
+void UInventoryComponent::RebuildReplicatedSlots()
+{
+	if (GetOwnerRole() != ROLE_Authority) return;
+	ReplicatedSlots.SetNum(GetInventory().Num());
+	for (int32 i = 0; i < GetInventory().Num(); i++)
 	{
-		if (DoesInventoryContainID(ID))
-		{
-			for (int32 i = 0; i < Inventory.Num(); i++)
-			{
-				if ((Inventory[i].ItemID == ID) && (Inventory[i].Quantity < MaxStackSize))
-				{
-					Index = i;
-					break;
-				}
-			}
-			if (Inventory[Index].ItemID == ID)
-			{
-				// Calls this function when there is already an Item that is stackable with the same ID in the Inventory
-				// Element's Quantity must be less than the Maximum Stack Size
-				IncreaseQuantityAtIndex(*ItemToAdd, Index);
-			}
-		}
-		else if (!DoesInventoryContainID(ID))
-		{
-			// Function called when there is no item with the same ID in the Inventory
-			// Similar to IncreaseQuantityAtIndex function
-			AddStackableItem(*ItemToAdd);
-		}
+		UpdateReplicatedSlot(i);
 	}
-	else if (ItemToAdd && !ItemToAdd->bIsStackable)
+}
+
+// Called by the core after a new element is added to the end of the Inventory
+void UInventoryComponent::OnInventorySlotAdded(int32 Index)
+{
+	QueryIndex.OnSlotAdded(GetInventory()[Index], ItemRegistryCache->Get(GetInventory()[Index].Handle), Index);
+	UpdateReplicatedSlot(Index);
+}
+
+// Called by the core after the Quantity or state of an element changes, or the element is replaced by a delta
+void UInventoryComponent::OnInventorySlotChanged(int32 Index)
+{
+	QueryIndex.OnSlotChanged(GetInventory()[Index], ItemRegistryCache->Get(GetInventory()[Index].Handle), Index);
+	UpdateReplicatedSlot(Index);
+}
+
+// Called by the core before an element is removed from the Inventory, every element after Index moves down by one
+// Every replicated slot after Index is resent, the client only receives the fields that differ from what it already has
+void UInventoryComponent::OnInventorySlotRemoved(int32 Index)
+{
+	QueryIndex.OnSlotRemoved(Index);
+	if (GetOwnerRole() != ROLE_Authority || !ReplicatedSlots.IsValidIndex(Index)) return;
+	ReplicatedSlots.RemoveAt(Index);
+	for (int32 i = Index; i < ReplicatedSlots.Num(); i++)
 	{
-		int32 Leftover = ItemToAdd->Quantity;
-		do
-		{
-			ItemToAdd->Quantity = 1;
-			Inventory.Add(*ItemToAdd);
-			if (Pickup->bIsModifiedPickup)
-			{
-				int AddedItemIndex = -1;
-				for (int i = 0; i < Inventory.Num(); i++)
-				{
-					if ((Inventory[i].ItemID == ItemToAdd->ItemID) && !Inventory[i].bHaveStatsBeenSet)
-						AddedItemIndex = i;
-				}
+		InventoryDeltaSender.MarkDirty(i);
+	}
+}
 
-				if (AddedItemIndex >= 0)
-				{
-					Inventory[AddedItemIndex].PickupCharacterStats = Pickup->PickupCStats;
-					Inventory[AddedItemIndex].bIsModifiedItem = true;
-					Inventory[AddedItemIndex].bHaveStatsBeenSet = true;
-				}
-			}
-			--Leftover;
-		} while ((Leftover > 0) && !IsInventoryFull());
-		if ((Leftover > 0) && IsInventoryFull())
-		{
-			// Called when there is an excess quantity of the item being added and no room is left in the Inventory
-			DropItemAtLocation(*ItemToAdd, Leftover);
-		}
+// Copies the replicated part of an element into ReplicatedSlots and marks it for the next delta
+void UInventoryComponent::UpdateReplicatedSlot(int32 Index)
+{
+	if (GetOwnerRole() != ROLE_Authority) return;
+	if (ReplicatedSlots.Num() <= Index) ReplicatedSlots.SetNum(Index + 1);
+
+	ReplicatedSlots[Index] = FInventorySlotState::FromElement(GetInventory()[Index], ItemRegistryCache->Get(GetInventory()[Index].Handle));
+	InventoryDeltaSender.MarkDirty(Index);
+}
+
+// Sends the owning client the slots that changed since its last ack, called once per Inventory change and again on a timer until the client acks
+void UInventoryComponent::FlushInventoryDelta()
+{
+	if (GetOwnerRole() != ROLE_Authority) return;
+
+	FBitWriter Writer(0, true);
+	if (InventoryDeltaSender.WriteDelta(ReplicatedSlots, Writer))
+	{
+		ClientReceiveInventoryDelta(*Writer.GetBuffer(), (int32)Writer.GetNumBits());
+	}
+	if (InventoryDeltaSender.IsWaitingForAck())
+	{
+		GetWorld()->GetTimerManager().SetTimer(InventoryResendTimer, this, &UInventoryComponent::FlushInventoryDelta, InventoryResendDelay, false);
 	}
-	bIsOverwieght = IsEncombered();
 }
 
-bool UInventoryComponent::AddItemtoInventoryByID_Validate(FName ID)
+// Applies a delta from the server and rebuilds only the Inventory elements it touched
+// Acks are batched, one ack covers every packet that arrives within InventoryAckDelay
+// Without a registry the packet is neither read nor acked, so the server sends it again
+void UInventoryComponent::ClientReceiveInventoryDelta_Implementation(const TArray<uint8>& Data, int32 NumBits)
 {
-	if (!IsInventoryFull()) return true;
-	else return false;
+	FItemDefinitionRegistry* ItemRegistry = GetItemRegistry();
+	if (!ItemRegistry || NumBits < 0 || NumBits > Data.Num() * 8) return;
+	FBitReader Reader(const_cast<uint8*>(Data.GetData()), NumBits);
+	ChangedSlots.Reset();
+	if (!InventoryDeltaReceiver.ReadDelta(Reader, ReplicatedSlots, ChangedSlots)) return;
+
+	// Removed elements arrive as a shorter Inventory plus every slot that shifted down, the core reports both to the query index
+	BuildInventoryCaches();
+	InventoryCore.SetNum(ReplicatedSlots.Num());
+	for (int32 Index : ChangedSlots)
+	{
+		FInventoryElement Element = GetInventory()[Index];
+		ReplicatedSlots[Index].ApplyTo(Element, *ItemRegistry);
+		InventoryCore.SetElement(Index, Element);
+	}
+
+	if (!GetWorld()->GetTimerManager().IsTimerActive(InventoryAckTimer))
+	{
+		GetWorld()->GetTimerManager().SetTimer(InventoryAckTimer, this, &UInventoryComponent::SendInventoryAck, InventoryAckDelay, false);
+	}
 }
 
-//Function that increases the quantity variable of a specific copy of the inventory instruct that is located in the inventory
-// Once the struct variable quantity reaches the maximum stack size, a new item is added to the inventory with the remaining quantity
-void UInventoryComponent::IncreaseQuantityAtIndex(FInventoryItem ItemToAdd, int32 Index)
+// Returns the indices of every element that matches Query, filtered and sorted through secondary indexes instead of walking the Inventory
+// The indexes are built by the first query and kept up to date by every change after that
+TArray<int32> UInventoryComponent::QueryInventory(const FInventoryQuery& Query)
 {
-	if (!ItemToAdd.bIsStackable || !Inventory[Index].bIsStackable) return;
-	int32 Leftover;
-	if (ItemToAdd.Quantity + Inventory[Index].Quantity > MaxStackSize)
+	TArray<int32> Results;
+	const FItemDefinitionRegistry* ItemRegistry = GetItemRegistry();
+	if (!ItemRegistry) return Results;
+	if (!QueryIndex.IsBuilt())
 	{
-		do
-		{
-			Leftover = ItemToAdd.Quantity + Inventory[Index].Quantity - MaxStackSize;
-			Inventory[Index].Quantity = MaxStackSize;
-			ItemToAdd.Quantity = Leftover;
-			if (ItemToAdd.Quantity <= MaxStackSize && !IsInventoryFull())
-			{
-				Inventory.Add(ItemToAdd);
-				Leftover = 0;
-			}
-			else if (!IsInventoryFull())
-			{
-				Leftover = ItemToAdd.Quantity - MaxStackSize;
-				ItemToAdd.Quantity = MaxStackSize;
-				Inventory.Add(ItemToAdd);
-				ItemToAdd.Quantity = Leftover;
-			}
-		} while ((Leftover > 0) && !IsInventoryFull());
-		if ((Leftover > 0) && IsInventoryFull())
+		QueryIndex.Rebuild(GetInventory(), *ItemRegistry);
+	}
+	QueryIndex.Run(GetInventory(), *ItemRegistry, Query, Results);
+	return Results;
+}
+
+// Core-only copy of the Inventory and its limits, for batched jobs that run off the game thread
+// Batched jobs have no pickup to leave what did not fit in, they drop it through FInventorySimulation::DropItem
+FInventorySimulation UInventoryComponent::MakeSimulation()
+{
+	FInventorySimulation Simulation(GetItemRegistry(), InventorySize, MaxStackSize, MaxCarryWeight);
+	Simulation.SetRecordDrops(true);
+	Simulation.Reset(GetInventory());
+	return Simulation;
+}
+
+// Replaces the Inventory with a simulation made by MakeSimulation, drops what it could not fit and replicates the result once
+// Game thread only
+void UInventoryComponent::ApplySimulation(FInventorySimulation& Simulation)
+{
+	check(IsInGameThread());
+	const FItemDefinitionRegistry* ItemRegistry = Simulation.GetRegistry();
+	TArray<FInventoryElement> NewInventory;
+	Simulation.TakeInventory(NewInventory);
+	ReplaceInventory(NewInventory);
+	for (const FInventorySimulationDrop& Drop : Simulation.GetDrops())
+	{
+		if (ItemRegistry && ItemRegistry->IsValidHandle(Drop.Handle))
 		{
-			DropItemAtIndex(Index, Leftover);
+			DropItemAtLocation(FInventoryElement(Drop.Handle, 0), Drop.Quantity);
 		}
 	}
-	else if (!IsInventoryFull())
+	RefreshEncumbrance();
+	FlushInventoryDelta();
+}
+
+// Definition of the element at Index with the element's quantity and state copied over it, for Blueprints and UI
+// Returns an empty item for an invalid index or before a registry is found
+FInventoryItem UInventoryComponent::GetItemView(int32 Index)
+{
+	const FItemDefinitionRegistry* ItemRegistry = GetItemRegistry();
+	if (!ItemRegistry || !GetInventory().IsValidIndex(Index)) return FInventoryItem();
+	return ItemRegistry->MakeItemView(GetInventory()[Index]);
+}
+
+// Per instance state of every element, this is what replication and the save format store
+const TArray<FInventorySlotState>& UInventoryComponent::GetSlotStates()
+{
+	BuildInventoryCaches();
+	return ReplicatedSlots;
+}
+
+// Replaces the Inventory with elements decoded from a save, display data comes from the item definition registry
+void UInventoryComponent::RestoreFromSlotStates(const TArray<FInventorySlotState>& Slots)
+{
+	FItemDefinitionRegistry* ItemRegistry = GetItemRegistry();
+	if (!ItemRegistry) return;
+
+	TArray<FInventoryElement> NewInventory;
+	NewInventory.Reserve(Slots.Num());
+	for (const FInventorySlotState& Slot : Slots)
 	{
-		Inventory[Index].Quantity = Inventory[Index].Quantity + ItemToAdd.Quantity;
+		Slot.ApplyTo(NewInventory.AddDefaulted_GetRef(), *ItemRegistry);
+		if (!NewInventory.Last().Handle.IsValid()) NewInventory.Pop(false); // the item was removed from the data table since the save
 	}
-	else DropItemAtIndex(Index, ItemToAdd.Quantity); // Finds the item using the Index and then calls DropItemAtLocation
-	//	Prevents the incorrect element from being dropped
+	ReplaceInventory(NewInventory);
+	RefreshEncumbrance();
+	FlushInventoryDelta();
+}
+
+void UInventoryComponent::SendInventoryAck()
+{
+	ServerAckInventoryDelta(InventoryDeltaReceiver.GetAckSequence());
+}
+
+void UInventoryComponent::ServerAckInventoryDelta_Implementation(int32 Sequence)
+{
+	InventoryDeltaSender.OnAck(Sequence);
+}
+
+bool UInventoryComponent::ServerAckInventoryDelta_Validate(int32 Sequence)
+{
+	if (Sequence >= 0) return true;
+	GAMEPLAY_PROFILE_COUNT(ValidateRejections, 1);
+	return false;
+}
+
+// Replaces bIsOverwieght = IsEncombered(), reads the running weight total instead of summing the Inventory
+// Broadcasts OnOverweightChanged so UI and movement code do not have to poll
+void UInventoryComponent::RefreshEncumbrance()
+{
+	BuildInventoryCaches();
+	InventoryCore.SetWeightLimit(MaxCarryWeight); // picks up MaxCarryWeight changes made without SetMaxCarryWeight
+#if WITH_INVENTORY_ENCUMBRANCE_CHECKS
+	ensureMsgf(!ItemRegistryCache || InventoryCore.GetEncumbrance().Verify(GetInventory(), *ItemRegistryCache), TEXT("Inventory encumbrance totals are out of sync with the Inventory"));
+#endif
+	if (bIsOverwieght == InventoryCore.GetEncumbrance().IsOverweight()) return;
+	bIsOverwieght = InventoryCore.GetEncumbrance().IsOverweight();
+	OnOverweightChanged.Broadcast(bIsOverwieght);
+}
+
+// Carry weight buffs and debuffs change the limit through here, so the over weight state and OnOverweightChanged follow it straight away
+void UInventoryComponent::SetMaxCarryWeight(float NewMaxCarryWeight)
+{
+	MaxCarryWeight = NewMaxCarryWeight;
+	RefreshEncumbrance();
 }
 
 // Removes an amount of one element from the Inventory and spawns an object into the world with the quantity set to the amount dropped
 // If the element had a CharacterStats struct that was modified, the object spawn recieves the modified struct variables
-void UInventoryComponent::DropItemAtLocation(FInventoryItem ItemToDrop, int32 Amount)
+// The spawn is deferred to the end of the frame and merged with other drops of the same item nearby, so overflow while looting makes one pile
+void UInventoryComponent::DropItemAtLocation(const FInventoryElement& ElementToDrop, int32 Amount)
 {
+	GAMEPLAY_PROFILE_SCOPE(DropItemAtLocation);
 	if (Amount <= 0) { Amount = 1; }
-	TSubclassOf<APickup> PickupToDrop = ItemToDrop.Pickup;
-	bool bIsModified = ItemToDrop.bIsModifiedItem;
-	FCharacterStats ModifiedStats = ItemToDrop.PickupCharacterStats;
-	FVector DropLocation = GetOwner()->GetActorLocation();
-	DropLocation.Y += FMath::RandRange(FMath::RandRange(-120.f, -80.f), FMath::RandRange(120.f, 80.f));
-	DropLocation.X += FMath::RandRange(FMath::RandRange(-120.f, -80.f), FMath::RandRange(120.f, 80.f));
-	DropLocation.Z += 10.f;
+	const FItemDefinitionRegistry* ItemRegistry = GetItemRegistry();
 	if (UWorld* const World = GetWorld())
 	{
-		APickup* Pickup = World->SpawnActor<APickup>(PickupToDrop, DropLocation, FRotator::ZeroRotator);
-		Pickup->Quantity = Amount;
-		if (bIsModified)
+		if (UItemDropSubsystem* ItemDrops = World->GetSubsystem<UItemDropSubsystem>())
 		{
-			Pickup->bIsModifiedPickup = true;
-			Pickup->PickupCStats = ModifiedStats;
+			if (ItemRegistry) ItemDrops->QueueDrop(ItemRegistry->Get(ElementToDrop.Handle), ElementToDrop, Amount, GetOwner()->GetActorLocation());
 		}
 	}
-	bIsOverwieght = IsEncombered();
+	RefreshEncumbrance();
+}
+
+// Finds the element using the Index and then calls DropItemAtLocation, the Inventory is not changed
+// Callers have already removed the amount or never added it
+void UInventoryComponent::DropItemAtIndex(int32 Index, int32 Amount)
+{
+	if (!GetInventory().IsValidIndex(Index) || Amount <= 0) return;
+	DropItemAtLocation(GetInventory()[Index], Amount);
+}
+
+// Removes an amount of one element from the Inventory and drops it next to the owner, the element is removed once it is empty
+// Goes through the core like every other removal, so the stack index, encumbrance and replicated slots stay in sync
+// Equipped elements are never dropped
+void UInventoryComponent::RemoveAndDropItemAtIndex(int32 Index, int32 Amount)
+{
+	BuildInventoryCaches();
+	if (!GetInventory().IsValidIndex(Index) || GetInventory()[Index].bIsEquipped) return;
+	const int32 Dropped = FMath::Clamp(Amount, 1, GetInventory()[Index].Quantity);
+	const FInventoryElement ElementToDrop = GetInventory()[Index]; // copied before the element can be removed, the drop keeps its modified stats
+	if (!InventoryCore.RemoveItem(Index, Dropped)) return;
+	DropItemAtLocation(ElementToDrop, Dropped);
+	FlushInventoryDelta();
 }
 
 // Checks if the WeaponComponent is already equipped and calls the unequip function if necessary
 // Spawns an object from the AWeaponBase template, WeaponToSet and sets the CharacterStats struct on the weapon with the values from a data table
-void UInventoryComponent::EquipWeapon(UWeaponComponent* WeaponToEquip, TSubclassOf<class AWeaponBase> WeaponToSet, FCharacterStats StatsToEquip)
+// InventoryIndex is the element being equipped, when given the element remembers its weapon so unequipping it needs no search
+void UInventoryComponent::EquipWeapon(UWeaponComponent* WeaponToEquip, TSubclassOf<class AWeaponBase> WeaponToSet, const FCharacterStats& StatsToEquip, int32 InventoryIndex)
 {
+	GAMEPLAY_PROFILE_SCOPE(EquipWeapon);
 	if (!WeaponToEquip || !WeaponToSet) return;
+	const int32 SlotIndex = WeaponComponents.IndexOfByKey(WeaponToEquip);
 	if (WeaponToEquip->GetWeapon() != nullptr)
 	{
+		ReleaseEquipSlot(SlotIndex);
 		UnEquipWeapon(WeaponToEquip);
 	}
 	WeaponToEquip->SetWeapon(WeaponToSet);
 	WeaponToEquip->SpawnWeapon();
-
-	APickup* Pickup = Cast<APickup>(CurrentInteractable);
-
-	AInventoryGameMode* GameMode = (AInventoryGameMode*)GetWorld()->GetAuthGameMode();
-	if (!GameMode) return;
-
-	UDataTable* ItemTable = GameMode->GetItemDB();
-	if (!ItemTable) return;
-
-	FInventoryItem* WeaponItem = ItemTable->FindRow<FInventoryItem>(WeaponToEquip->GetWeapon()->WeaponStats.WeaponID, "");
-	if (!WeaponItem) return;
+	if (!WeaponToEquip->GetWeapon()) return;
+	GAMEPLAY_PROFILE_COUNT(ActorsSpawned, 1);
 
 	WeaponToEquip->GetWeapon()->WeaponStats.WeaponCharacterStats = StatsToEquip;
+	const uint32 EquipSerial = BindEquipSlot(SlotIndex, StatsToEquip);
+	if (EquipSerial != 0)
+	{
+		InventoryCore.SetEquipSlot(InventoryIndex, SlotIndex, EquipSerial);
+	}
 }
 
-// Matches the Weapon ID to the Inventory Item's ID
-// Checks if the struct, CharacterStats, is identical between both the Inventory Item and the equipped weapon
+// Goes straight to the weapon the element was equipped in when EquipWeapon was given its index
+// Otherwise matches the Weapon ID to the Inventory Item's ID and checks if the struct, CharacterStats, is identical between both the Inventory Item and the equipped weapon
 // If a match is found, the weapon object is destroyed and the information in the Inventory Item is updated to no longer be equipped
 void UInventoryComponent::UnEquipWeaponFromIndex_Implementation(int32 WeaponIndex)
 {
-	if (!Inventory.IsValidIndex(WeaponIndex)) return;
-	int32 WeaponCompIndex = -1; // Default value keeps WeaponComponents[0] from being selected automatically
+	const FItemDefinitionRegistry* ItemRegistry = GetItemRegistry();
+	if (!ItemRegistry || !GetInventory().IsValidIndex(WeaponIndex)) return;
+	RefreshEquipSlots();
+	int32 WeaponCompIndex = FindEquipSlot(GetInventory()[WeaponIndex]);
 
-	for (UWeaponComponent* Weapon : WeaponComponents)
+	// Equipped by a caller that did not pass the element's index
+	if (WeaponCompIndex == INDEX_NONE)
 	{
-		if (Weapon->GetWeapon())
+		GAMEPLAY_PROFILE_COUNT(ItemsScanned, WeaponComponents.Num());
+		const FInventoryItem& Definition = ItemRegistry->Get(GetInventory()[WeaponIndex].Handle);
+		for (UWeaponComponent* Weapon : WeaponComponents)
 		{
-			if ((Weapon->GetWeapon()->WeaponStats.WeaponID == Inventory[WeaponIndex].ItemID) && (Weapon->GetWeapon()->WeaponStats.WeaponCharacterStats == Inventory[WeaponIndex].PickupCharacterStats))
+			if (Weapon->GetWeapon())
 			{
-				WeaponCompIndex = WeaponComponents.IndexOfByKey(Weapon);
+				if ((Weapon->GetWeapon()->WeaponStats.WeaponID == Definition.ItemID) && (Weapon->GetWeapon()->WeaponStats.WeaponCharacterStats == GetInventory()[WeaponIndex].GetStats(Definition)))
+				{
+					WeaponCompIndex = WeaponComponents.IndexOfByKey(Weapon);
+				}
 			}
 		}
 	}
 
 	if (!WeaponComponents.IsValidIndex(WeaponCompIndex)) return;
-	Inventory[WeaponIndex].bIsEquipped = false;
+	InventoryCore.SetEquipped(WeaponIndex, false);
+	ReleaseEquipSlot(WeaponCompIndex);
 	WeaponComponents[WeaponCompIndex]->GetWeapon()->Destroy();
 	WeaponComponents[WeaponCompIndex]->RemoveWeapon();
+	FlushInventoryDelta();
 }
 
 bool UInventoryComponent::UnEquipWeaponFromIndex_Validate(int32 WeaponIndex)
 {
-	if (!Inventory.IsValidIndex(WeaponIndex)) return false;
-	return true;
-}
\ No newline at end of file
+	if (GetInventory().IsValidIndex(WeaponIndex)) return true;
+	GAMEPLAY_PROFILE_COUNT(ValidateRejections, 1);
+	return false;
+}
+
+// Base stats plus every equipped weapon and active stat modifier, only summed again after one of them changed
+FCharacterStats UInventoryComponent::GetEffectiveStats()
+{
+	RefreshEquipSlots();
+	if (const UWorld* World = GetWorld()) StatCache.RemoveExpired(World->GetTimeSeconds());
+	return StatCache.GetStats();
+}
+
+// Stats of the character before equipment and modifiers
+void UInventoryComponent::SetBaseStats(const FCharacterStats& Stats)
+{
+	StatCache.SetBaseStats(Stats);
+}
+
+// Adds a buff or debuff for Duration seconds, a Duration of 0 or less lasts until RemoveStatModifier
+FStatSourceHandle UInventoryComponent::AddStatModifier(const FCharacterStats& Stats, float Duration)
+{
+	const UWorld* World = GetWorld();
+	const double ExpireTime = (World && Duration > 0.f) ? World->GetTimeSeconds() + Duration : 0.0;
+	return StatCache.AddSource(Stats, ExpireTime);
+}
+
+void UInventoryComponent::RemoveStatModifier(FStatSourceHandle Handle)
+{
+	StatCache.RemoveSource(Handle);
+}
+
+// Adds the stats of the weapon just spawned in WeaponComponents[SlotIndex] to the stat cache, returns the serial of the equip
+uint32 UInventoryComponent::BindEquipSlot(int32 SlotIndex, const FCharacterStats& Stats)
+{
+	if (!WeaponComponents.IsValidIndex(SlotIndex)) return 0;
+	if (EquipSlots.Num() < WeaponComponents.Num()) EquipSlots.SetNum(WeaponComponents.Num());
+	ReleaseEquipSlot(SlotIndex);
+	FEquipSlot& Slot = EquipSlots[SlotIndex];
+	Slot.Weapon = WeaponComponents[SlotIndex]->GetWeapon();
+	Slot.StatSource = StatCache.AddSource(Stats);
+	return Slot.StatSource.Serial;
+}
+
+// Removes a weapon component's stats from the stat cache
+void UInventoryComponent::ReleaseEquipSlot(int32 SlotIndex)
+{
+	if (!EquipSlots.IsValidIndex(SlotIndex)) return;
+	StatCache.RemoveSource(EquipSlots[SlotIndex].StatSource);
+	EquipSlots[SlotIndex] = FEquipSlot();
+}
+
+// Weapon component the element is equipped in going by the handle EquipWeapon stored on it, INDEX_NONE if it has none or it is stale
+// Only compares the serial, never the stats
+int32 UInventoryComponent::FindEquipSlot(const FInventoryElement& Element) const
+{
+	if (!EquipSlots.IsValidIndex(Element.EquipSlot)) return INDEX_NONE;
+	const FEquipSlot& Slot = EquipSlots[Element.EquipSlot];
+	return (Slot.StatSource.IsValid() && Slot.StatSource.Serial == Element.EquipSerial) ? Element.EquipSlot : INDEX_NONE;
+}
+
+// Releases the slots of weapons that were removed or replaced without going through this component, for example by UnEquipWeapon
+void UInventoryComponent::RefreshEquipSlots()
+{
+	for (int32 SlotIndex = 0; SlotIndex < EquipSlots.Num(); SlotIndex++)
+	{
+		if (!EquipSlots[SlotIndex].StatSource.IsValid()) continue;
+		const AWeaponBase* Weapon = WeaponComponents.IsValidIndex(SlotIndex) ? WeaponComponents[SlotIndex]->GetWeapon() : nullptr;
+		if (!Weapon || Weapon != EquipSlots[SlotIndex].Weapon.Get()) ReleaseEquipSlot(SlotIndex);
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+// Total quantity of every Item ID, the two loot paths fill stacks in a different order so only the totals are compared
+static TMap<FName, int32> SumQuantitiesByID(const TArray<FInventorySlotState>& Slots)
+{
+	TMap<FName, int32> Totals;
+	for (const FInventorySlotState& Slot : Slots)
+	{
+		Totals.FindOrAdd(Slot.ItemID) += Slot.Quantity;
+	}
+	return Totals;
+}
+
+// Inventory.TransactionBench <Items>, loots a pile into the first player's Inventory one AddItemtoInventoryByID at a time and then as one transaction
+// Both runs start from the player's Inventory as it was, which is put back afterwards, the RPC counts are the server calls plus the deltas sent to the owner
+static void RunInventoryTransactionBench(const TArray<FString>& Args, UWorld* World)
+{
+	APawn* Player = World ? UGameplayStatics::GetPlayerPawn(World, 0) : nullptr;
+	UInventoryComponent* InventoryComp = Player ? Player->FindComponentByClass<UInventoryComponent>() : nullptr;
+	if (!InventoryComp || (InventoryComp->GetOwnerRole() != ROLE_Authority))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Inventory.TransactionBench: needs a server with a player that has an Inventory"));
+		return;
+	}
+
+	// Copied whole through the public simulation, equipped elements keep their weapon links, and put back with ApplySimulation
+	const FInventorySimulation SavedInventory = InventoryComp->MakeSimulation();
+	const FItemDefinitionRegistry* ItemRegistry = SavedInventory.GetRegistry();
+	if (!ItemRegistry || ItemRegistry->Num() == 0) return;
+
+	// Stage the pile, stackable items come a few at a time the way loot tables roll them
+	const int32 NumItems = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 200;
+	FRandomStream Random(NumItems);
+	FInventoryTransaction Transaction;
+	TSubclassOf<APickup> PickupClass;
+	for (int32 i = 0; i < NumItems; i++)
+	{
+		const FInventoryItem& Item = ItemRegistry->Get(FItemDefinitionHandle(Random.RandHelper(ItemRegistry->Num())));
+		Transaction.StageAdd(Item.ItemID, Item.bIsStackable ? Random.RandRange(1, 5) : 1);
+		if (!PickupClass) PickupClass = Item.Pickup;
+	}
+	APickup* Pickup = PickupClass ? World->SpawnActor<APickup>(PickupClass, Player->GetActorLocation(), FRotator::ZeroRotator) : nullptr;
+	if (!Pickup) return;
+	Pickup->Quantity = 0;
+	Pickup->bIsModifiedPickup = false;
+
+	UItemDropSubsystem* ItemDrops = World->GetSubsystem<UItemDropSubsystem>();
+	UPickupClaimSubsystem* PickupClaims = World->GetSubsystem<UPickupClaimSubsystem>();
+	AInteractable* SavedInteractable = InventoryComp->GetCurrentInteractable();
+
+	// One interaction per item, each one a server RPC that claims from the pickup and sends its own delta
+	int32 DropsBefore = ItemDrops ? ItemDrops->GetDropStats().DropsQueued : 0;
+	int32 PacketsBefore = InventoryComp->GetNumInventoryDeltasSent();
+	int32 LeftInPickup = 0;
+	InventoryComp->SetCurrentInteractable(Pickup);
+	double StartTime = FPlatformTime::Seconds();
+	for (const FInventoryTransactionOp& Op : Transaction.Ops)
+	{
+		if (PickupClaims) PickupClaims->AddToPickup(Pickup, Op.Quantity);
+		else Pickup->Quantity = Op.Quantity;
+		InventoryComp->AddItemtoInventoryByID(Op.ItemID); // runs locally on the server, a rejected add leaves the pickup untouched
+		if (Pickup->Quantity <= 0) continue;
+
+		// Did not fit or was rejected, empty the pickup so the next item starts from nothing
+		LeftInPickup += Pickup->Quantity;
+		if (PickupClaims) PickupClaims->ClaimPickup(Pickup, Pickup->Quantity);
+		else Pickup->Quantity = 0;
+	}
+	const double PerItemSeconds = FPlatformTime::Seconds() - StartTime;
+	const int32 PerItemPackets = InventoryComp->GetNumInventoryDeltasSent() - PacketsBefore;
+	const int32 PerItemDrops = (ItemDrops ? ItemDrops->GetDropStats().DropsQueued : 0) - DropsBefore;
+	const TMap<FName, int32> PerItemTotals = SumQuantitiesByID(InventoryComp->GetSlotStates());
+	InventoryComp->SetCurrentInteractable(SavedInteractable);
+
+	// The same pile as one transaction from the same starting Inventory
+	FInventorySimulation Restore = SavedInventory;
+	InventoryComp->ApplySimulation(Restore);
+	DropsBefore = ItemDrops ? ItemDrops->GetDropStats().DropsQueued : 0;
+	PacketsBefore = InventoryComp->GetNumInventoryDeltasSent();
+	StartTime = FPlatformTime::Seconds();
+	const EInventoryTransactionResult Result = InventoryComp->CommitTransaction(Transaction);
+	const double TransactionSeconds = FPlatformTime::Seconds() - StartTime;
+	const int32 TransactionPackets = InventoryComp->GetNumInventoryDeltasSent() - PacketsBefore;
+	const int32 TransactionDrops = (ItemDrops ? ItemDrops->GetDropStats().DropsQueued : 0) - DropsBefore;
+	const TMap<FName, int32> TransactionTotals = SumQuantitiesByID(InventoryComp->GetSlotStates());
+
+	Restore = SavedInventory;
+	InventoryComp->ApplySimulation(Restore);
+	Pickup->Destroy();
+
+	const TCHAR* Outcome = TEXT("not compared, the pile did not fit");
+	if ((Result == EInventoryTransactionResult::ITR_Committed) && (LeftInPickup == 0))
+	{
+		Outcome = PerItemTotals.OrderIndependentCompareEqual(TransactionTotals) ? TEXT("both looted the same items") : TEXT("FAILED, the paths looted different items");
+	}
+	UE_LOG(LogTemp, Log, TEXT("Inventory.TransactionBench: %d items, per item %.3f ms, %d server RPCs, %d inventory deltas, %d drops queued, %d left in the pickup"),
+		NumItems, PerItemSeconds * 1000.0, Transaction.Ops.Num(), PerItemPackets, PerItemDrops, LeftInPickup);
+	UE_LOG(LogTemp, Log, TEXT("Inventory.TransactionBench: transaction %s in %.3f ms, 1 server call, %d inventory deltas, %d drops queued, %.2fx, %s"),
+		*UEnum::GetValueAsString(Result), TransactionSeconds * 1000.0, TransactionPackets, TransactionDrops,
+		(TransactionSeconds > 0.0) ? (PerItemSeconds / TransactionSeconds) : 0.0, Outcome);
+}
+#endif
@@ -16,12 +16,38 @@ public:
 	ADamageOverTimeSpellBase(const FObjectInitializer& ObjectInitializer);
 
 	// Detaches collision capsule and launches the capsule to make contact with enemy 
+	// In analytic projectile mode the spell is handed to the World's projectile subsystem instead of simulating physics
 	virtual void LaunchSpell() override;
 
+	// Called by the projectile subsystem with the first character an analytic projectile reaches
+	void OnProjectileHit(ACharacter* Hit, const FVector& HitLocation);
+
+	// Called by the projectile subsystem every tick an analytic projectile is in flight
+	// Moves the collision capsule, and the spell blast particle attached to it, to where the projectile is
+	void OnProjectileMoved(const FVector& Location, const FVector& Velocity);
+
+	// Impulse the physics path applies to the collision capsule
+	FVector GetLaunchImpulse() const;
+
+	// Velocity the capsule leaves with when the physics path applies GetLaunchImpulse(), used as the analytic projectile's launch velocity
+	FVector GetLaunchVelocity() const;
+
+	// Moves the spell along an analytic arc tested against a spatial hash of characters instead of a physics simulated capsule
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Spell")
+	bool bUseAnalyticProjectile = false;
+
+	// Seconds an analytic projectile travels before it is returned without a hit
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Spell")
+	float ProjectileLifeTime = 3.f;
+
 	// Spawns an object that is attached to the enemy object detected by the collision capsule
 	// Object begins dealing damage to enemy object according to Damage Aount and Damage Type variables from the Stats struct
 	void SpawnDotParticle(ACharacter* Hit);
 
+	// Seconds between damage ticks, Stats.DamageAmount is dealt on every tick until DotLifeTime runs out
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Spell")
+	float DotTickInterval = 1.f;
+
 	// When the collision capsule overlaps with an enemy object, the Dot Particle Object is spawned and attached to the enemy object
 	// Collision Capsule is returned to the original position and reattached to the parent
 	UFUNCTION()
@@ -44,10 +70,17 @@ public:
 	AChannelSpellBase(const FObjectInitializer& ObjectInitializer);
 
 	// Enables collision and particle effects as well as sets the timer that calls the function which deals damage on collision detected
+	// In batched channel mode the capsule is only read for its position, the channel spell subsystem finds what it overlaps
 	virtual void BeginCasting() override;
 	// Disables collision and particle effects as well as ends the timer for dealing damage on collision detected
+	// Releasing before the spell blast particle activates clears its timer, so the blast never starts after the button is released
 	virtual void EndCasting() override;
 
+	// Damage is dealt by the World's channel spell subsystem in one overlap pass with every other channel instead of by overlap events on the collision capsule
+	// Stats.DamageAmount is dealt every second to each character the capsule overlaps, starting when the spell blast particle activates
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Spell")
+	bool bUseBatchedChannel = false;
+
 };
 
 
@@ -66,9 +99,12 @@ struct FArmorStats;
 class AInteractable;
 class APickup;
 class UWeaponComponent;
+class AWeaponBase;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnOverweightChangedSignature, bool, bIsOverweight);
 
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
-class INVENTORY_API UInventoryComponent : public UActorComponent
+class INVENTORY_API UInventoryComponent : public UActorComponent, public IInventoryChangeListener
 {
 	GENERATED_BODY()
 
@@ -76,6 +112,9 @@ public:
 
 	UInventoryComponent();
 
+	// Inventory is not a replicated property, its first state reaches the owner through ClientReceiveInventoryDelta like every change after it
+	virtual void BeginPlay() override;
+
 	// Replicated function that finds an item from the item data table using the interactable object seen by the player and adds it to the inventory
 	// Checks the interacatble object's struct for stackability
 	// If an element is found and has not reached the max stack size, the stack size is increased
@@ -85,22 +124,214 @@ public:
 	void AddItemtoInventoryByID(FName ID);
 
 	//Function that increases the quantity variable of a specific copy of the inventory instruct that is located in the inventory
-	// Once the struct variable quantity reaches the maximum stack size, a new item is added to the inventory with the remaining quantity
-	void IncreaseQuantityAtIndex(FInventoryItem ItemToAdd, int32 Index);
+	// Once the struct variable quantity reaches the maximum stack size, new items are added to the inventory with the remaining quantity
+	// Returns the slots that were touched and the quantity that had to be dropped, so callers do not need to re-query the Inventory
+	FInventoryStackDistribution IncreaseQuantityAtIndex(FItemDefinitionHandle Handle, int32 Quantity, int32 Index);
+
+	// Adds new stacks of an item that has no open stack in the Inventory, anything that does not fit is dropped
+	FInventoryStackDistribution AddStackableItem(FItemDefinitionHandle Handle, int32 Quantity);
+
+	// Number of new elements that can be added before the Inventory is full, the empty slots of a static layout
+	int32 GetFreeSlotCount() const;
+
+	// Every element of the Inventory, changes go through the shared core
+	const TArray<FInventoryElement>& GetInventory() const { return InventoryCore.GetInventory(); }
 
 	// Removes an amount of one element from the Inventory and spawns an object into the world with the quantity set to the amount dropped
 	// If the element had a CharacterStats struct that was modified, the object spawn recieves the modified struct variables
-	void DropItemAtLocation(FInventoryItem ItemToDrop, int32 Amount);
+	void DropItemAtLocation(const FInventoryElement& ElementToDrop, int32 Amount);
+
+	// Finds the element using the Index and then calls DropItemAtLocation, the Inventory is not changed
+	void DropItemAtIndex(int32 Index, int32 Amount);
+
+	// Removes an amount of one element from the Inventory and drops it next to the owner, the element is removed once it is empty
+	// Goes through the same removal path as transactions, equipped elements are never dropped
+	void RemoveAndDropItemAtIndex(int32 Index, int32 Amount);
 
 	// Checks if the WeaponComponent is already equipped and calls the unequip function if necessary
 	// Spawns an object from the AWeaponBase template, WeaponToSet and sets the CharacterStats struct on the weapon with the values from a data table
+	// InventoryIndex is the element being equipped, when given the element remembers its weapon so unequipping it needs no search
 	UFUNCTION(BlueprintCallable)
-	void EquipWeapon(UWeaponComponent* WeaponToEquip, TSubclassOf<class AWeaponBase> WeaponToSet, FCharacterStats StatsToEquip);
+	void EquipWeapon(UWeaponComponent* WeaponToEquip, TSubclassOf<class AWeaponBase> WeaponToSet, const FCharacterStats& StatsToEquip, int32 InventoryIndex = -1);
 
-	// Matches the Weapon ID to the Inventory Item's ID
-	// Checks if the struct, CharacterStats, is identical between both the Inventory Item and the equipped weapon
+	// Goes straight to the weapon the element was equipped in when EquipWeapon was given its index
+	// Otherwise matches the Weapon ID to the Inventory Item's ID and checks if the struct, CharacterStats, is identical between both the Inventory Item and the equipped weapon
 	// If a match is found, the weapon object is destroyed and the information in the Inventory Item is updated to no longer be equipped
 	UFUNCTION(Server, Reliable, WithValidation, BlueprintCallable, Category = "Utils")
 	void UnEquipWeaponFromIndex(int32 WeaponIndex);
 
+	// Checks every staged add and remove against the free slots and weight limit once, then applies all of them or none
+	// The Inventory is only replicated and its encumbrance refreshed once, after the last operation
+	// Server only, loot all, trade and craft requests validate their source and then build a transaction to call this with
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Utils")
+	EInventoryTransactionResult CommitTransaction(const FInventoryTransaction& Transaction);
+
+	// Runs only the checks of CommitTransaction, the Inventory is not changed
+	UFUNCTION(BlueprintCallable, Category = "Utils")
+	EInventoryTransactionResult CanCommitTransaction(const FInventoryTransaction& Transaction);
+
+	// Returns the indices of every element that matches Query, filtered and sorted through secondary indexes instead of walking the Inventory
+	// The indexes are built by the first query and kept up to date by every change after that
+	UFUNCTION(BlueprintCallable, Category = "Utils")
+	TArray<int32> QueryInventory(const FInventoryQuery& Query);
+
+	// Core-only copy of the Inventory and its limits, for batched jobs that run off the game thread
+	FInventorySimulation MakeSimulation();
+
+	// Replaces the Inventory with a simulation made by MakeSimulation, drops what it could not fit and replicates the result once
+	// Game thread only
+	void ApplySimulation(FInventorySimulation& Simulation);
+
+	// Interactable the next AddItemtoInventoryByID loots from
+	AInteractable* GetCurrentInteractable() const { return CurrentInteractable; }
+
+	void SetCurrentInteractable(AInteractable* Interactable) { CurrentInteractable = Interactable; }
+
+	// Number of Inventory deltas sent to the owning client so far
+	int32 GetNumInventoryDeltasSent() const { return InventoryDeltaSender.GetNumPacketsSent(); }
+
+	// Called when the carried weight crosses the weight limit in either direction
+	UPROPERTY(BlueprintAssignable, Category = "Utils")
+	FOnOverweightChangedSignature OnOverweightChanged;
+
+	// Changes MaxCarryWeight and updates the over weight state against the new limit, broadcasting OnOverweightChanged if it flipped
+	UFUNCTION(BlueprintCallable, Category = "Utils")
+	void SetMaxCarryWeight(float NewMaxCarryWeight);
+
+	// Definition of the element at Index with the element's quantity and state copied over it, for Blueprints and UI
+	UFUNCTION(BlueprintCallable, Category = "Utils")
+	FInventoryItem GetItemView(int32 Index);
+
+	// Per instance state of every element, this is what replication and the save format store
+	const TArray<FInventorySlotState>& GetSlotStates();
+
+	// Replaces the Inventory with elements decoded from a save, display data comes from the item definition registry
+	void RestoreFromSlotStates(const TArray<FInventorySlotState>& Slots);
+
+	// Item data table used to resolve replicated Item IDs on clients, which have no GameMode
+	UPROPERTY(EditDefaultsOnly, Category = "Utils")
+	UDataTable* ItemTable;
+
+	// Item catalog written from the item data table, relative to the project's content folder
+	// When set, server and clients stream definitions from it instead of loading every row of the table up front
+	UPROPERTY(EditDefaultsOnly, Category = "Utils")
+	FString ItemCatalogPath;
+
+	// Base stats plus every equipped weapon and active stat modifier, only summed again after one of them changed
+	UFUNCTION(BlueprintCallable, Category = "Utils")
+	FCharacterStats GetEffectiveStats();
+
+	// Stats of the character before equipment and modifiers
+	UFUNCTION(BlueprintCallable, Category = "Utils")
+	void SetBaseStats(const FCharacterStats& Stats);
+
+	// Adds a buff or debuff for Duration seconds, a Duration of 0 or less lasts until RemoveStatModifier
+	FStatSourceHandle AddStatModifier(const FCharacterStats& Stats, float Duration);
+
+	void RemoveStatModifier(FStatSourceHandle Handle);
+
+	// Changes whenever the effective stats may have changed, anything derived from them can compare it instead of the stats
+	uint32 GetStatsVersion() const { return StatCache.GetVersion(); }
+
+	// Seconds the server waits for an ack before sending unacknowledged slots again
+	UPROPERTY(EditDefaultsOnly, Category = "Utils")
+	float InventoryResendDelay = 0.5f;
+
+	// Seconds the client collects deltas before acking all of them at once
+	UPROPERTY(EditDefaultsOnly, Category = "Utils")
+	float InventoryAckDelay = 0.1f;
+
+protected:
+
+	// Bit packed per slot deltas, replaces resending the whole Inventory array after each change
+	// Inventory itself is not replicated, BeginPlay sends its initial state through here
+	UFUNCTION(Client, Unreliable)
+	void ClientReceiveInventoryDelta(const TArray<uint8>& Data, int32 NumBits);
+
+	// Batched ack, covers every delta up to Sequence
+	UFUNCTION(Server, Unreliable, WithValidation)
+	void ServerAckInventoryDelta(int32 Sequence);
+
+private:
+
+	// Resolves the shared item definition registry from the item catalog, or from the GameMode's item data table when no catalog is set
+	// Elements hold handles into the registry, so once one is found the component keeps using it
+	FItemDefinitionRegistry* GetItemRegistry();
+
+	// Gives the shared core the registry and the component's limits the first time it is needed
+	void BuildInventoryCaches();
+
+	// Replaces the whole Inventory, used by simulations and saves
+	void ReplaceInventory(const TArray<FInventoryElement>& NewInventory);
+
+	// Copies every element into ReplicatedSlots, the next delta only sends what differs from the client's last ack
+	void RebuildReplicatedSlots();
+
+	// IInventoryChangeListener, keeps the query index and replicated slots in sync with the core
+	virtual void OnInventorySlotAdded(int32 Index) override;
+
+	virtual void OnInventorySlotChanged(int32 Index) override;
+
+	virtual void OnInventorySlotRemoved(int32 Index) override;
+
+	// Replaces bIsOverwieght = IsEncombered(), reads the running weight total instead of summing the Inventory
+	void RefreshEncumbrance();
+
+	// Copies the replicated part of an element into ReplicatedSlots and marks it for the next delta
+	void UpdateReplicatedSlot(int32 Index);
+
+	// Sends the owning client the slots that changed since its last ack
+	void FlushInventoryDelta();
+
+	void SendInventoryAck();
+
+	// Weapon and stat source of each weapon component, same order as WeaponComponents
+	struct FEquipSlot
+	{
+		TWeakObjectPtr<AWeaponBase> Weapon;
+		FStatSourceHandle StatSource;
+	};
+
+	// Adds the stats of the weapon just spawned in WeaponComponents[SlotIndex] to the stat cache, returns the serial of the equip
+	uint32 BindEquipSlot(int32 SlotIndex, const FCharacterStats& Stats);
+
+	// Removes a weapon component's stats from the stat cache
+	void ReleaseEquipSlot(int32 SlotIndex);
+
+	// Weapon component the element is equipped in going by the handle EquipWeapon stored on it, INDEX_NONE if it has none or it is stale
+	int32 FindEquipSlot(const FInventoryElement& Element) const;
+
+	// Releases the slots of weapons that were removed or replaced without going through this component, for example by UnEquipWeapon
+	void RefreshEquipSlots();
+
+	// Replaces the full class's TArray<FInventoryItem> and its add, remove and equip rules, each element holds a definition handle and only its own state
+	// Not a UPROPERTY, the owning client builds its copy from ClientReceiveInventoryDelta and Blueprints read it through GetItemView
+	// The same rules run in replays and batched jobs, so the component has no copy of its own
+	// Its layout comes from FInventoryComponentPolicy, so a static Inventory fills its fixed slots through the same core instead of a second add path
+	FInventorySimulation InventoryCore;
+
+	// Set by the first GetItemRegistry that finds one
+	FItemDefinitionRegistry* ItemRegistryCache = nullptr;
+
+	// Base stats, equipped weapons and stat modifiers
+	FCharacterStatCache StatCache;
+
+	TArray<FEquipSlot> EquipSlots;
+
+	// Type, equipped and sorted indexes behind QueryInventory, kept in sync through the core's change listener once the first query built them
+	FInventoryQueryIndex QueryIndex;
+
+	// Server: replicated state of every element, Client: last state received
+	TArray<FInventorySlotState> ReplicatedSlots;
+
+	FInventoryDeltaSender InventoryDeltaSender;
+
+	FInventoryDeltaReceiver InventoryDeltaReceiver;
+
+	TArray<int32> ChangedSlots; // reused by ClientReceiveInventoryDelta
+
+	FTimerHandle InventoryResendTimer;
+
+	FTimerHandle InventoryAckTimer;
+
 };
\ No newline at end of file
@@ -0,0 +1,280 @@
+/* Aaron Gallagher's Gameplay Code Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunGameplayProfileBenchmark(const TArray<FString>& Args);
+
+// Gameplay.Profile.Bench <Iterations>, times a loop with and without GAMEPLAY_PROFILE_SCOPE and GAMEPLAY_PROFILE_COUNT
+// With WITH_GAMEPLAY_PROFILING set to 0 all three loops compile to the same code, which is what shows the disabled overhead is zero
+static FAutoConsoleCommandWithArgs GGameplayProfileBenchCommand(
+	TEXT("Gameplay.Profile.Bench"),
+	TEXT("Gameplay.Profile.Bench <Iterations>: times an empty loop against the same loop with a profile scope and with a profile count, and checks the latency buckets"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunGameplayProfileBenchmark));
+
+static void RunGameplayProfileBenchmark(const TArray<FString>& Args)
+{
+	const int32 Iterations = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000000;
+	volatile int32 Sink = 0;
+
+	const double BaselineStart = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		Sink = Sink + i;
+	}
+	const double ProbedStart = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		GAMEPLAY_PROFILE_SCOPE(Microbenchmark);
+		Sink = Sink + i;
+	}
+	const double ProbedEnd = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		GAMEPLAY_PROFILE_COUNT(ItemsScanned, 1);
+		Sink = Sink + i;
+	}
+	const double CountedEnd = FPlatformTime::Seconds();
+
+	const double BaselineSeconds = ProbedStart - BaselineStart;
+	UE_LOG(LogTemp, Log, TEXT("Gameplay.Profile.Bench: WITH_GAMEPLAY_PROFILING=%d, %d iterations, baseline %.2f ns, with scope %.2f ns, overhead %.2f ns per scope, %.2f ns per count"),
+		WITH_GAMEPLAY_PROFILING, Iterations, BaselineSeconds * 1e9 / Iterations, (ProbedEnd - ProbedStart) * 1e9 / Iterations,
+		((ProbedEnd - ProbedStart) - BaselineSeconds) * 1e9 / Iterations, ((CountedEnd - ProbedEnd) - BaselineSeconds) * 1e9 / Iterations);
+
+#if WITH_GAMEPLAY_PROFILING
+	// Every value must land in a bucket whose lower bound is at most 1/16 below it, from 0 cycles up to the largest uint64
+	int32 NumBadBuckets = 0;
+	FRandomStream Random(Iterations);
+	for (int32 Exponent = 0; Exponent < 64; Exponent++)
+	{
+		const uint64 Low = 1ull << Exponent;
+		const uint64 High = Low + (Low - 1);
+		const uint64 Values[] = { Low - 1, Low, Low + (((uint64)Random.GetUnsignedInt() << 32 | Random.GetUnsignedInt()) & (Low - 1)), High };
+		for (uint64 Value : Values)
+		{
+			const int32 BucketIndex = FGameplayLatencyHistogram::GetBucketIndex(Value);
+			const uint64 LowerBound = (BucketIndex >= 0 && BucketIndex < FGameplayLatencyHistogram::NumBuckets) ? FGameplayLatencyHistogram::GetBucketLowerBound(BucketIndex) : MAX_uint64;
+			if (LowerBound > Value || (Value - LowerBound) * FGameplayLatencyHistogram::SubBucketCount >= FMath::Max<uint64>(LowerBound, 1)) NumBadBuckets++;
+		}
+	}
+	UE_LOG(LogTemp, Log, TEXT("Gameplay.Profile.Bench: %d values outside their latency bucket, %s"), NumBadBuckets, (NumBadBuckets == 0) ? TEXT("passed") : TEXT("FAILED"));
+#endif
+}
+#endif
+
+#if WITH_GAMEPLAY_PROFILING
+
+FCriticalSection FGameplayProfiler::BuffersLock;
+
+TArray<TUniquePtr<FGameplayProfileThreadBuffer>> FGameplayProfiler::Buffers;
+
+static void DumpGameplayProfile(const TArray<FString>& Args);
+
+// Gameplay.Profile.Dump [csv|json] [Path], writes the merged histograms and counters, by default to Saved/Profiling/GameplayProfile.csv
+static FAutoConsoleCommandWithArgs GGameplayProfileDumpCommand(
+	TEXT("Gameplay.Profile.Dump"),
+	TEXT("Gameplay.Profile.Dump [csv|json] [Path]: writes the inventory and spell latency histograms and counters for offline analysis"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&DumpGameplayProfile));
+
+static FAutoConsoleCommand GGameplayProfileResetCommand(
+	TEXT("Gameplay.Profile.Reset"),
+	TEXT("Clears the inventory and spell latency histograms and counters"),
+	FConsoleCommandDelegate::CreateStatic(&FGameplayProfiler::Reset));
+
+FGameplayProfileThreadBuffer::FGameplayProfileThreadBuffer()
+{
+	Reset();
+}
+
+void FGameplayProfileThreadBuffer::RecordLatency(EGameplayProbe Probe, uint64 Cycles)
+{
+	const int32 ProbeIndex = (int32)Probe;
+	Add(Buckets[ProbeIndex][FGameplayLatencyHistogram::GetBucketIndex(Cycles)], 1);
+	Add(TotalCycles[ProbeIndex], Cycles);
+	if (Cycles > MaxCycles[ProbeIndex].load(std::memory_order_relaxed))
+	{
+		MaxCycles[ProbeIndex].store(Cycles, std::memory_order_relaxed);
+	}
+}
+
+void FGameplayProfileThreadBuffer::Reset()
+{
+	for (int32 p = 0; p < (int32)EGameplayProbe::Count; p++)
+	{
+		for (int32 b = 0; b < FGameplayLatencyHistogram::NumBuckets; b++)
+		{
+			Buckets[p][b].store(0, std::memory_order_relaxed);
+		}
+		TotalCycles[p].store(0, std::memory_order_relaxed);
+		MaxCycles[p].store(0, std::memory_order_relaxed);
+	}
+	for (int32 c = 0; c < (int32)EGameplayCounter::Count; c++)
+	{
+		Counters[c].store(0, std::memory_order_relaxed);
+	}
+}
+
+FGameplayProfileSnapshot::FGameplayProfileSnapshot()
+{
+	Buckets.SetNumZeroed((int32)EGameplayProbe::Count * FGameplayLatencyHistogram::NumBuckets);
+	FMemory::Memzero(Counts);
+	FMemory::Memzero(TotalCycles);
+	FMemory::Memzero(MaxCycles);
+	FMemory::Memzero(Counters);
+	NumThreads = 0;
+}
+
+// Lower bound of the bucket holding the sample at Percentile (0 to 100), in microseconds
+double FGameplayProfileSnapshot::GetPercentileMicroseconds(EGameplayProbe Probe, double Percentile) const
+{
+	const uint64 Count = Counts[(int32)Probe];
+	if (Count == 0) return 0.0;
+	const uint64 Rank = FMath::Max<uint64>((uint64)FMath::CeilToDouble(FMath::Clamp(Percentile, 0.0, 100.0) / 100.0 * (double)Count), 1);
+	const uint64* ProbeBuckets = &Buckets[(int32)Probe * FGameplayLatencyHistogram::NumBuckets];
+	uint64 Seen = 0;
+	for (int32 b = 0; b < FGameplayLatencyHistogram::NumBuckets; b++)
+	{
+		Seen += ProbeBuckets[b];
+		if (Seen >= Rank) return FPlatformTime::ToMilliseconds64(FGameplayLatencyHistogram::GetBucketLowerBound(b)) * 1000.0;
+	}
+	return GetMaxMicroseconds(Probe);
+}
+
+double FGameplayProfileSnapshot::GetMeanMicroseconds(EGameplayProbe Probe) const
+{
+	const uint64 Count = Counts[(int32)Probe];
+	if (Count == 0) return 0.0;
+	return FPlatformTime::ToMilliseconds64(TotalCycles[(int32)Probe]) * 1000.0 / (double)Count;
+}
+
+double FGameplayProfileSnapshot::GetMaxMicroseconds(EGameplayProbe Probe) const
+{
+	return FPlatformTime::ToMilliseconds64(MaxCycles[(int32)Probe]) * 1000.0;
+}
+
+// One row per probe, then one row per counter
+FString FGameplayProfileSnapshot::ExportCSV() const
+{
+	FString Output = TEXT("Probe,Calls,MeanUs,P50Us,P90Us,P99Us,P999Us,MaxUs\n");
+	for (int32 p = 0; p < (int32)EGameplayProbe::Count; p++)
+	{
+		const EGameplayProbe Probe = (EGameplayProbe)p;
+		Output += FString::Printf(TEXT("%s,%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n"), FGameplayProfiler::GetProbeName(Probe), Counts[p],
+			GetMeanMicroseconds(Probe), GetPercentileMicroseconds(Probe, 50.0), GetPercentileMicroseconds(Probe, 90.0),
+			GetPercentileMicroseconds(Probe, 99.0), GetPercentileMicroseconds(Probe, 99.9), GetMaxMicroseconds(Probe));
+	}
+	Output += TEXT("\nCounter,Value\n");
+	for (int32 c = 0; c < (int32)EGameplayCounter::Count; c++)
+	{
+		Output += FString::Printf(TEXT("%s,%llu\n"), FGameplayProfiler::GetCounterName((EGameplayCounter)c), Counters[c]);
+	}
+	return Output;
+}
+
+// Same values as ExportCSV, plus the non empty histogram buckets of every probe
+FString FGameplayProfileSnapshot::ExportJSON() const
+{
+	FString Output = FString::Printf(TEXT("{\n\t\"threads\": %d,\n\t\"probes\": {\n"), NumThreads);
+	for (int32 p = 0; p < (int32)EGameplayProbe::Count; p++)
+	{
+		const EGameplayProbe Probe = (EGameplayProbe)p;
+		Output += FString::Printf(TEXT("\t\t\"%s\": { \"calls\": %llu, \"mean_us\": %.3f, \"p50_us\": %.3f, \"p90_us\": %.3f, \"p99_us\": %.3f, \"p999_us\": %.3f, \"max_us\": %.3f, \"buckets\": ["),
+			FGameplayProfiler::GetProbeName(Probe), Counts[p], GetMeanMicroseconds(Probe), GetPercentileMicroseconds(Probe, 50.0),
+			GetPercentileMicroseconds(Probe, 90.0), GetPercentileMicroseconds(Probe, 99.0), GetPercentileMicroseconds(Probe, 99.9), GetMaxMicroseconds(Probe));
+		bool bFirstBucket = true;
+		for (int32 b = 0; b < FGameplayLatencyHistogram::NumBuckets; b++)
+		{
+			const uint64 BucketCount = Buckets[(p * FGameplayLatencyHistogram::NumBuckets) + b];
+			if (BucketCount == 0) continue;
+			Output += FString::Printf(TEXT("%s[%.3f, %llu]"), bFirstBucket ? TEXT("") : TEXT(", "),
+				FPlatformTime::ToMilliseconds64(FGameplayLatencyHistogram::GetBucketLowerBound(b)) * 1000.0, BucketCount);
+			bFirstBucket = false;
+		}
+		Output += (p + 1 < (int32)EGameplayProbe::Count) ? TEXT("] },\n") : TEXT("] }\n");
+	}
+	Output += TEXT("\t},\n\t\"counters\": {\n");
+	for (int32 c = 0; c < (int32)EGameplayCounter::Count; c++)
+	{
+		Output += FString::Printf(TEXT("\t\t\"%s\": %llu%s\n"), FGameplayProfiler::GetCounterName((EGameplayCounter)c), Counters[c],
+			(c + 1 < (int32)EGameplayCounter::Count) ? TEXT(",") : TEXT(""));
+	}
+	Output += TEXT("\t}\n}\n");
+	return Output;
+}
+
+// Returns the calling thread's buffer, the lock is only taken the first time a thread records
+FGameplayProfileThreadBuffer& FGameplayProfiler::GetThreadBuffer()
+{
+	static thread_local FGameplayProfileThreadBuffer* ThreadBuffer = nullptr;
+	if (!ThreadBuffer)
+	{
+		FScopeLock Lock(&BuffersLock);
+		ThreadBuffer = Buffers.Add_GetRef(MakeUnique<FGameplayProfileThreadBuffer>()).Get();
+	}
+	return *ThreadBuffer;
+}
+
+// Merges every thread buffer
+void FGameplayProfiler::TakeSnapshot(FGameplayProfileSnapshot& OutSnapshot)
+{
+	OutSnapshot = FGameplayProfileSnapshot();
+	FScopeLock Lock(&BuffersLock);
+	OutSnapshot.NumThreads = Buffers.Num();
+	for (const TUniquePtr<FGameplayProfileThreadBuffer>& Buffer : Buffers)
+	{
+		for (int32 p = 0; p < (int32)EGameplayProbe::Count; p++)
+		{
+			uint64* ProbeBuckets = &OutSnapshot.Buckets[p * FGameplayLatencyHistogram::NumBuckets];
+			for (int32 b = 0; b < FGameplayLatencyHistogram::NumBuckets; b++)
+			{
+				const uint64 BucketCount = Buffer->Buckets[p][b].load(std::memory_order_relaxed);
+				ProbeBuckets[b] += BucketCount;
+				OutSnapshot.Counts[p] += BucketCount;
+			}
+			OutSnapshot.TotalCycles[p] += Buffer->TotalCycles[p].load(std::memory_order_relaxed);
+			OutSnapshot.MaxCycles[p] = FMath::Max(OutSnapshot.MaxCycles[p], Buffer->MaxCycles[p].load(std::memory_order_relaxed));
+		}
+		for (int32 c = 0; c < (int32)EGameplayCounter::Count; c++)
+		{
+			OutSnapshot.Counters[c] += Buffer->Counters[c].load(std::memory_order_relaxed);
+		}
+	}
+}
+
+// Clears every thread buffer, samples recorded on other threads during the reset can survive it
+void FGameplayProfiler::Reset()
+{
+	FScopeLock Lock(&BuffersLock);
+	for (const TUniquePtr<FGameplayProfileThreadBuffer>& Buffer : Buffers)
+	{
+		Buffer->Reset();
+	}
+}
+
+const TCHAR* FGameplayProfiler::GetProbeName(EGameplayProbe Probe)
+{
+	static const TCHAR* ProbeNames[] = { TEXT("AddItemtoInventoryByID"), TEXT("IncreaseQuantityAtIndex"), TEXT("DropItemAtLocation"), TEXT("EquipWeapon"), TEXT("SpawnDotParticle"), TEXT("OnSpellOverlap"), TEXT("Microbenchmark") };
+	static_assert(UE_ARRAY_COUNT(ProbeNames) == (int32)EGameplayProbe::Count, "Every EGameplayProbe needs a name");
+	return ProbeNames[(int32)Probe];
+}
+
+const TCHAR* FGameplayProfiler::GetCounterName(EGameplayCounter Counter)
+{
+	static const TCHAR* CounterNames[] = { TEXT("ItemsScanned"), TEXT("StacksSplit"), TEXT("ActorsSpawned"), TEXT("DataTableLookups"), TEXT("ValidateRejections"), TEXT("ClaimsLost") };
+	static_assert(UE_ARRAY_COUNT(CounterNames) == (int32)EGameplayCounter::Count, "Every EGameplayCounter needs a name");
+	return CounterNames[(int32)Counter];
+}
+
+// Gameplay.Profile.Dump [csv|json] [Path], writes the merged histograms and counters, by default to Saved/Profiling/GameplayProfile.csv
+static void DumpGameplayProfile(const TArray<FString>& Args)
+{
+	const bool bJSON = Args.IsValidIndex(0) && Args[0].Equals(TEXT("json"), ESearchCase::IgnoreCase);
+	const FString Path = Args.IsValidIndex(1) ? Args[1] : FPaths::ProfilingDir() / (bJSON ? TEXT("GameplayProfile.json") : TEXT("GameplayProfile.csv"));
+
+	FGameplayProfileSnapshot Snapshot;
+	FGameplayProfiler::TakeSnapshot(Snapshot);
+	const bool bSaved = FFileHelper::SaveStringToFile(bJSON ? Snapshot.ExportJSON() : Snapshot.ExportCSV(), *Path);
+	UE_LOG(LogTemp, Log, TEXT("Gameplay.Profile.Dump: %s %s"), bSaved ? TEXT("wrote") : TEXT("could not write"), *Path);
+}
+
+#endif // WITH_GAMEPLAY_PROFILING
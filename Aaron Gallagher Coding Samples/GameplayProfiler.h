@@ -0,0 +1,197 @@
+#pragma once
+/* Aaron Gallagher's Gameplay Code Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+// Scoped timers and counters on the inventory and spell hot paths
+// When 0 every GAMEPLAY_PROFILE macro expands to nothing, its arguments are not evaluated, so they must not have side effects
+#ifndef WITH_GAMEPLAY_PROFILING
+#define WITH_GAMEPLAY_PROFILING !UE_BUILD_SHIPPING
+#endif
+
+
+/* Paths timed by GAMEPLAY_PROFILE_SCOPE */
+enum class EGameplayProbe : uint8
+{
+	AddItemtoInventoryByID,
+	IncreaseQuantityAtIndex,
+	DropItemAtLocation,
+	EquipWeapon,
+	SpawnDotParticle,
+	OnSpellOverlap,
+	Microbenchmark, // only used by Gameplay.Profile.Bench
+	Count
+};
+
+/* Totals added to by GAMEPLAY_PROFILE_COUNT, calls are the sample counts of the probes */
+enum class EGameplayCounter : uint8
+{
+	ItemsScanned,
+	StacksSplit,
+	ActorsSpawned,
+	DataTableLookups,
+	ValidateRejections,
+	ClaimsLost, // pickup interactions that got nothing, the pickup was emptied by another player or none of it fit
+	Count
+};
+
+
+#if WITH_GAMEPLAY_PROFILING
+
+/* HDR style latency buckets, 16 linear sub buckets per power of two so every sample is within 1/16 of its bucket's lower bound */
+/* Covers the whole uint64 range of cycle counts in 976 buckets without any configuration */
+struct FGameplayLatencyHistogram
+{
+public:
+
+	static const int32 SubBucketBits = 4;
+
+	static const int32 SubBucketCount = 1 << SubBucketBits;
+
+	static const int32 NumBuckets = (64 - SubBucketBits + 1) * SubBucketCount;
+
+	static int32 GetBucketIndex(uint64 Value)
+	{
+		if (Value < SubBucketCount) return (int32)Value;
+		const int32 Exponent = (int32)FMath::FloorLog2_64(Value);
+		const int32 SubBucket = (int32)(Value >> (Exponent - SubBucketBits)) & (SubBucketCount - 1);
+		return ((Exponent - SubBucketBits + 1) * SubBucketCount) + SubBucket;
+	}
+
+	static uint64 GetBucketLowerBound(int32 BucketIndex)
+	{
+		if (BucketIndex < SubBucketCount) return (uint64)BucketIndex;
+		const int32 Exponent = (BucketIndex / SubBucketCount) + SubBucketBits - 1;
+		const uint64 SubBucket = (uint64)(BucketIndex % SubBucketCount);
+		return (SubBucketCount + SubBucket) << (Exponent - SubBucketBits);
+	}
+};
+
+
+/* Samples recorded by one thread, only that thread writes to it so recording needs no lock and no locked instruction */
+/* Readers merge every buffer with relaxed loads, a snapshot taken while threads are recording can be a few samples behind */
+struct FGameplayProfileThreadBuffer
+{
+public:
+
+	FGameplayProfileThreadBuffer();
+
+	void RecordLatency(EGameplayProbe Probe, uint64 Cycles);
+
+	void AddCount(EGameplayCounter Counter, uint64 Amount) { Add(Counters[(int32)Counter], Amount); }
+
+	void Reset();
+
+	std::atomic<uint64> Buckets[(int32)EGameplayProbe::Count][FGameplayLatencyHistogram::NumBuckets];
+
+	std::atomic<uint64> TotalCycles[(int32)EGameplayProbe::Count];
+
+	std::atomic<uint64> MaxCycles[(int32)EGameplayProbe::Count];
+
+	std::atomic<uint64> Counters[(int32)EGameplayCounter::Count];
+
+private:
+
+	// Single writer, a relaxed load and store is enough and avoids the cost of an atomic add
+	static void Add(std::atomic<uint64>& Slot, uint64 Amount) { Slot.store(Slot.load(std::memory_order_relaxed) + Amount, std::memory_order_relaxed); }
+};
+
+
+/* Every thread buffer merged into one set of totals, with percentiles and CSV or JSON export for offline analysis */
+struct FGameplayProfileSnapshot
+{
+public:
+
+	FGameplayProfileSnapshot();
+
+	uint64 GetCount(EGameplayProbe Probe) const { return Counts[(int32)Probe]; }
+
+	uint64 GetCounter(EGameplayCounter Counter) const { return Counters[(int32)Counter]; }
+
+	// Lower bound of the bucket holding the sample at Percentile (0 to 100), in microseconds
+	double GetPercentileMicroseconds(EGameplayProbe Probe, double Percentile) const;
+
+	double GetMeanMicroseconds(EGameplayProbe Probe) const;
+
+	double GetMaxMicroseconds(EGameplayProbe Probe) const;
+
+	// One row per probe, then one row per counter
+	FString ExportCSV() const;
+
+	FString ExportJSON() const;
+
+	TArray<uint64> Buckets; // NumBuckets per probe
+
+	uint64 Counts[(int32)EGameplayProbe::Count];
+
+	uint64 TotalCycles[(int32)EGameplayProbe::Count];
+
+	uint64 MaxCycles[(int32)EGameplayProbe::Count];
+
+	uint64 Counters[(int32)EGameplayCounter::Count];
+
+	int32 NumThreads;
+};
+
+
+/* Owns one buffer per thread that has recorded anything, buffers live until shutdown since engine threads are long lived */
+class FGameplayProfiler
+{
+public:
+
+	// Returns the calling thread's buffer, the lock is only taken the first time a thread records
+	static FGameplayProfileThreadBuffer& GetThreadBuffer();
+
+	static void RecordLatency(EGameplayProbe Probe, uint64 Cycles) { GetThreadBuffer().RecordLatency(Probe, Cycles); }
+
+	static void AddCount(EGameplayCounter Counter, uint64 Amount) { GetThreadBuffer().AddCount(Counter, Amount); }
+
+	// Merges every thread buffer
+	static void TakeSnapshot(FGameplayProfileSnapshot& OutSnapshot);
+
+	// Clears every thread buffer, samples recorded on other threads during the reset can survive it
+	static void Reset();
+
+	static const TCHAR* GetProbeName(EGameplayProbe Probe);
+
+	static const TCHAR* GetCounterName(EGameplayCounter Counter);
+
+private:
+
+	static FCriticalSection BuffersLock;
+
+	static TArray<TUniquePtr<FGameplayProfileThreadBuffer>> Buffers;
+};
+
+
+/* Records the cycles between construction and destruction into the calling thread's histogram for Probe */
+struct FScopedGameplayProbe
+{
+public:
+
+	explicit FScopedGameplayProbe(EGameplayProbe InProbe)
+	{
+		Probe = InProbe;
+		StartCycles = FPlatformTime::Cycles64();
+	}
+
+	~FScopedGameplayProbe()
+	{
+		FGameplayProfiler::RecordLatency(Probe, FPlatformTime::Cycles64() - StartCycles);
+	}
+
+private:
+
+	EGameplayProbe Probe;
+
+	uint64 StartCycles;
+};
+
+#define GAMEPLAY_PROFILE_SCOPE(Probe) FScopedGameplayProbe ANONYMOUS_VARIABLE(GameplayProbe)(EGameplayProbe::Probe)
+#define GAMEPLAY_PROFILE_COUNT(Counter, Amount) FGameplayProfiler::AddCount(EGameplayCounter::Counter, (uint64)(Amount))
+
+#else
+
+#define GAMEPLAY_PROFILE_SCOPE(Probe)
+#define GAMEPLAY_PROFILE_COUNT(Counter, Amount)
+
+#endif // WITH_GAMEPLAY_PROFILING
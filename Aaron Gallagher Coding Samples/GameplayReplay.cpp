@@ -0,0 +1,362 @@
+/* Aaron Gallagher's Gameplay Code Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunGameplayReplay(const TArray<FString>& Args);
+
+// Gameplay.Replay <Trace> [Baseline] [-update] [-iterations=N] [-tolerance=0.2]
+// With a baseline the result is compared and logged, -update writes the result as the new baseline instead
+// The Gameplay.Replay.Baseline automation test runs the same comparison over every checked in trace and fails on a difference
+static FAutoConsoleCommandWithArgs GGameplayReplayCommand(
+	TEXT("Gameplay.Replay"),
+	TEXT("Gameplay.Replay <Trace> [Baseline] [-update] [-iterations=N] [-tolerance=0.2]: replays a loot and combat trace and compares it to a JSON baseline"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunGameplayReplay));
+#endif
+
+// Returns false and describes the first bad line in OutError, events must be in time order
+bool FGameplayTrace::LoadFromString(const FString& Text, FString& OutError)
+{
+	TArray<FString> Lines;
+	Text.ParseIntoArrayLines(Lines, false);
+	double LastTime = 0.0;
+	for (int32 LineIndex = 0; LineIndex < Lines.Num(); LineIndex++)
+	{
+		FString Line = Lines[LineIndex];
+		int32 CommentStart = INDEX_NONE;
+		if (Line.FindChar(TEXT('#'), CommentStart)) Line.LeftInline(CommentStart);
+		TArray<FString> Tokens;
+		Line.ParseIntoArrayWS(Tokens);
+		if (Tokens.Num() == 0) continue;
+
+		OutError = FString::Printf(TEXT("line %d: "), LineIndex + 1);
+		if (Tokens[0] == TEXT("CONFIG"))
+		{
+			if (Tokens.Num() != 4) { OutError += TEXT("CONFIG needs <InventorySize> <MaxStackSize> <WeightLimit>"); return false; }
+			InventorySize = FCString::Atoi(*Tokens[1]);
+			MaxStackSize = FCString::Atoi(*Tokens[2]);
+			WeightLimit = FCString::Atof(*Tokens[3]);
+			continue;
+		}
+		if (Tokens[0] == TEXT("ITEM"))
+		{
+			if (Tokens.Num() != 6) { OutError += TEXT("ITEM needs <ItemID> <Stackable> <Equippable> <Weight> <Value>"); return false; }
+			FInventoryItem Definition;
+			Definition.ItemID = FName(*Tokens[1]);
+			Definition.bIsStackable = FCString::Atoi(*Tokens[2]) != 0;
+			Definition.bIsEquippable = FCString::Atoi(*Tokens[3]) != 0;
+			Definition.Weight = FCString::Atof(*Tokens[4]);
+			Definition.ItemValue = FCString::Atoi(*Tokens[5]);
+			Items.Add(Definition);
+			continue;
+		}
+
+		const bool bIsEnd = (Tokens.Num() == 2) && (Tokens[1] == TEXT("END"));
+		if (Tokens.Num() < 3 && !bIsEnd) { OutError += TEXT("events need <Time> <Event> <Owner>"); return false; }
+		FGameplayTraceEvent Event;
+		Event.Time = FCString::Atod(*Tokens[0]);
+		Event.OwnerID = bIsEnd ? 0 : FCString::Atoi(*Tokens[2]);
+		if (Event.Time < LastTime) { OutError += TEXT("events are not in time order"); return false; }
+		LastTime = Event.Time;
+
+		const FString& Op = Tokens[1];
+		if (bIsEnd)
+		{
+			Event.Op = EGameplayTraceOp::End;
+		}
+		else if (Op == TEXT("ADD") && Tokens.Num() == 5)
+		{
+			Event.Op = EGameplayTraceOp::Add;
+			Event.ItemID = FName(*Tokens[3]);
+			Event.Quantity = FCString::Atoi(*Tokens[4]);
+			if (!Items.FindHandle(Event.ItemID).IsValid()) { OutError += TEXT("ADD of an item with no ITEM line"); return false; }
+		}
+		else if (Op == TEXT("REMOVE") && Tokens.Num() == 5)
+		{
+			Event.Op = EGameplayTraceOp::Remove;
+			Event.Slot = FCString::Atoi(*Tokens[3]);
+			Event.Quantity = FCString::Atoi(*Tokens[4]);
+		}
+		else if ((Op == TEXT("EQUIP") || Op == TEXT("UNEQUIP")) && Tokens.Num() == 4)
+		{
+			Event.Op = (Op == TEXT("EQUIP")) ? EGameplayTraceOp::Equip : EGameplayTraceOp::Unequip;
+			Event.Slot = FCString::Atoi(*Tokens[3]);
+		}
+		else if (Op == TEXT("DOT") && Tokens.Num() >= 7)
+		{
+			Event.Op = EGameplayTraceOp::DotHit;
+			Event.Amount = FCString::Atof(*Tokens[3]);
+			Event.Interval = FCString::Atof(*Tokens[4]);
+			Event.Duration = FCString::Atof(*Tokens[5]);
+			for (int32 i = 6; i < Tokens.Num(); i++)
+			{
+				Event.TargetIDs.Add(FCString::Atoi(*Tokens[i]));
+			}
+		}
+		else if (Op == TEXT("CHANNEL_BEGIN") && Tokens.Num() == 6)
+		{
+			Event.Op = EGameplayTraceOp::ChannelBegin;
+			Event.TargetIDs.Add(FCString::Atoi(*Tokens[3]));
+			Event.Amount = FCString::Atof(*Tokens[4]);
+			Event.Interval = FCString::Atof(*Tokens[5]);
+		}
+		else if (Op == TEXT("CHANNEL_END") && Tokens.Num() == 3)
+		{
+			Event.Op = EGameplayTraceOp::ChannelEnd;
+		}
+		else
+		{
+			OutError += FString::Printf(TEXT("unknown event or wrong number of values for %s"), *Op);
+			return false;
+		}
+		Events.Add(MoveTemp(Event));
+	}
+	OutError.Reset();
+	return true;
+}
+
+bool FGameplayTrace::LoadFromFile(const FString& Path, FString& OutError)
+{
+	FString Text;
+	if (!FFileHelper::LoadFileToString(Text, *Path))
+	{
+		OutError = FString::Printf(TEXT("could not read %s"), *Path);
+		return false;
+	}
+	return LoadFromString(Text, OutError);
+}
+
+FString FGameplayReplayResult::ToJSON() const
+{
+	return FString::Printf(TEXT("{\n\t\"events\": %d,\n\t\"inventory_digest\": %u,\n\t\"spell_digest\": %u,\n\t\"left_over_quantity\": %d,\n\t\"left_overs\": %d,\n\t\"damage_ticks\": %d,\n\t\"total_damage\": %.3f,\n\t\"ns_per_event\": %.1f\n}\n"),
+		NumEvents, InventoryDigest, SpellDigest, LeftoverQuantity, NumLeftovers, NumDamageTicks, TotalDamage, NanosecondsPerEvent);
+}
+
+// FParse::Value reads uint32 through Strtoi, which stops at MAX_int32 where long is 32 bits, so half of all digests would never match
+static bool ParseDigest(const TCHAR* Stream, const TCHAR* Match, uint32& OutDigest)
+{
+	const TCHAR* Found = FCString::Strifind(Stream, Match);
+	if (!Found) return false;
+	TCHAR* End = nullptr;
+	const uint64 Digest = FCString::Strtoui64(Found + FCString::Strlen(Match), &End, 10);
+	if (End == Found + FCString::Strlen(Match) || Digest > MAX_uint32) return false;
+	OutDigest = (uint32)Digest;
+	return true;
+}
+
+// Reads a baseline written by ToJSON()
+bool FGameplayReplayResult::FromJSON(const FString& JSON)
+{
+	const TCHAR* Stream = *JSON;
+	return FParse::Value(Stream, TEXT("\"events\":"), NumEvents)
+		&& ParseDigest(Stream, TEXT("\"inventory_digest\":"), InventoryDigest)
+		&& ParseDigest(Stream, TEXT("\"spell_digest\":"), SpellDigest)
+		&& FParse::Value(Stream, TEXT("\"left_over_quantity\":"), LeftoverQuantity)
+		&& FParse::Value(Stream, TEXT("\"left_overs\":"), NumLeftovers)
+		&& FParse::Value(Stream, TEXT("\"damage_ticks\":"), NumDamageTicks)
+		&& FParse::Value(Stream, TEXT("\"total_damage\":"), TotalDamage)
+		&& FParse::Value(Stream, TEXT("\"ns_per_event\":"), NanosecondsPerEvent);
+}
+
+// Replays the whole trace Iterations times from an empty state, every iteration produces the same result
+FGameplayReplayResult FGameplayReplay::Run(const FGameplayTrace& Trace, int32 Iterations)
+{
+	FGameplayReplayResult Result;
+	Result.NumEvents = Trace.Events.Num();
+	double FastestSeconds = MAX_dbl;
+	for (int32 Iteration = 0; Iteration < FMath::Max(Iterations, 1); Iteration++)
+	{
+		TMap<int32, FInventorySimulation> Inventories;
+		FSpellSimulation Spells;
+		int32 LeftoverQuantity = 0;
+		int32 NumLeftovers = 0;
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (const FGameplayTraceEvent& Event : Trace.Events)
+		{
+			Spells.Advance(Event.Time); // damage ticks due before this event land first, like a World tick would
+			if (Event.Op == EGameplayTraceOp::End) continue;
+			if (Event.Op == EGameplayTraceOp::DotHit)
+			{
+				Spells.DotHit(Event.OwnerID, Event.TargetIDs, Event.Amount, Event.Interval, Event.Duration, Event.Time);
+				continue;
+			}
+			if (Event.Op == EGameplayTraceOp::ChannelBegin)
+			{
+				Spells.BeginChannel(Event.OwnerID, Event.TargetIDs[0], Event.Amount, Event.Interval, Event.Time);
+				continue;
+			}
+			if (Event.Op == EGameplayTraceOp::ChannelEnd)
+			{
+				Spells.EndChannel(Event.OwnerID);
+				continue;
+			}
+
+			FInventorySimulation* Inventory = Inventories.Find(Event.OwnerID);
+			if (!Inventory)
+			{
+				Inventory = &Inventories.Emplace(Event.OwnerID, FInventorySimulation(&Trace.Items, Trace.InventorySize, Trace.MaxStackSize, Trace.WeightLimit));
+			}
+			switch (Event.Op)
+			{
+			case EGameplayTraceOp::Add:
+			{
+				const int32 Leftover = Inventory->AddItem(Trace.Items.FindHandle(Event.ItemID), Event.Quantity);
+				LeftoverQuantity += Leftover;
+				NumLeftovers += (Leftover > 0) ? 1 : 0;
+				break;
+			}
+			case EGameplayTraceOp::Remove:	Inventory->RemoveItem(Event.Slot, Event.Quantity); break;
+			case EGameplayTraceOp::Equip:	Inventory->SetEquipped(Event.Slot, true); break;
+			case EGameplayTraceOp::Unequip:	Inventory->SetEquipped(Event.Slot, false); break;
+			default: break;
+			}
+		}
+		FastestSeconds = FMath::Min(FastestSeconds, FPlatformTime::Seconds() - StartTime);
+
+		// Owners in ID order so the digest does not depend on map order
+		TArray<int32> OwnerIDs;
+		Inventories.GenerateKeyArray(OwnerIDs);
+		OwnerIDs.Sort();
+		Result.InventoryDigest = GetTypeHash(OwnerIDs.Num());
+		Result.LeftoverQuantity = LeftoverQuantity;
+		Result.NumLeftovers = NumLeftovers;
+		for (int32 OwnerID : OwnerIDs)
+		{
+			const FInventorySimulation& Inventory = Inventories[OwnerID];
+			Result.InventoryDigest = HashCombine(Result.InventoryDigest, HashCombine(GetTypeHash(OwnerID), Inventory.GetDigest()));
+		}
+		Result.SpellDigest = Spells.GetDigest();
+		Result.NumDamageTicks = Spells.GetNumDamageTicks();
+		Result.TotalDamage = Spells.GetTotalDamage();
+	}
+	Result.NanosecondsPerEvent = (Result.NumEvents > 0) ? (FastestSeconds * 1e9 / Result.NumEvents) : 0.0;
+	return Result;
+}
+
+// Returns false if the behaviour differs from Baseline or the time per event grew by more than TimeTolerance (0.2 is 20%)
+bool FGameplayReplay::CompareToBaseline(const FGameplayReplayResult& Result, const FGameplayReplayResult& Baseline, double TimeTolerance, FString& OutReport)
+{
+	bool bPassed = true;
+	OutReport.Reset();
+	if (Result.NumEvents != Baseline.NumEvents || Result.InventoryDigest != Baseline.InventoryDigest
+		|| Result.LeftoverQuantity != Baseline.LeftoverQuantity || Result.NumLeftovers != Baseline.NumLeftovers)
+	{
+		OutReport += TEXT("inventory results differ from the baseline; ");
+		bPassed = false;
+	}
+	if (Result.SpellDigest != Baseline.SpellDigest || Result.NumDamageTicks != Baseline.NumDamageTicks
+		|| !FMath::IsNearlyEqual(Result.TotalDamage, Baseline.TotalDamage, 0.01))
+	{
+		OutReport += TEXT("spell results differ from the baseline; ");
+		bPassed = false;
+	}
+	const double AllowedNanoseconds = Baseline.NanosecondsPerEvent * (1.0 + TimeTolerance);
+	if (Baseline.NanosecondsPerEvent > 0.0 && Result.NanosecondsPerEvent > AllowedNanoseconds)
+	{
+		OutReport += TEXT("slower than the baseline allows; ");
+		bPassed = false;
+	}
+	OutReport += FString::Printf(TEXT("%.1f ns per event, baseline %.1f, allowed %.1f"), Result.NanosecondsPerEvent, Baseline.NanosecondsPerEvent, AllowedNanoseconds);
+	return bPassed;
+}
+
+#if !UE_BUILD_SHIPPING
+// Gameplay.Replay <Trace> [Baseline] [-update] [-iterations=N] [-tolerance=0.2]
+static void RunGameplayReplay(const TArray<FString>& Args)
+{
+	if (Args.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Gameplay.Replay: no trace given"));
+		return;
+	}
+	const FString CommandLine = FString::Join(Args, TEXT(" "));
+	const FString BaselinePath = (Args.IsValidIndex(1) && !Args[1].StartsWith(TEXT("-"))) ? Args[1] : FString();
+	const bool bUpdateBaseline = FParse::Param(*CommandLine, TEXT("update"));
+	int32 Iterations = 10;
+	FParse::Value(*CommandLine, TEXT("-iterations="), Iterations);
+	double TimeTolerance = 0.2;
+	FParse::Value(*CommandLine, TEXT("-tolerance="), TimeTolerance);
+
+	FGameplayTrace Trace;
+	FString Error;
+	if (!Trace.LoadFromFile(Args[0], Error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Gameplay.Replay: %s: %s"), *Args[0], *Error);
+		return;
+	}
+	const FGameplayReplayResult Result = FGameplayReplay::Run(Trace, Iterations);
+	UE_LOG(LogTemp, Log, TEXT("Gameplay.Replay: %s\n%s"), *Args[0], *Result.ToJSON());
+	if (BaselinePath.IsEmpty()) return;
+
+	if (bUpdateBaseline)
+	{
+		FFileHelper::SaveStringToFile(Result.ToJSON(), *BaselinePath);
+		UE_LOG(LogTemp, Log, TEXT("Gameplay.Replay: wrote baseline %s"), *BaselinePath);
+		return;
+	}
+	FString BaselineJSON;
+	FGameplayReplayResult Baseline;
+	if (!FFileHelper::LoadFileToString(BaselineJSON, *BaselinePath) || !Baseline.FromJSON(BaselineJSON))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Gameplay.Replay: could not read baseline %s"), *BaselinePath);
+		return;
+	}
+	FString Report;
+	if (FGameplayReplay::CompareToBaseline(Result, Baseline, TimeTolerance, Report))
+	{
+		UE_LOG(LogTemp, Log, TEXT("Gameplay.Replay: passed, %s"), *Report);
+	}
+	else UE_LOG(LogTemp, Error, TEXT("Gameplay.Replay: failed, %s"), *Report);
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FGameplayReplayBaselineTest, "Gameplay.Replay.Baseline", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// Folder of checked in traces, each <Name>.trace is compared to the <Name>.json baseline next to it
+static FString GetReplayBaselineDir()
+{
+	return FPaths::ProjectDir() / TEXT("Tests/GameplayReplay");
+}
+
+// One test per trace
+void FGameplayReplayBaselineTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	TArray<FString> TraceFiles;
+	IFileManager::Get().FindFiles(TraceFiles, *(GetReplayBaselineDir() / TEXT("*.trace")), true, false);
+	for (const FString& TraceFile : TraceFiles)
+	{
+		OutBeautifiedNames.Add(FPaths::GetBaseFilename(TraceFile));
+		OutTestCommands.Add(GetReplayBaselineDir() / TraceFile);
+	}
+}
+
+// Fails if the replay's behaviour differs from the baseline or its time per event grew by more than 20%
+// A trace without a baseline fails too, write one with Gameplay.Replay <Trace> <Baseline> -update
+bool FGameplayReplayBaselineTest::RunTest(const FString& Parameters)
+{
+	FGameplayTrace Trace;
+	FString Error;
+	if (!Trace.LoadFromFile(Parameters, Error))
+	{
+		AddError(FString::Printf(TEXT("%s: %s"), *Parameters, *Error));
+		return false;
+	}
+	const FString BaselinePath = FPaths::ChangeExtension(Parameters, TEXT("json"));
+	FString BaselineJSON;
+	FGameplayReplayResult Baseline;
+	if (!FFileHelper::LoadFileToString(BaselineJSON, *BaselinePath) || !Baseline.FromJSON(BaselineJSON))
+	{
+		AddError(FString::Printf(TEXT("could not read baseline %s"), *BaselinePath));
+		return false;
+	}
+
+	const FGameplayReplayResult Result = FGameplayReplay::Run(Trace, 10);
+	FString Report;
+	const bool bPassed = FGameplayReplay::CompareToBaseline(Result, Baseline, 0.2, Report);
+	if (bPassed) AddInfo(Report);
+	else AddError(Report);
+	return bPassed;
+}
+#endif
+#endif
@@ -0,0 +1,148 @@
+#pragma once
+/* Aaron Gallagher's Gameplay Code Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+enum class EGameplayTraceOp : uint8
+{
+	Add,
+	Remove,
+	Equip,
+	Unequip,
+	DotHit,
+	ChannelBegin,
+	ChannelEnd,
+	End // only advances time, so damage ticks after the last loot or combat event are counted
+};
+
+
+/* One recorded loot or combat event */
+struct FGameplayTraceEvent
+{
+public:
+
+	FGameplayTraceEvent()
+	{
+		Op = EGameplayTraceOp::Add;
+		Time = 0.0;
+		OwnerID = 0;
+		ItemID = NAME_None;
+		Slot = INDEX_NONE;
+		Quantity = 0;
+		Amount = 0.f;
+		Interval = 0.f;
+		Duration = 0.f;
+	}
+
+	EGameplayTraceOp Op;
+
+	double Time;
+
+	int32 OwnerID; // Inventory owner, or the caster of a spell
+
+	FName ItemID;
+
+	int32 Slot;
+
+	int32 Quantity;
+
+	float Amount;
+
+	float Interval;
+
+	float Duration;
+
+	TArray<int32> TargetIDs; // characters a spell overlapped, in overlap order
+};
+
+
+/* A recorded loot and combat session, read from a plain text trace with one line per entry, # starts a comment */
+/*   CONFIG <InventorySize> <MaxStackSize> <WeightLimit> */
+/*   ITEM <ItemID> <Stackable 0|1> <Equippable 0|1> <Weight> <Value> */
+/*   <Time> ADD <Owner> <ItemID> <Quantity> */
+/*   <Time> REMOVE <Owner> <Slot> <Quantity> */
+/*   <Time> EQUIP <Owner> <Slot>  and  <Time> UNEQUIP <Owner> <Slot> */
+/*   <Time> DOT <Caster> <Amount> <Interval> <Duration> <Target>... */
+/*   <Time> CHANNEL_BEGIN <Caster> <Target> <Amount> <Interval>  and  <Time> CHANNEL_END <Caster> */
+/*   <Time> END  applies every damage tick due up to Time, ticks after the last event are otherwise never replayed */
+struct FGameplayTrace
+{
+public:
+
+	FGameplayTrace()
+	{
+		InventorySize = 30;
+		MaxStackSize = 99;
+		WeightLimit = 0.f;
+	}
+
+	// Returns false and describes the first bad line in OutError, events must be in time order
+	bool LoadFromString(const FString& Text, FString& OutError);
+
+	bool LoadFromFile(const FString& Path, FString& OutError);
+
+	FItemDefinitionRegistry Items;
+
+	TArray<FGameplayTraceEvent> Events;
+
+	int32 InventorySize;
+
+	int32 MaxStackSize;
+
+	float WeightLimit;
+};
+
+
+/* What a replay produced, the behaviour fields must match a baseline exactly and the time per event may only grow by a tolerance */
+struct FGameplayReplayResult
+{
+public:
+
+	FGameplayReplayResult()
+	{
+		NumEvents = 0;
+		InventoryDigest = 0;
+		SpellDigest = 0;
+		LeftoverQuantity = 0;
+		NumLeftovers = 0;
+		NumDamageTicks = 0;
+		TotalDamage = 0.0;
+		NanosecondsPerEvent = 0.0;
+	}
+
+	FString ToJSON() const;
+
+	// Reads a baseline written by ToJSON()
+	bool FromJSON(const FString& JSON);
+
+	int32 NumEvents;
+
+	uint32 InventoryDigest;
+
+	uint32 SpellDigest;
+
+	int32 LeftoverQuantity; // quantity of ADD events that did not fit and stayed in its pickup, the same as AddItemtoInventoryByID
+
+	int32 NumLeftovers; // ADD events that did not fit completely
+
+	int32 NumDamageTicks;
+
+	double TotalDamage;
+
+	double NanosecondsPerEvent; // fastest of all iterations, the least noisy number to compare
+};
+
+
+/* Feeds a trace through FInventorySimulation and FSpellSimulation, no World or engine module is needed */
+/* Run from the console with Gameplay.Replay <Trace> [Baseline] [-update] [-iterations=N] [-tolerance=0.2] */
+/* The Gameplay.Replay.Baseline automation test replays every trace in the project's Tests/GameplayReplay folder and fails on a difference */
+class FGameplayReplay
+{
+public:
+
+	// Replays the whole trace Iterations times from an empty state, every iteration produces the same result
+	static FGameplayReplayResult Run(const FGameplayTrace& Trace, int32 Iterations);
+
+	// Returns false if the behaviour differs from Baseline or the time per event grew by more than TimeTolerance (0.2 is 20%)
+	static bool CompareToBaseline(const FGameplayReplayResult& Result, const FGameplayReplayResult& Baseline, double TimeTolerance, FString& OutReport);
+};
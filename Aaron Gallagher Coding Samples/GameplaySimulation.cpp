@@ -0,0 +1,558 @@
+/* Aaron Gallagher's Gameplay Code Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Inventory */
+
+// No registry, nothing can be added until Configure gives it one
+template<typename PolicyType>
+TInventorySimulation<PolicyType>::TInventorySimulation()
+	: TInventorySimulation(nullptr, 0, 1, 0.f)
+{
+}
+
+template<typename PolicyType>
+TInventorySimulation<PolicyType>::TInventorySimulation(const FItemDefinitionRegistry* InRegistry, int32 InInventorySize, int32 InMaxStackSize, float InWeightLimit, const PolicyType& InPolicy)
+{
+	Policy = InPolicy;
+	Listener = nullptr;
+	DroppedQuantity = 0;
+	NumDrops = 0;
+	bRecordDrops = false;
+	Configure(InRegistry, InInventorySize, InMaxStackSize, InWeightLimit);
+}
+
+// Changes the registry and limits, the Inventory is kept and its caches rebuilt, a static layout is padded to InInventorySize empty slots
+// The component calls this once its properties are loaded, they are not known yet when it is constructed
+template<typename PolicyType>
+void TInventorySimulation<PolicyType>::Configure(const FItemDefinitionRegistry* InRegistry, int32 InInventorySize, int32 InMaxStackSize, float InWeightLimit)
+{
+	Registry = InRegistry;
+	InventorySize = InInventorySize;
+	MaxStackSize = FMath::Max(InMaxStackSize, 1);
+	WeightLimit = InWeightLimit;
+	Encumbrance.SetWeightLimit(InWeightLimit);
+	RebuildCaches();
+}
+
+// Starts from a copy of an existing Inventory instead of an empty one
+template<typename PolicyType>
+void TInventorySimulation<PolicyType>::Reset(const TArray<FInventoryElement>& InInventory)
+{
+	Inventory = InInventory;
+	DroppedQuantity = 0;
+	NumDrops = 0;
+	Drops.Reset();
+	RebuildCaches();
+}
+
+// Part of Quantity that AddItem would add, so claiming it from a pickup leaves the rest in the pickup
+template<typename PolicyType>
+int32 TInventorySimulation<PolicyType>::GetRoomForItem(FItemDefinitionHandle Handle, int32 Quantity) const
+{
+	if (!Registry || !Registry->IsValidHandle(Handle) || Quantity <= 0) return 0;
+	const FInventoryItem& ItemToAdd = Registry->Get(Handle);
+	Quantity = GetQuantityUnderWeightLimit(ItemToAdd, Quantity);
+	if (!ItemToAdd.bIsStackable) return FMath::Clamp(GetFreeSlotCount(), 0, Quantity);
+	const int32 Index = StackIndex.FindOpenStack(Handle);
+	const int32 StackQuantity = (Index != INDEX_NONE) ? Inventory[Index].Quantity : MaxStackSize;
+	return Quantity - FInventoryStackDistribution::Compute(StackQuantity, Quantity, MaxStackSize, GetFreeSlotCount()).Leftover;
+}
+
+// Same rules as AddItemtoInventoryByID, tops up the first open stack and spills into new stacks, an unstackable item gets one element per unit
+// Only the part that fits is added, the rest is returned for the caller to leave where it came from or to drop
+template<typename PolicyType>
+int32 TInventorySimulation<PolicyType>::AddItem(FItemDefinitionHandle Handle, int32 Quantity, const FCharacterStats* ModifiedStats)
+{
+	if (!Registry || !Registry->IsValidHandle(Handle) || Quantity <= 0) return 0;
+	const FInventoryItem& ItemToAdd = Registry->Get(Handle);
+	if (!ItemToAdd.bIsStackable) return AddUnstackable(Handle, ItemToAdd, Quantity, ModifiedStats);
+
+	const int32 Index = StackIndex.FindOpenStack(Handle);
+	return ((Index != INDEX_NONE) ? AddToStack(Index, Quantity) : AddNewStacks(Handle, Quantity)).Leftover;
+}
+
+// Same as AddItem but fills every open stack before starting new ones, the order transactions fill stacks in
+template<typename PolicyType>
+int32 TInventorySimulation<PolicyType>::AddItemFillingStacks(FItemDefinitionHandle Handle, int32 Quantity, const FCharacterStats* ModifiedStats)
+{
+	if (!Registry || !Registry->IsValidHandle(Handle) || Quantity <= 0) return 0;
+	const FInventoryItem& ItemToAdd = Registry->Get(Handle);
+	if (!ItemToAdd.bIsStackable) return AddUnstackable(Handle, ItemToAdd, Quantity, ModifiedStats);
+
+	const int32 OverLimit = Quantity - GetQuantityUnderWeightLimit(ItemToAdd, Quantity);
+	Quantity -= OverLimit;
+	int32 Index = StackIndex.FindOpenStack(Handle);
+	while ((Quantity > 0) && (Index != INDEX_NONE))
+	{
+		const int32 Added = FMath::Min(MaxStackSize - Inventory[Index].Quantity, Quantity);
+		Inventory[Index].Quantity += Added;
+		StackIndex.OnSlotChanged(Inventory[Index], ItemToAdd, Index); // a full stack leaves the open stacks, so the next search moves on
+		Encumbrance.ApplyDelta(ItemToAdd, Added);
+		if (Listener) Listener->OnInventorySlotChanged(Index);
+		Quantity -= Added;
+		Index = StackIndex.FindOpenStack(Handle);
+	}
+	return OverLimit + ((Quantity > 0) ? AddNewStacks(Handle, Quantity).Leftover : 0);
+}
+
+// Tops up the stack at Index and spills into new stacks, the number of full stacks and the remainder are worked out up front
+template<typename PolicyType>
+FInventoryStackDistribution TInventorySimulation<PolicyType>::AddToStack(int32 Index, int32 Quantity)
+{
+	if (!Registry || !Inventory.IsValidIndex(Index) || Quantity <= 0) return FInventoryStackDistribution();
+	const FItemDefinitionHandle Handle = Inventory[Index].Handle;
+	const FInventoryItem& ItemToAdd = Registry->Get(Handle);
+	if (!ItemToAdd.bIsStackable) return FInventoryStackDistribution();
+
+	const int32 QuantityToAdd = GetQuantityUnderWeightLimit(ItemToAdd, Quantity);
+	FInventoryStackDistribution Result = FInventoryStackDistribution::Compute(Inventory[Index].Quantity, QuantityToAdd, MaxStackSize, GetFreeSlotCount());
+	Result.Leftover += Quantity - QuantityToAdd;
+	Result.StackIndex = Index;
+	Encumbrance.ApplyDelta(ItemToAdd, Result.StackQuantity - Inventory[Index].Quantity);
+	Inventory[Index].Quantity = Result.StackQuantity;
+	StackIndex.OnSlotChanged(Inventory[Index], ItemToAdd, Index);
+	if (Listener) Listener->OnInventorySlotChanged(Index);
+	AddDistributedStacks(Handle, ItemToAdd, Result);
+	return Result;
+}
+
+// Starts new stacks of a stackable item without topping up an existing one, the Leftover of the result was not added
+template<typename PolicyType>
+FInventoryStackDistribution TInventorySimulation<PolicyType>::AddNewStacks(FItemDefinitionHandle Handle, int32 Quantity)
+{
+	if (!Registry || !Registry->IsValidHandle(Handle) || Quantity <= 0) return FInventoryStackDistribution();
+	const FInventoryItem& ItemToAdd = Registry->Get(Handle);
+	if (!ItemToAdd.bIsStackable) return FInventoryStackDistribution();
+
+	// With no existing stack to top up the whole quantity goes into new stacks
+	const int32 QuantityToAdd = GetQuantityUnderWeightLimit(ItemToAdd, Quantity);
+	FInventoryStackDistribution Result = FInventoryStackDistribution::Compute(MaxStackSize, QuantityToAdd, MaxStackSize, GetFreeSlotCount());
+	Result.Leftover += Quantity - QuantityToAdd;
+	Result.StackQuantity = 0;
+	AddDistributedStacks(Handle, ItemToAdd, Result);
+	return Result;
+}
+
+// Same rules as RemoveQuantityAtIndex, the element is removed once it is empty, a static layout empties its slot in place instead
+// Equipped elements are refused, the same as RemoveAndDropItemAtIndex and CommitTransaction
+template<typename PolicyType>
+bool TInventorySimulation<PolicyType>::RemoveItem(int32 Index, int32 Quantity)
+{
+	if (!Registry || !Inventory.IsValidIndex(Index) || Quantity <= 0 || Quantity > Inventory[Index].Quantity || Inventory[Index].bIsEquipped) return false;
+	const FInventoryItem& Definition = Registry->Get(Inventory[Index].Handle);
+	Encumbrance.ApplyDelta(Definition, -Quantity);
+	if (Quantity < Inventory[Index].Quantity)
+	{
+		Inventory[Index].Quantity -= Quantity;
+		StackIndex.OnSlotChanged(Inventory[Index], Definition, Index);
+		if (Listener) Listener->OnInventorySlotChanged(Index);
+		return true;
+	}
+	if (Policy.IsStatic())
+	{
+		StackIndex.OnSlotCleared(Inventory[Index].Handle, Index);
+		Inventory[Index] = FInventoryElement();
+		FreeSlots.HeapPush(Index);
+		if (Listener) Listener->OnInventorySlotChanged(Index);
+		return true;
+	}
+	if (Listener) Listener->OnInventorySlotRemoved(Index);
+	StackIndex.OnSlotRemoved(Inventory[Index].Handle, Index);
+	Inventory.RemoveAt(Index);
+	return true;
+}
+
+// The Inventory side of EquipWeapon and UnEquipWeaponFromIndex, unequipping also forgets the weapon slot
+template<typename PolicyType>
+bool TInventorySimulation<PolicyType>::SetEquipped(int32 Index, bool bIsEquipped)
+{
+	if (!Registry || !Inventory.IsValidIndex(Index)) return false;
+	const FInventoryItem& Definition = Registry->Get(Inventory[Index].Handle);
+	if (!Definition.bIsEquippable) return false;
+	Inventory[Index].bIsEquipped = bIsEquipped;
+	if (!bIsEquipped) Inventory[Index].EquipSlot = INDEX_NONE;
+	StackIndex.OnSlotChanged(Inventory[Index], Definition, Index);
+	if (Listener) Listener->OnInventorySlotChanged(Index);
+	return true;
+}
+
+// Remembers which weapon slot and equip serial the element was equipped with, neither is replicated so the listener is not told
+template<typename PolicyType>
+void TInventorySimulation<PolicyType>::SetEquipSlot(int32 Index, int32 EquipSlot, uint32 EquipSerial)
+{
+	if (!Inventory.IsValidIndex(Index)) return;
+	Inventory[Index].EquipSlot = EquipSlot;
+	Inventory[Index].EquipSerial = EquipSerial;
+}
+
+// Checks every staged add and remove against the free slots and weight limit once, the Inventory is not changed
+// Plans the quantity of every touched element the same way Commit fills them, so a transaction that passes never leaves anything over
+template<typename PolicyType>
+EInventoryTransactionResult TInventorySimulation<PolicyType>::CanCommit(const FInventoryTransaction& Transaction) const
+{
+	if (!IsBuilt()) return EInventoryTransactionResult::ITR_InvalidItem;
+
+	// Quantity each touched element will have once the transaction is applied, 0 means the element is removed
+	TMap<int32, int32> PlannedQuantities;
+	int32 SlotsFreed = 0;
+	double WeightDelta = 0.0;
+	for (const FInventoryTransactionOp& Op : Transaction.Ops)
+	{
+		if (Op.Op != EInventoryTransactionOp::ITO_Remove) continue;
+		if (!Inventory.IsValidIndex(Op.SlotIndex) || (Op.Quantity <= 0) || Inventory[Op.SlotIndex].bIsEquipped) return EInventoryTransactionResult::ITR_InvalidSlot;
+		int32& Planned = PlannedQuantities.FindOrAdd(Op.SlotIndex, Inventory[Op.SlotIndex].Quantity);
+		if (Op.Quantity > Planned) return EInventoryTransactionResult::ITR_InvalidSlot;
+		Planned -= Op.Quantity;
+		if (Planned == 0) SlotsFreed++;
+		WeightDelta -= (double)Registry->Get(Inventory[Op.SlotIndex].Handle).Weight * Op.Quantity;
+	}
+
+	// Room left in the last new stack of each item, later adds of the same item fill it before starting another
+	TMap<FItemDefinitionHandle, int32> NewStackRoom;
+	TArray<int32> OpenStacks;
+	int32 SlotsNeeded = 0;
+	for (const FInventoryTransactionOp& Op : Transaction.Ops)
+	{
+		if (Op.Op != EInventoryTransactionOp::ITO_Add) continue;
+		if (Op.Quantity <= 0) return EInventoryTransactionResult::ITR_InvalidItem;
+		const FItemDefinitionHandle Handle = Registry->FindHandle(Op.ItemID);
+		if (!Handle.IsValid()) return EInventoryTransactionResult::ITR_InvalidItem;
+		const FInventoryItem& Definition = Registry->Get(Handle);
+		WeightDelta += (double)Definition.Weight * Op.Quantity;
+		if (!Definition.bIsStackable)
+		{
+			SlotsNeeded += Op.Quantity;
+			continue;
+		}
+
+		// Existing elements with room once the removes are applied, the open stacks plus any full stack that is only partly removed
+		int32 Remaining = Op.Quantity;
+		OpenStacks.Reset();
+		StackIndex.GetOpenStacks(Handle, OpenStacks);
+		for (int32 OpenIndex : OpenStacks)
+		{
+			PlannedQuantities.FindOrAdd(OpenIndex, Inventory[OpenIndex].Quantity);
+		}
+		for (TPair<int32, int32>& Planned : PlannedQuantities)
+		{
+			const FInventoryElement& Element = Inventory[Planned.Key];
+			if ((Element.Handle != Handle) || Element.bIsEquipped || (Planned.Value == 0)) continue;
+			const int32 Added = FMath::Clamp(MaxStackSize - Planned.Value, 0, Remaining);
+			Planned.Value += Added;
+			Remaining -= Added;
+			if (Remaining == 0) break;
+		}
+
+		int32& Room = NewStackRoom.FindOrAdd(Handle);
+		const int32 Shared = FMath::Min(Room, Remaining);
+		Room -= Shared;
+		Remaining -= Shared;
+		if (Remaining > 0)
+		{
+			const int32 NumNewStacks = FMath::DivideAndRoundUp(Remaining, MaxStackSize);
+			SlotsNeeded += NumNewStacks;
+			Room = (NumNewStacks * MaxStackSize) - Remaining;
+		}
+	}
+
+	if (SlotsNeeded > GetFreeSlotCount() + SlotsFreed) return EInventoryTransactionResult::ITR_NotEnoughSpace;
+	if (!Transaction.bAllowOverweight && (WeightDelta > 0.0) && (WeightLimit > 0.f) && (Encumbrance.GetTotalWeight() + WeightDelta > WeightLimit))
+	{
+		return EInventoryTransactionResult::ITR_Overweight;
+	}
+	return EInventoryTransactionResult::ITR_Committed;
+}
+
+// Applies every op of a transaction that passes CanCommit, removes first, highest element first
+template<typename PolicyType>
+EInventoryTransactionResult TInventorySimulation<PolicyType>::Commit(const FInventoryTransaction& Transaction)
+{
+	const EInventoryTransactionResult Result = CanCommit(Transaction);
+	if (Result != EInventoryTransactionResult::ITR_Committed) return Result; // nothing has been changed yet, so there is nothing to roll back
+
+	// Removes go first so their slots are free for the adds, highest element first so the staged indices stay valid
+	TMap<int32, int32> RemovedQuantities;
+	for (const FInventoryTransactionOp& Op : Transaction.Ops)
+	{
+		if (Op.Op == EInventoryTransactionOp::ITO_Remove) RemovedQuantities.FindOrAdd(Op.SlotIndex) += Op.Quantity;
+	}
+	RemovedQuantities.KeySort(TGreater<int32>());
+	for (const TPair<int32, int32>& Removed : RemovedQuantities)
+	{
+		RemoveItem(Removed.Key, Removed.Value);
+	}
+
+	for (const FInventoryTransactionOp& Op : Transaction.Ops)
+	{
+		if (Op.Op != EInventoryTransactionOp::ITO_Add) continue;
+		AddItemFillingStacks(Registry->FindHandle(Op.ItemID), Op.Quantity, Op.bIsModifiedItem ? &Op.ModifiedStats : nullptr);
+	}
+	return EInventoryTransactionResult::ITR_Committed;
+}
+
+// Resizes the Inventory to Num elements, new elements are empty, used by clients mirroring the server and nothing else
+template<typename PolicyType>
+void TInventorySimulation<PolicyType>::SetNum(int32 Num)
+{
+	if (!Registry) return;
+	while (Inventory.Num() > FMath::Max(Num, 0))
+	{
+		const int32 Index = Inventory.Num() - 1;
+		if (Listener) Listener->OnInventorySlotRemoved(Index);
+		Encumbrance.ApplyDelta(Registry->Get(Inventory[Index].Handle), -Inventory[Index].Quantity);
+		StackIndex.OnSlotRemoved(Inventory[Index].Handle, Index);
+		if (Policy.IsStatic() && !Inventory[Index].Handle.IsValid()) FreeSlots.RemoveSingle(Index);
+		Inventory.Pop(false);
+	}
+	while (Inventory.Num() < Num)
+	{
+		const int32 Index = AddElement(FItemDefinitionHandle(), Registry->Get(FItemDefinitionHandle()), 0);
+		if (Policy.IsStatic()) FreeSlots.Add(Index);
+	}
+	if (Policy.IsStatic()) FreeSlots.Heapify();
+}
+
+// Replaces the element at Index, used by clients applying a delta and nothing else
+template<typename PolicyType>
+void TInventorySimulation<PolicyType>::SetElement(int32 Index, const FInventoryElement& Element)
+{
+	if (!Registry || !Inventory.IsValidIndex(Index)) return;
+	Encumbrance.ApplyDelta(Registry->Get(Inventory[Index].Handle), -Inventory[Index].Quantity);
+	if (Inventory[Index].Handle.IsValid()) StackIndex.OnSlotCleared(Inventory[Index].Handle, Index);
+	if (Policy.IsStatic() && (Inventory[Index].Handle.IsValid() != Element.Handle.IsValid()))
+	{
+		// Only a static layout keeps empty slots, clients rarely fill or empty one so the heap is rebuilt rather than patched
+		if (Element.Handle.IsValid()) FreeSlots.RemoveSingle(Index);
+		else FreeSlots.Add(Index);
+		FreeSlots.Heapify();
+	}
+
+	Inventory[Index] = Element;
+	const FInventoryItem& Definition = Registry->Get(Element.Handle);
+	Encumbrance.ApplyDelta(Definition, Element.Quantity);
+	if (Element.Handle.IsValid()) StackIndex.OnSlotFilled(Element, Definition, Index);
+	if (Listener) Listener->OnInventorySlotChanged(Index);
+}
+
+// Total quantity of an item across every element
+template<typename PolicyType>
+int32 TInventorySimulation<PolicyType>::CountItem(FItemDefinitionHandle Handle) const
+{
+	int32 Count = 0;
+	for (const FInventoryElement& Element : Inventory)
+	{
+		if (Element.Handle == Handle) Count += Element.Quantity;
+	}
+	return Count;
+}
+
+// Moves the Inventory out, the simulation is empty afterwards
+template<typename PolicyType>
+void TInventorySimulation<PolicyType>::TakeInventory(TArray<FInventoryElement>& OutInventory)
+{
+	OutInventory = MoveTemp(Inventory);
+	Inventory.Reset();
+	RebuildCaches();
+}
+
+// Hash of the ID, quantity and equipped state of every element in order, equal digests mean equal Inventories
+// Built from the ID's string so digests match between runs, FName indices depend on load order
+template<typename PolicyType>
+uint32 TInventorySimulation<PolicyType>::GetDigest() const
+{
+	uint32 Digest = GetTypeHash(Inventory.Num());
+	for (const FInventoryElement& Element : Inventory)
+	{
+		const FName ItemID = Registry ? Registry->Get(Element.Handle).ItemID : NAME_None;
+		Digest = HashCombine(Digest, FCrc::StrCrc32(*ItemID.ToString()));
+		Digest = HashCombine(Digest, GetTypeHash(Element.Quantity));
+		Digest = HashCombine(Digest, GetTypeHash(Element.bIsEquipped));
+	}
+	return HashCombine(Digest, GetTypeHash(Encumbrance.IsOverweight()));
+}
+
+// Places the new stacks described by Distribution, a dynamic layout grows the Inventory at most once
+// A static layout fills the lowest empty slots, which are not contiguous, so FirstNewIndex is left unset
+template<typename PolicyType>
+void TInventorySimulation<PolicyType>::AddDistributedStacks(FItemDefinitionHandle Handle, const FInventoryItem& Definition, FInventoryStackDistribution& Distribution)
+{
+	const int32 NumNewStacks = Distribution.GetNumNewStacks();
+	if (NumNewStacks <= 0) return;
+
+	if (!Policy.IsStatic())
+	{
+		Distribution.FirstNewIndex = Inventory.Num();
+		if (Inventory.Max() < Inventory.Num() + NumNewStacks)
+		{
+			INC_DWORD_STAT(STAT_InventoryAllocations);
+			Inventory.Reserve(Inventory.Num() + NumNewStacks);
+		}
+	}
+	for (int32 i = 0; i < NumNewStacks; i++)
+	{
+		PlaceElement(Handle, Definition, (i < Distribution.NumFullStacks) ? MaxStackSize : Distribution.Remainder);
+	}
+}
+
+// One element per unit, ModifiedStats are set on each when given, returns the quantity that did not fit
+template<typename PolicyType>
+int32 TInventorySimulation<PolicyType>::AddUnstackable(FItemDefinitionHandle Handle, const FInventoryItem& Definition, int32 Quantity, const FCharacterStats* ModifiedStats)
+{
+	const int32 QuantityToAdd = GetQuantityUnderWeightLimit(Definition, Quantity);
+	int32 Leftover = QuantityToAdd;
+	while ((Leftover > 0) && !IsInventoryFull()) // AddItemtoInventoryByID_Validate rejects the add when the Inventory is already full
+	{
+		const int32 Index = PlaceElement(Handle, Definition, 1);
+		if (ModifiedStats)
+		{
+			Inventory[Index].ModifiedStats = *ModifiedStats;
+			Inventory[Index].bIsModifiedItem = true;
+			Inventory[Index].bHaveStatsBeenSet = true;
+			if (Listener) Listener->OnInventorySlotChanged(Index);
+		}
+		--Leftover;
+	}
+	return Leftover + (Quantity - QuantityToAdd);
+}
+
+// Appends to a dynamic layout, fills the lowest empty slot of a static one, returns the element's index
+template<typename PolicyType>
+int32 TInventorySimulation<PolicyType>::PlaceElement(FItemDefinitionHandle Handle, const FInventoryItem& Definition, int32 Quantity)
+{
+	if (!Policy.IsStatic()) return AddElement(Handle, Definition, Quantity);
+
+	int32 Index = INDEX_NONE;
+	FreeSlots.HeapPop(Index, false);
+	Inventory[Index] = FInventoryElement(Handle, Quantity);
+	StackIndex.OnSlotFilled(Inventory[Index], Definition, Index);
+	Encumbrance.ApplyDelta(Definition, Quantity);
+	if (Listener) Listener->OnInventorySlotChanged(Index);
+	return Index;
+}
+
+template<typename PolicyType>
+int32 TInventorySimulation<PolicyType>::AddElement(FItemDefinitionHandle Handle, const FInventoryItem& Definition, int32 Quantity)
+{
+	if (Inventory.Num() == Inventory.Max()) INC_DWORD_STAT(STAT_InventoryAllocations);
+	const int32 Index = Inventory.Emplace(Handle, Quantity);
+	StackIndex.OnSlotAdded(Inventory[Index], Definition, Index);
+	Encumbrance.ApplyDelta(Definition, Quantity);
+	if (Listener) Listener->OnInventorySlotAdded(Index);
+	return Index;
+}
+
+// Largest part of Quantity that keeps the Inventory at or under the weight limit, a limit of 0 has no limit
+// Only the DropOverweight rule limits an add, for every other rule this folds away to Quantity
+template<typename PolicyType>
+int32 TInventorySimulation<PolicyType>::GetQuantityUnderWeightLimit(const FInventoryItem& Definition, int32 Quantity) const
+{
+	if ((Policy.GetWeightRule() != EInventoryWeightRule::DropOverweight) || (WeightLimit <= 0.f) || (Definition.Weight <= 0.f)) return Quantity;
+	const double Room = (double)WeightLimit - Encumbrance.GetTotalWeight();
+	int32 Allowed = (int32)FMath::Clamp(FMath::FloorToDouble(Room / Definition.Weight), 0.0, (double)Quantity);
+	if ((Allowed > 0) && (Encumbrance.GetTotalWeight() + ((double)Definition.Weight * Allowed) > WeightLimit)) --Allowed; // rounding in the division
+	return Allowed;
+}
+
+// Without a registry nothing can be added, removed or equipped and the Inventory is handed back as it was given
+// A static layout is padded to InventorySize empty slots first, so the empty slots have positions in the stack index
+template<typename PolicyType>
+void TInventorySimulation<PolicyType>::RebuildCaches()
+{
+	if (!Registry) return;
+	FreeSlots.Reset();
+	if (Policy.IsStatic())
+	{
+		if (Inventory.Num() < InventorySize) Inventory.SetNum(InventorySize);
+		for (int32 i = 0; i < Inventory.Num(); i++)
+		{
+			if (!Inventory[i].Handle.IsValid()) FreeSlots.Add(i); // ascending order is already a valid min-heap
+		}
+	}
+	StackIndex.Rebuild(Inventory, *Registry, MaxStackSize);
+	Encumbrance.Rebuild(Inventory, *Registry);
+}
+
+// Stands in for DropItemAtLocation, the quantity is counted and recorded if drops are being recorded
+// AddItem never drops, callers with nowhere to leave what did not fit drop it through here
+template<typename PolicyType>
+void TInventorySimulation<PolicyType>::DropItem(FItemDefinitionHandle Handle, int32 Quantity)
+{
+	if (Quantity <= 0) return;
+	DroppedQuantity += Quantity;
+	NumDrops++;
+	if (bRecordDrops) Drops.Add({ Handle, Quantity });
+}
+
+// The policies the Inventory Component can be built with, and the runtime flags the policy benchmark measures them against
+template class TInventorySimulation<FDynamicInventoryPolicy>;
+template class TInventorySimulation<FStaticInventoryPolicy>;
+template class TInventorySimulation<FWeightCappedInventoryPolicy>;
+template class TInventorySimulation<FInventoryRuntimePolicy>;
+
+
+/* Spells */
+
+// Same rules as ADamageOverTimeSpellBase::OnSpellOverlap, the caster never hits itself and only the first other character overlapped is hit
+// Returns the effect ID, or INDEX_NONE if nothing was hit
+int32 FSpellSimulation::DotHit(int32 CasterID, const TArray<int32>& OverlappedIDs, float Amount, float Interval, float Duration, double Now)
+{
+	for (int32 TargetID : OverlappedIDs)
+	{
+		if (TargetID == CasterID) continue;
+		const int32 ContextIndex = TargetsByContext.Add(TargetID);
+		return Scheduler.Schedule(ContextIndex, Amount, Interval, Duration, Now);
+	}
+	return INDEX_NONE;
+}
+
+// Damages TargetID every Interval seconds until EndChannel is called for the caster
+int32 FSpellSimulation::BeginChannel(int32 CasterID, int32 TargetID, float Amount, float Interval, double Now)
+{
+	if (TargetID == CasterID) return INDEX_NONE;
+	const float UntilEndChannel = 1.0e9f;
+	const int32 ContextIndex = TargetsByContext.Add(TargetID);
+	const int32 EffectID = Scheduler.Schedule(ContextIndex, Amount, Interval, UntilEndChannel, Now);
+	ChannelEffectsByCaster.Add(CasterID, EffectID);
+	return EffectID;
+}
+
+// Same as AChannelSpellBase::EndCasting, stops every channel the caster started
+void FSpellSimulation::EndChannel(int32 CasterID)
+{
+	TArray<int32> EffectIDs;
+	ChannelEffectsByCaster.MultiFind(CasterID, EffectIDs);
+	for (int32 EffectID : EffectIDs)
+	{
+		Scheduler.Cancel(EffectID);
+	}
+	ChannelEffectsByCaster.Remove(CasterID);
+}
+
+// Applies every damage tick due at or before Now
+void FSpellSimulation::Advance(double Now)
+{
+	PendingEvents.Reset();
+	Scheduler.Advance(Now, PendingEvents);
+	for (const FDamageOverTimeEvent& Event : PendingEvents)
+	{
+		DamageByTarget.FindOrAdd(TargetsByContext[Event.ContextIndex]) += Event.Amount;
+		TotalDamage += Event.Amount;
+		NumDamageTicks++;
+	}
+}
+
+// Hash of the damage dealt to every target in target order
+uint32 FSpellSimulation::GetDigest() const
+{
+	TArray<int32> TargetIDs;
+	DamageByTarget.GenerateKeyArray(TargetIDs);
+	TargetIDs.Sort();
+	uint32 Digest = GetTypeHash(NumDamageTicks);
+	for (int32 TargetID : TargetIDs)
+	{
+		Digest = HashCombine(Digest, GetTypeHash(TargetID));
+		Digest = HashCombine(Digest, GetTypeHash((int64)FMath::RoundToDouble(DamageByTarget[TargetID] * 1000.0))); // damage to a thousandth, sums of floats are not bit exact across compilers
+	}
+	return Digest;
+}
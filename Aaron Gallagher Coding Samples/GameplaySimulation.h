@@ -0,0 +1,237 @@
+#pragma once
+/* Aaron Gallagher's Gameplay Code Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* A quantity dropped through FInventorySimulation::DropItem, DropItemAtLocation spawns it when the result is merged back into a component */
+struct FInventorySimulationDrop
+{
+	FItemDefinitionHandle Handle;
+
+	int32 Quantity;
+};
+
+
+/* Told about every change TInventorySimulation makes to a single element, the Inventory Component keeps its query index and replicated slots in sync through it */
+/* Reset and TakeInventory replace the whole Inventory and are not reported */
+class IInventoryChangeListener
+{
+public:
+
+	virtual ~IInventoryChangeListener() {}
+
+	// Called after a new element is added to the end of the Inventory
+	virtual void OnInventorySlotAdded(int32 Index) = 0;
+
+	// Called after the Quantity or state of an element changes, or the element is replaced
+	// A static layout reports filling and emptying a slot through here, its slots are never added or removed
+	virtual void OnInventorySlotChanged(int32 Index) = 0;
+
+	// Called before an element is removed from the Inventory, every element after Index moves down by one
+	virtual void OnInventorySlotRemoved(int32 Index) = 0;
+};
+
+
+/* The Inventory Component's add, remove, equip and transaction rules, Core-only so replays, benchmarks and batched jobs run them without a World */
+/* UInventoryComponent owns one and makes every change through it, the component only adds pickups, drops, weapons and replication around the calls */
+/* The layout and weight rule come from PolicyType, see InventoryPolicy.h, item flags are read once per add instead of inside the loops that place the stacks */
+template<typename PolicyType>
+class TInventorySimulation
+{
+public:
+
+	// No registry, nothing can be added until Configure gives it one
+	TInventorySimulation();
+
+	TInventorySimulation(const FItemDefinitionRegistry* InRegistry, int32 InInventorySize, int32 InMaxStackSize, float InWeightLimit, const PolicyType& InPolicy = PolicyType());
+
+	// Changes the registry and limits, the Inventory is kept and its caches rebuilt, a static layout is padded to InInventorySize empty slots
+	// The component calls this once its properties are loaded, they are not known yet when it is constructed
+	void Configure(const FItemDefinitionRegistry* InRegistry, int32 InInventorySize, int32 InMaxStackSize, float InWeightLimit);
+
+	// Returns true if the over weight state changed
+	bool SetWeightLimit(float InWeightLimit) { WeightLimit = InWeightLimit; return Encumbrance.SetWeightLimit(InWeightLimit); }
+
+	void SetListener(IInventoryChangeListener* InListener) { Listener = InListener; }
+
+	// Starts from a copy of an existing Inventory instead of an empty one
+	void Reset(const TArray<FInventoryElement>& InInventory);
+
+	// Part of Quantity that AddItem would add, so claiming it from a pickup leaves the rest in the pickup
+	int32 GetRoomForItem(FItemDefinitionHandle Handle, int32 Quantity) const;
+
+	// Same rules as AddItemtoInventoryByID, tops up the first open stack and spills into new stacks, an unstackable item gets one element per unit
+	// Only the part that fits is added, the rest is returned for the caller to leave where it came from or to drop
+	// ModifiedStats, when given, are set on every new element of an unstackable item
+	int32 AddItem(FItemDefinitionHandle Handle, int32 Quantity, const FCharacterStats* ModifiedStats = nullptr);
+
+	// Same as AddItem but fills every open stack before starting new ones, the order transactions fill stacks in
+	int32 AddItemFillingStacks(FItemDefinitionHandle Handle, int32 Quantity, const FCharacterStats* ModifiedStats = nullptr);
+
+	// Tops up the stack at Index and spills into new stacks, the Leftover of the result was not added
+	FInventoryStackDistribution AddToStack(int32 Index, int32 Quantity);
+
+	// Starts new stacks of a stackable item without topping up an existing one, the Leftover of the result was not added
+	FInventoryStackDistribution AddNewStacks(FItemDefinitionHandle Handle, int32 Quantity);
+
+	// Same rules as RemoveQuantityAtIndex, the element is removed once it is empty, a static layout empties its slot in place instead
+	// Equipped elements are refused, the same as RemoveAndDropItemAtIndex and CommitTransaction
+	bool RemoveItem(int32 Index, int32 Quantity);
+
+	// The Inventory side of EquipWeapon and UnEquipWeaponFromIndex, unequipping also forgets the weapon slot
+	bool SetEquipped(int32 Index, bool bIsEquipped);
+
+	// Remembers which weapon slot and equip serial the element was equipped with
+	void SetEquipSlot(int32 Index, int32 EquipSlot, uint32 EquipSerial);
+
+	// Checks every staged add and remove against the free slots and weight limit once, the Inventory is not changed
+	// Every added Item ID must already have a handle, FindHandle is used and never loads a definition
+	EInventoryTransactionResult CanCommit(const FInventoryTransaction& Transaction) const;
+
+	// Applies every op of a transaction that passes CanCommit, removes first, highest element first
+	EInventoryTransactionResult Commit(const FInventoryTransaction& Transaction);
+
+	// Resizes the Inventory to Num elements, new elements are empty, used by clients mirroring the server and nothing else
+	void SetNum(int32 Num);
+
+	// Replaces the element at Index, used by clients applying a delta and nothing else
+	void SetElement(int32 Index, const FInventoryElement& Element);
+
+	// Stands in for DropItemAtLocation, the quantity is counted and recorded if drops are being recorded
+	// AddItem never drops, callers with nowhere to leave what did not fit drop it through here
+	void DropItem(FItemDefinitionHandle Handle, int32 Quantity);
+
+	// Total quantity of an item across every element
+	int32 CountItem(FItemDefinitionHandle Handle) const;
+
+	// Moves the Inventory out, the simulation is empty afterwards
+	void TakeInventory(TArray<FInventoryElement>& OutInventory);
+
+	// Hash of the ID, quantity and equipped state of every element in order, equal digests mean equal Inventories
+	uint32 GetDigest() const;
+
+	const TArray<FInventoryElement>& GetInventory() const { return Inventory; }
+
+	int32 GetFreeSlotCount() const { return Policy.IsStatic() ? FreeSlots.Num() : FMath::Max(InventorySize - Inventory.Num(), 0); }
+
+	bool IsBuilt() const { return (Registry != nullptr) && StackIndex.IsBuilt(); }
+
+	// Called when the owner's limits changed, the next Configure rebuilds the caches
+	void Invalidate() { StackIndex.Invalidate(); Encumbrance.Invalidate(); }
+
+	const FItemDefinitionRegistry* GetRegistry() const { return Registry; }
+
+	const FInventoryEncumbrance& GetEncumbrance() const { return Encumbrance; }
+
+	int32 GetDroppedQuantity() const { return DroppedQuantity; }
+
+	int32 GetNumDrops() const { return NumDrops; }
+
+	// Every drop in the order it happened, only kept after SetRecordDrops(true)
+	const TArray<FInventorySimulationDrop>& GetDrops() const { return Drops; }
+
+	void SetRecordDrops(bool bInRecordDrops) { bRecordDrops = bInRecordDrops; }
+
+private:
+
+	// Appends the new stacks described by Distribution, growing the Inventory at most once
+	void AddDistributedStacks(FItemDefinitionHandle Handle, const FInventoryItem& Definition, FInventoryStackDistribution& Distribution);
+
+	// One element per unit, ModifiedStats are set on each when given, returns the quantity that did not fit
+	int32 AddUnstackable(FItemDefinitionHandle Handle, const FInventoryItem& Definition, int32 Quantity, const FCharacterStats* ModifiedStats);
+
+	// Appends to a dynamic layout, fills the lowest empty slot of a static one, returns the element's index
+	int32 PlaceElement(FItemDefinitionHandle Handle, const FInventoryItem& Definition, int32 Quantity);
+
+	// Appends a new element whatever the layout, clients mirroring the server use it to grow the Inventory
+	int32 AddElement(FItemDefinitionHandle Handle, const FInventoryItem& Definition, int32 Quantity);
+
+	// Part of Quantity the weight rule lets an add place, the rest is handed back with the leftover
+	int32 GetQuantityUnderWeightLimit(const FInventoryItem& Definition, int32 Quantity) const;
+
+	// Without a registry nothing can be added, removed or equipped and the Inventory is handed back as it was given
+	void RebuildCaches();
+
+	bool IsInventoryFull() const { return GetFreeSlotCount() == 0; }
+
+	const FItemDefinitionRegistry* Registry;
+
+	PolicyType Policy;
+
+	IInventoryChangeListener* Listener;
+
+	TArray<FInventoryElement> Inventory; // empty slots of a static layout hold an invalid handle
+
+	TArray<int32> FreeSlots; // min-heap of the empty slots of a static layout, unused by a dynamic one
+
+	FInventoryStackIndex StackIndex;
+
+	FInventoryEncumbrance Encumbrance;
+
+	int32 InventorySize;
+
+	int32 MaxStackSize;
+
+	float WeightLimit;
+
+	int32 DroppedQuantity;
+
+	int32 NumDrops;
+
+	TArray<FInventorySimulationDrop> Drops;
+
+	bool bRecordDrops;
+};
+
+// The rules the Inventory Component runs with in this build, replays and batched jobs use the same ones
+typedef TInventorySimulation<FInventoryComponentPolicy> FInventorySimulation;
+
+
+/* The damage over time and channel spell hit rules without a World, characters are plain integer IDs */
+/* Damage ticks come from the same FDamageOverTimeScheduler the World's damage over time subsystem uses */
+class FSpellSimulation
+{
+public:
+
+	FSpellSimulation()
+	{
+		TotalDamage = 0.0;
+		NumDamageTicks = 0;
+	}
+
+	// Same rules as ADamageOverTimeSpellBase::OnSpellOverlap, the caster never hits itself and only the first other character overlapped is hit
+	// Returns the effect ID, or INDEX_NONE if nothing was hit
+	int32 DotHit(int32 CasterID, const TArray<int32>& OverlappedIDs, float Amount, float Interval, float Duration, double Now);
+
+	// Damages TargetID every Interval seconds until EndChannel is called for the caster
+	int32 BeginChannel(int32 CasterID, int32 TargetID, float Amount, float Interval, double Now);
+
+	// Same as AChannelSpellBase::EndCasting, stops every channel the caster started
+	void EndChannel(int32 CasterID);
+
+	// Applies every damage tick due at or before Now
+	void Advance(double Now);
+
+	// Hash of the damage dealt to every target in target order
+	uint32 GetDigest() const;
+
+	double GetTotalDamage() const { return TotalDamage; }
+
+	int32 GetNumDamageTicks() const { return NumDamageTicks; }
+
+private:
+
+	FDamageOverTimeScheduler Scheduler;
+
+	TArray<int32> TargetsByContext; // FDamageOverTimeEvent::ContextIndex is an index into this
+
+	TMultiMap<int32, int32> ChannelEffectsByCaster;
+
+	TMap<int32, double> DamageByTarget;
+
+	TArray<FDamageOverTimeEvent> PendingEvents; // reused by Advance()
+
+	double TotalDamage;
+
+	int32 NumDamageTicks;
+};
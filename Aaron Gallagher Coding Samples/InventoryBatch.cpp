@@ -0,0 +1,219 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunInventoryBatchBenchmark(const TArray<FString>& Args);
+
+// Inventory.BatchBench <Inventories> <CommandsPerInventory>, times the same batch on 1 to 32 workers
+static FAutoConsoleCommandWithArgs GInventoryBatchBenchCommand(
+	TEXT("Inventory.BatchBench"),
+	TEXT("Inventory.BatchBench <Inventories> <CommandsPerInventory>: times a batch of inventory commands on 1 to 32 workers against the serial run"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunInventoryBatchBenchmark));
+#endif
+
+// Loot tables are kept by Reset(), the index can be used by every later batch
+int32 FInventoryBatch::AddLootTable(const TArray<FInventoryLootEntry>& Entries)
+{
+	FLootTable& LootTable = LootTables.AddDefaulted_GetRef();
+	LootTable.TotalWeight = 0;
+	for (const FInventoryLootEntry& Entry : Entries)
+	{
+		if (Entry.Weight <= 0) continue;
+		LootTable.Entries.Add(Entry);
+		LootTable.TotalWeight += Entry.Weight;
+	}
+	return LootTables.Num() - 1;
+}
+
+// Adds one Inventory to the batch, returns the partition its commands are added to
+int32 FInventoryBatch::AddPartition(FInventorySimulation&& Simulation)
+{
+	return Partitions.Emplace(MoveTemp(Simulation));
+}
+
+// Commands of a partition run in the order they were added
+void FInventoryBatch::AddCommand(int32 Partition, const FInventoryCommand& Command)
+{
+	if (!Partitions.IsValidIndex(Partition)) return;
+	Partitions[Partition].Commands.Add(Command);
+}
+
+// Runs every partition, NumWorkers of 1 or less runs them in order on the calling thread
+// Each worker claims the next unclaimed partition when it finishes one, so a few large Inventories do not hold up the rest
+void FInventoryBatch::Run(int32 NumWorkers)
+{
+	NumWorkers = FMath::Min(NumWorkers, Partitions.Num());
+	if (NumWorkers <= 1)
+	{
+		for (FPartition& Partition : Partitions)
+		{
+			RunPartition(Partition);
+		}
+		return;
+	}
+
+	FThreadSafeCounter NextPartition;
+	ParallelFor(NumWorkers, [this, &NextPartition](int32 WorkerIndex)
+	{
+		for (int32 Index = NextPartition.Increment() - 1; Index < Partitions.Num(); Index = NextPartition.Increment() - 1)
+		{
+			RunPartition(Partitions[Index]);
+		}
+	});
+}
+
+// Hash of every partition's Inventory and drops in partition order
+uint32 FInventoryBatch::GetDigest() const
+{
+	uint32 Digest = GetTypeHash(Partitions.Num());
+	for (const FPartition& Partition : Partitions)
+	{
+		Digest = HashCombine(Digest, Partition.Simulation.GetDigest());
+		Digest = HashCombine(Digest, GetTypeHash(Partition.Simulation.GetDroppedQuantity()));
+	}
+	return Digest;
+}
+
+void FInventoryBatch::RunPartition(FPartition& Partition) const
+{
+	FInventorySimulation& Simulation = Partition.Simulation;
+	const FItemDefinitionRegistry* Registry = Simulation.GetRegistry();
+	for (const FInventoryCommand& Command : Partition.Commands)
+	{
+		switch (Command.Op)
+		{
+		case EInventoryCommandOp::Add:
+			Simulation.DropItem(Command.Handle, Simulation.AddItem(Command.Handle, Command.Quantity)); // batched adds have no pickup to leave the rest in
+			break;
+		case EInventoryCommandOp::Remove:
+		{
+			// Skipped when an earlier command in the batch moved a different item into Slot
+			const TArray<FInventoryElement>& Inventory = Simulation.GetInventory();
+			if (!Command.Handle.IsValid() || !Inventory.IsValidIndex(Command.Slot) || (Inventory[Command.Slot].Handle != Command.Handle)) break;
+			Simulation.RemoveItem(Command.Slot, Command.Quantity);
+			break;
+		}
+		case EInventoryCommandOp::Restock:
+		{
+			if (!Registry || !Registry->IsValidHandle(Command.Handle)) break;
+			const int32 Missing = Command.Quantity - Simulation.CountItem(Command.Handle);
+			if (Missing > 0) Simulation.DropItem(Command.Handle, Simulation.AddItem(Command.Handle, Missing));
+			break;
+		}
+		case EInventoryCommandOp::RollLoot:
+		{
+			if (!LootTables.IsValidIndex(Command.LootTable) || LootTables[Command.LootTable].TotalWeight <= 0) break;
+			const FLootTable& LootTable = LootTables[Command.LootTable];
+			FRandomStream Random(Command.Seed);
+			for (int32 RollIndex = 0; RollIndex < Command.Quantity; RollIndex++)
+			{
+				int32 Roll = Random.RandHelper(LootTable.TotalWeight);
+				for (const FInventoryLootEntry& Entry : LootTable.Entries)
+				{
+					Roll -= Entry.Weight;
+					if (Roll >= 0) continue;
+					Simulation.DropItem(Entry.Handle, Simulation.AddItem(Entry.Handle, Random.RandRange(Entry.MinQuantity, Entry.MaxQuantity)));
+					break;
+				}
+			}
+			break;
+		}
+		}
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+namespace InventoryBatchBench
+{
+	// Generated items and one loot table of all of them, so the benchmark and tests run without a World or an item data table
+	int32 MakeRegistry(FItemDefinitionRegistry& Registry, FInventoryBatch& Batch)
+	{
+		TArray<FInventoryLootEntry> LootEntries;
+		for (int32 i = 0; i < 64; i++)
+		{
+			FInventoryItem Definition;
+			Definition.ItemID = FName(TEXT("BatchItem"), i);
+			Definition.bIsStackable = (i % 2) == 0;
+			Definition.Weight = 0.5f + (i % 7);
+			Definition.ItemValue = 10 + i;
+			LootEntries.Add({ Registry.Add(Definition), 1 + (i % 5), 1, Definition.bIsStackable ? 40 : 1 });
+		}
+		return Batch.AddLootTable(LootEntries);
+	}
+
+	// Queues the same random commands for every Inventory each time it is called
+	void BuildBatch(FInventoryBatch& Batch, const FItemDefinitionRegistry& Registry, int32 LootTable, int32 NumInventories, int32 CommandsPerInventory)
+	{
+		Batch.Reset();
+		for (int32 InventoryIndex = 0; InventoryIndex < NumInventories; InventoryIndex++)
+		{
+			FInventorySimulation Simulation(&Registry, 40, 99, 0.f);
+			Simulation.SetRecordDrops(true);
+			const int32 Partition = Batch.AddPartition(MoveTemp(Simulation));
+			FRandomStream Random(InventoryIndex);
+			for (int32 CommandIndex = 0; CommandIndex < CommandsPerInventory; CommandIndex++)
+			{
+				FInventoryCommand Command;
+				Command.Op = (EInventoryCommandOp)Random.RandRange(0, 3);
+				Command.Handle = FItemDefinitionHandle(Random.RandHelper(Registry.Num()));
+				Command.Slot = Random.RandHelper(40);
+				Command.Quantity = Random.RandRange(1, 60);
+				Command.LootTable = LootTable;
+				Command.Seed = (int32)Random.GetUnsignedInt();
+				Batch.AddCommand(Partition, Command);
+			}
+		}
+	}
+}
+
+// Inventory.BatchBench <Inventories> <CommandsPerInventory>, times the same batch on 1 to 32 workers
+static void RunInventoryBatchBenchmark(const TArray<FString>& Args)
+{
+	using namespace InventoryBatchBench;
+	const int32 NumInventories = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 2000;
+	const int32 CommandsPerInventory = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 64;
+	const int32 WorkerCounts[] = { 1, 2, 4, 8, 16, 32 };
+
+	FItemDefinitionRegistry Registry;
+	FInventoryBatch Batch;
+	const int32 LootTable = MakeRegistry(Registry, Batch);
+	double SerialSeconds = 0.0;
+	for (int32 NumWorkers : WorkerCounts)
+	{
+		BuildBatch(Batch, Registry, LootTable, NumInventories, CommandsPerInventory);
+		const double StartTime = FPlatformTime::Seconds();
+		Batch.Run(NumWorkers);
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+		if (NumWorkers == 1) SerialSeconds = Elapsed;
+		UE_LOG(LogTemp, Log, TEXT("Inventory.BatchBench: %d inventories x %d commands, %d workers: %.3f ms, %.2fx serial"),
+			NumInventories, CommandsPerInventory, NumWorkers, Elapsed * 1000.0, (Elapsed > 0.0) ? (SerialSeconds / Elapsed) : 0.0);
+	}
+	UE_LOG(LogTemp, Log, TEXT("Inventory.BatchBench: %d task graph worker threads, runs with more workers than that share them"), FTaskGraphInterface::Get().GetNumWorkerThreads());
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryBatchMatchesSerialTest, "Inventory.Batch.MatchesSerial", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// Partitions are independent, so every worker count must leave the same Inventories and drops as running them in order
+bool FInventoryBatchMatchesSerialTest::RunTest(const FString& Parameters)
+{
+	using namespace InventoryBatchBench;
+	FItemDefinitionRegistry Registry;
+	FInventoryBatch Batch;
+	const int32 LootTable = MakeRegistry(Registry, Batch);
+
+	BuildBatch(Batch, Registry, LootTable, 500, 64);
+	Batch.Run(1);
+	const uint32 SerialDigest = Batch.GetDigest();
+	const int32 WorkerCounts[] = { 2, 4, 8, 32 };
+	for (int32 NumWorkers : WorkerCounts)
+	{
+		BuildBatch(Batch, Registry, LootTable, 500, 64);
+		Batch.Run(NumWorkers);
+		TestEqual(FString::Printf(TEXT("Digest with %d workers"), NumWorkers), Batch.GetDigest(), SerialDigest);
+	}
+	return true;
+}
+#endif
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+enum class EInventoryCommandOp : uint8
+{
+	Add,
+	Remove,
+	Restock, // tops the item up to Quantity, vendor restocks
+	RollLoot // Quantity rolls on a loot table
+};
+
+
+/* One command against one Inventory of an FInventoryBatch */
+struct FInventoryCommand
+{
+public:
+
+	FInventoryCommand()
+	{
+		Op = EInventoryCommandOp::Add;
+		Slot = INDEX_NONE;
+		Quantity = 0;
+		LootTable = INDEX_NONE;
+		Seed = 0;
+	}
+
+	EInventoryCommandOp Op;
+
+	FItemDefinitionHandle Handle; // Add and Restock, for Remove the item Slot must still hold
+
+	int32 Slot; // Remove, captured when the command is queued so earlier removes in the same batch can move another item into it
+
+	int32 Quantity;
+
+	int32 LootTable; // RollLoot, index returned by FInventoryBatch::AddLootTable
+
+	int32 Seed; // RollLoot, the rolls only depend on the seed so they are the same on any thread
+};
+
+
+/* One weighted row of a loot table */
+struct FInventoryLootEntry
+{
+	FItemDefinitionHandle Handle;
+
+	int32 Weight;
+
+	int32 MinQuantity;
+
+	int32 MaxQuantity;
+};
+
+
+/* Independent commands for many Inventories, partitioned by Inventory and run on the task graph's worker threads */
+/* A partition only touches its own FInventorySimulation, so no locks are needed and the results do not depend on the number of threads */
+class FInventoryBatch
+{
+public:
+
+	// Loot tables are kept by Reset(), the index can be used by every later batch
+	int32 AddLootTable(const TArray<FInventoryLootEntry>& Entries);
+
+	// Adds one Inventory to the batch, returns the partition its commands are added to
+	int32 AddPartition(FInventorySimulation&& Simulation);
+
+	// Commands of a partition run in the order they were added
+	void AddCommand(int32 Partition, const FInventoryCommand& Command);
+
+	// Runs every partition, NumWorkers of 1 or less runs them in order on the calling thread
+	// Each worker claims the next unclaimed partition when it finishes one, so a few large Inventories do not hold up the rest
+	void Run(int32 NumWorkers);
+
+	int32 NumPartitions() const { return Partitions.Num(); }
+
+	FInventorySimulation& GetSimulation(int32 Partition) { return Partitions[Partition].Simulation; }
+
+	// Hash of every partition's Inventory and drops in partition order
+	uint32 GetDigest() const;
+
+	// Removes every partition and command
+	void Reset() { Partitions.Reset(); }
+
+private:
+
+	struct FPartition
+	{
+		FPartition(FInventorySimulation&& InSimulation)
+			: Simulation(MoveTemp(InSimulation))
+		{
+		}
+
+		FInventorySimulation Simulation;
+
+		TArray<FInventoryCommand> Commands;
+	};
+
+	struct FLootTable
+	{
+		TArray<FInventoryLootEntry> Entries;
+
+		int32 TotalWeight;
+	};
+
+	void RunPartition(FPartition& Partition) const;
+
+	TArray<FPartition> Partitions;
+
+	TArray<FLootTable> LootTables;
+};
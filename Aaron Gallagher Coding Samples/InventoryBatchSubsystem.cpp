@@ -0,0 +1,75 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+void UInventoryBatchSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UInventoryBatchSubsystem::OnWorldPostActorTick);
+}
+
+void UInventoryBatchSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	Super::Deinitialize();
+}
+
+// Queues a command for Component, the batch runs at the end of the frame or when FlushBatch is called
+// Commands for the same component run in the order they were queued
+void UInventoryBatchSubsystem::QueueCommand(UInventoryComponent* Component, const FInventoryCommand& Command)
+{
+	if (!Component || Component->GetOwnerRole() != ROLE_Authority) return;
+
+	int32* PendingIndex = PendingByComponent.Find(Component);
+	if (!PendingIndex)
+	{
+		PendingIndex = &PendingByComponent.Add(Component, PendingCommands.AddDefaulted());
+		PendingCommands[*PendingIndex].Component = Component;
+	}
+	PendingCommands[*PendingIndex].Commands.Add(Command);
+}
+
+// Runs every queued command on the worker threads and merges the results into their components
+// Game thread only, the game thread waits for the workers so no other code sees a component while its partition runs
+void UInventoryBatchSubsystem::FlushBatch()
+{
+	if (PendingCommands.Num() == 0 || bIsFlushing) return;
+	check(IsInGameThread());
+
+	// Moved out before anything runs, the merge broadcasts OnOverweightChanged and commands queued by its listeners go into the next batch
+	TArray<FPendingCommands> FlushingCommands = MoveTemp(PendingCommands);
+	PendingCommands.Reset();
+	PendingByComponent.Reset();
+	TGuardValue<bool> FlushingGuard(bIsFlushing, true);
+
+	// Every Inventory is copied here rather than when its commands were queued, so changes made earlier in the frame are not lost
+	Batch.Reset();
+	for (FPendingCommands& Pending : FlushingCommands)
+	{
+		UInventoryComponent* Component = Pending.Component.Get();
+		Pending.Partition = Component ? Batch.AddPartition(Component->MakeSimulation()) : INDEX_NONE;
+		if (Pending.Partition == INDEX_NONE) continue;
+		for (const FInventoryCommand& Command : Pending.Commands)
+		{
+			Batch.AddCommand(Pending.Partition, Command);
+		}
+	}
+
+	const int32 NumWorkers = (MaxWorkers > 0) ? MaxWorkers : FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1);
+	Batch.Run(NumWorkers);
+
+	// Merge step, one Inventory replacement, encumbrance refresh and replication flush per component
+	for (const FPendingCommands& Pending : FlushingCommands)
+	{
+		UInventoryComponent* Component = Pending.Component.Get();
+		if (!Component || Pending.Partition == INDEX_NONE) continue;
+		Component->ApplySimulation(Batch.GetSimulation(Pending.Partition));
+	}
+	Batch.Reset();
+}
+
+void UInventoryBatchSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld()) return;
+	FlushBatch();
+}
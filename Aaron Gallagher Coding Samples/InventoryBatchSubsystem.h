@@ -0,0 +1,53 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Collects vendor restocks, loot rolls and other bulk Inventory commands from the whole World and runs them as one batch */
+/* Each Inventory Component's commands run on a worker thread against a copy of its Inventory, the results are merged back on the game thread in one step */
+UCLASS()
+class INVENTORY_API UInventoryBatchSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	// Queues a command for Component, the batch runs at the end of the frame or when FlushBatch is called
+	// Commands for the same component run in the order they were queued
+	void QueueCommand(UInventoryComponent* Component, const FInventoryCommand& Command);
+
+	// Registers a loot table for RollLoot commands, returns the index to put in FInventoryCommand::LootTable
+	int32 AddLootTable(const TArray<FInventoryLootEntry>& Entries) { return Batch.AddLootTable(Entries); }
+
+	// Runs every queued command on the worker threads and merges the results into their components
+	void FlushBatch();
+
+	// Workers used by FlushBatch, 0 uses one per task graph worker thread
+	UPROPERTY(BlueprintReadWrite, Category = "Utils")
+	int32 MaxWorkers = 0;
+
+private:
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	struct FPendingCommands
+	{
+		TWeakObjectPtr<UInventoryComponent> Component;
+		TArray<FInventoryCommand> Commands;
+		int32 Partition;
+	};
+
+	FInventoryBatch Batch;
+
+	TArray<FPendingCommands> PendingCommands; // one per component, in the order their first command was queued
+
+	TMap<TWeakObjectPtr<UInventoryComponent>, int32> PendingByComponent;
+
+	bool bIsFlushing = false; // a FlushBatch called while the batch is being merged leaves its commands for the next flush
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,484 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunInventoryDeltaBenchmark(const TArray<FString>& Args);
+
+// Inventory.DeltaBench <Changes> <Slots>, logs the bytes a loot session sends as deltas against resending the whole TArray<FInventoryItem>
+static FAutoConsoleCommandWithArgs GInventoryDeltaBenchCommand(
+	TEXT("Inventory.DeltaBench"),
+	TEXT("Inventory.DeltaBench <Changes> <Slots>: logs bytes per change of a loot session sent as per slot deltas against every element as a full FInventoryItem, and the time to write a delta"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunInventoryDeltaBenchmark));
+#endif
+
+namespace InventoryDeltaReplication
+{
+	// Upper bound on the slot count of a packet so a malformed packet cannot make the client allocate without limit
+	const uint32 MaxSlots = 1 << 16;
+
+	FORCEINLINE uint32 ZigZag(int32 Value)
+	{
+		return ((uint32)Value << 1) ^ (uint32)(Value >> 31);
+	}
+
+	FORCEINLINE int32 UnZigZag(uint32 Value)
+	{
+		return (int32)(Value >> 1) ^ -(int32)(Value & 1);
+	}
+
+	FORCEINLINE void SerializeSignedPacked(FArchive& Ar, int32& Value)
+	{
+		uint32 Packed = ZigZag(Value);
+		Ar.SerializeIntPacked(Packed);
+		if (Ar.IsLoading()) Value = UnZigZag(Packed);
+	}
+
+	// Reads or writes the fields named in Fields, the same function is used by the sender and the receiver so the layout cannot drift
+	void SerializeSlotFields(FArchive& Ar, uint8 Fields, FInventorySlotState& State)
+	{
+		if (Fields & FInventorySlotState::SF_ItemID)
+		{
+			// Only sent when a slot gets a different item, so the string costs little next to quantity changes
+			FString ID = State.ItemID.IsNone() ? FString() : State.ItemID.ToString();
+			Ar << ID;
+			if (Ar.IsLoading()) State.ItemID = ID.IsEmpty() ? NAME_None : FName(*ID);
+		}
+		if (Fields & FInventorySlotState::SF_Quantity)
+		{
+			SerializeSignedPacked(Ar, State.Quantity);
+		}
+		if (Fields & FInventorySlotState::SF_Flags)
+		{
+			uint32 FlagsValue = State.Flags;
+			Ar.SerializeInt(FlagsValue, 8);
+			if (Ar.IsLoading()) State.Flags = (uint8)FlagsValue;
+		}
+		if (Fields & FInventorySlotState::SF_Stats)
+		{
+			SerializeSignedPacked(Ar, State.ModifiedStats.Armor);
+			SerializeSignedPacked(Ar, State.ModifiedStats.PhysicalAttack);
+			SerializeSignedPacked(Ar, State.ModifiedStats.Fortitude);
+			SerializeSignedPacked(Ar, State.ModifiedStats.Agility);
+			SerializeSignedPacked(Ar, State.ModifiedStats.MagicAttack);
+			Ar << State.ModifiedStats.DamageAmount;
+		}
+	}
+}
+
+// Copies the per instance state of Element, Definition is the registry entry of its handle
+FInventorySlotState FInventorySlotState::FromElement(const FInventoryElement& Element, const FInventoryItem& Definition)
+{
+	FInventorySlotState State;
+	State.ItemID = Definition.ItemID;
+	State.Quantity = Element.Quantity;
+	if (Element.bIsEquipped) State.Flags |= SLF_Equipped;
+	if (Element.bIsModifiedItem) State.Flags |= SLF_Modified;
+	if (Element.bHaveStatsBeenSet) State.Flags |= SLF_StatsSet;
+	if (Element.bIsModifiedItem) State.ModifiedStats = Element.ModifiedStats;
+	return State;
+}
+
+// Points Element at the definition of ItemID in Registry and copies this state over it, used by clients and when loading a save
+// Game thread only, the Item ID is resolved through Registry
+void FInventorySlotState::ApplyTo(FInventoryElement& Element, FItemDefinitionRegistry& Registry) const
+{
+	Element.Handle = ItemID.IsNone() ? FItemDefinitionHandle() : Registry.Resolve(ItemID);
+	Element.Quantity = Quantity;
+	Element.bIsEquipped = (Flags & SLF_Equipped) != 0;
+	Element.bIsModifiedItem = (Flags & SLF_Modified) != 0;
+	Element.bHaveStatsBeenSet = (Flags & SLF_StatsSet) != 0;
+	Element.ModifiedStats = Element.bIsModifiedItem ? ModifiedStats : FCharacterStats();
+}
+
+// Fields of this state that are different from Other
+uint8 FInventorySlotState::DiffFields(const FInventorySlotState& Other) const
+{
+	uint8 Fields = 0;
+	if (ItemID != Other.ItemID) Fields |= SF_ItemID;
+	if (Quantity != Other.Quantity) Fields |= SF_Quantity;
+	if (Flags != Other.Flags) Fields |= SF_Flags;
+	if (!(ModifiedStats == Other.ModifiedStats)) Fields |= SF_Stats;
+	return Fields;
+}
+
+// Called after an element is added or changed, a removal marks every slot from the removed index to the end
+void FInventoryDeltaSender::MarkDirty(int32 SlotIndex)
+{
+	if (SlotIndex < 0) return;
+	while (DirtySlots.Num() <= SlotIndex)
+	{
+		DirtySlots.Add(false);
+	}
+	DirtySlots[SlotIndex] = true;
+}
+
+// Writes the dirty slots of Slots to Writer, returns false and writes nothing if the client is already up to date
+// Slots that were sent but not acknowledged yet are written again, so calling this on a timer also covers lost packets
+bool FInventoryDeltaSender::WriteDelta(const TArray<FInventorySlotState>& Slots, FBitWriter& Writer)
+{
+	const int32 NumSlots = Slots.Num();
+	if (Tracking.Num() > NumSlots)
+	{
+		Tracking.SetNum(NumSlots); // the client drops the same slots when it reads the new slot count
+	}
+	else if (Tracking.Num() < NumSlots)
+	{
+		Tracking.SetNum(NumSlots);
+	}
+
+	Entries.Reset();
+	const int32 NumDirty = FMath::Min(DirtySlots.Num(), NumSlots);
+	for (int32 SlotIndex = 0; SlotIndex < NumDirty; SlotIndex++)
+	{
+		if (!DirtySlots[SlotIndex]) continue;
+		FSlotTracking& SlotTracking = Tracking[SlotIndex];
+		uint8 Fields = Slots[SlotIndex].DiffFields(SlotTracking.Acked) | SlotTracking.PendingFields;
+		if (SlotIndex >= SentNumSlots && SlotTracking.LastSentSequence == 0)
+		{
+			Fields = FInventorySlotState::SF_All; // the client may still hold an old element at this index
+		}
+		if (Fields == 0)
+		{
+			DirtySlots[SlotIndex] = false; // the client has this slot and it is acknowledged
+			continue;
+		}
+		Entries.Add(TPair<int32, uint8>(SlotIndex, Fields));
+	}
+	for (int32 SlotIndex = NumSlots; SlotIndex < DirtySlots.Num(); SlotIndex++)
+	{
+		DirtySlots[SlotIndex] = false; // removed, covered by the slot count
+	}
+
+	if (Entries.Num() == 0 && NumSlots == AckedNumSlots) return false;
+
+	const int32 Sequence = NextSequence++;
+	if (NumSlots != SentNumSlots)
+	{
+		SentNumSlots = NumSlots;
+		SentNumSlotsSequence = Sequence;
+	}
+
+	uint32 Value = (uint32)Sequence;
+	Writer.SerializeIntPacked(Value);
+	Value = (uint32)NumSlots;
+	Writer.SerializeIntPacked(Value);
+	Value = (uint32)Entries.Num();
+	Writer.SerializeIntPacked(Value);
+
+	int32 PreviousSlot = INDEX_NONE;
+	for (const TPair<int32, uint8>& Entry : Entries)
+	{
+		uint32 SlotGap = (uint32)(Entry.Key - PreviousSlot - 1); // entries are in ascending slot order
+		Writer.SerializeIntPacked(SlotGap);
+		uint32 Fields = Entry.Value;
+		Writer.SerializeInt(Fields, FInventorySlotState::SF_All + 1);
+		FInventorySlotState State = Slots[Entry.Key];
+		InventoryDeltaReplication::SerializeSlotFields(Writer, Entry.Value, State);
+		PreviousSlot = Entry.Key;
+
+		FSlotTracking& SlotTracking = Tracking[Entry.Key];
+		SlotTracking.LastSent = State;
+		SlotTracking.LastSentSequence = Sequence;
+		SlotTracking.PendingFields |= Entry.Value;
+	}
+	return !Writer.IsError();
+}
+
+// Cumulative ack from the client, every packet up to Sequence has been applied
+void FInventoryDeltaSender::OnAck(int32 Sequence)
+{
+	if (Sequence <= AckedSequence || Sequence >= NextSequence) return;
+	AckedSequence = Sequence;
+	if (Sequence >= SentNumSlotsSequence) AckedNumSlots = SentNumSlots;
+
+	// A slot's baseline only moves once its latest send is acknowledged, older acks cannot say which of its values the client holds
+	for (int32 SlotIndex = 0; SlotIndex < Tracking.Num(); SlotIndex++)
+	{
+		FSlotTracking& SlotTracking = Tracking[SlotIndex];
+		if (SlotTracking.PendingFields != 0 && SlotTracking.LastSentSequence <= Sequence)
+		{
+			SlotTracking.Acked = SlotTracking.LastSent;
+			SlotTracking.PendingFields = 0;
+		}
+	}
+}
+
+// Applies a delta written by FInventoryDeltaSender to Slots, packets older than the last applied one are ignored
+// Indices of the slots that were written are appended to OutChangedSlots, returns false if the packet was stale or malformed
+// Slots and OutChangedSlots are left untouched unless the whole packet could be read
+bool FInventoryDeltaReceiver::ReadDelta(FBitReader& Reader, TArray<FInventorySlotState>& Slots, TArray<int32>& OutChangedSlots)
+{
+	uint32 Sequence = 0;
+	uint32 NumSlots = 0;
+	uint32 NumEntries = 0;
+	Reader.SerializeIntPacked(Sequence);
+	Reader.SerializeIntPacked(NumSlots);
+	Reader.SerializeIntPacked(NumEntries);
+	if (Reader.IsError() || NumSlots > InventoryDeltaReplication::MaxSlots || NumEntries > NumSlots) return false;
+	if ((int32)Sequence <= LastAppliedSequence) return false;
+
+	// Decoded into a copy so a malformed packet leaves Slots as they were, the server resends it because it is never acknowledged
+	ScratchSlots = Slots;
+	ScratchSlots.SetNum(NumSlots);
+	const int32 NumChangedBefore = OutChangedSlots.Num();
+	int32 SlotIndex = INDEX_NONE;
+	for (uint32 i = 0; i < NumEntries; i++)
+	{
+		uint32 SlotGap = 0;
+		uint32 Fields = 0;
+		Reader.SerializeIntPacked(SlotGap);
+		Reader.SerializeInt(Fields, FInventorySlotState::SF_All + 1);
+		SlotIndex += (int32)SlotGap + 1;
+		if (Reader.IsError() || SlotIndex >= (int32)NumSlots) break;
+		InventoryDeltaReplication::SerializeSlotFields(Reader, (uint8)Fields, ScratchSlots[SlotIndex]);
+		OutChangedSlots.Add(SlotIndex);
+	}
+	if (Reader.IsError() || SlotIndex >= (int32)NumSlots)
+	{
+		OutChangedSlots.SetNum(NumChangedBefore, false);
+		return false;
+	}
+
+	Swap(Slots, ScratchSlots);
+	LastAppliedSequence = (int32)Sequence;
+	return true;
+}
+
+#if !UE_BUILD_SHIPPING
+namespace InventoryDeltaReplicationTest
+{
+	using namespace InventoryDeltaReplication;
+
+	// One change of a loot session, mostly stack top ups with some new items, removals, equips and rolled stats
+	void ApplyRandomChange(FRandomStream& Random, TArray<FInventorySlotState>& Slots, int32 MaxSlots, FInventoryDeltaSender& Sender)
+	{
+		const int32 Roll = Random.RandHelper(100);
+		if (Slots.Num() == 0 || (Roll < 15 && Slots.Num() < MaxSlots))
+		{
+			FInventorySlotState& Slot = Slots.AddDefaulted_GetRef();
+			Slot.ItemID = FName(*FString::Printf(TEXT("LootItem_%d"), Random.RandHelper(400)));
+			Slot.Quantity = Random.RandRange(1, 20);
+			Sender.MarkDirty(Slots.Num() - 1);
+			return;
+		}
+		const int32 Index = Random.RandHelper(Slots.Num());
+		FInventorySlotState& Slot = Slots[Index];
+		if (Roll < 25)
+		{
+			Slots.RemoveAt(Index);
+			for (int32 i = Index; i < Slots.Num(); i++) Sender.MarkDirty(i);
+			return;
+		}
+		if (Roll < 30) Slot.Flags ^= FInventorySlotState::SLF_Equipped;
+		else if (Roll < 33)
+		{
+			Slot.Flags |= FInventorySlotState::SLF_Modified | FInventorySlotState::SLF_StatsSet;
+			Slot.ModifiedStats.Armor = Random.RandRange(-5, 40);
+			Slot.ModifiedStats.MagicAttack = Random.RandRange(0, 40);
+			Slot.ModifiedStats.DamageAmount = 0.25f * Random.RandRange(0, 80);
+		}
+		else Slot.Quantity = FMath::Max(Slot.Quantity + Random.RandRange(-3, 5), 1);
+		Sender.MarkDirty(Index);
+	}
+
+	// What replicating one element as a full FInventoryItem writes, every field with the texts in full and object references as packed NetGUIDs
+	void SerializeFullItem(FArchive& Ar, FInventoryItem& Item)
+	{
+		FString ID = Item.ItemID.ToString();
+		Ar << ID;
+		Ar << Item.ItemName;
+		Ar << Item.ItemDescription;
+		Ar << Item.ItemAction;
+		SerializeSignedPacked(Ar, Item.ItemValue);
+		SerializeSignedPacked(Ar, Item.Quantity);
+		Ar << Item.Weight;
+		uint32 ItemType = (uint32)Item.ItemType;
+		Ar.SerializeInt(ItemType, 256);
+		const UObject* References[] = { Item.Pickup.Get(), Item.Thumbnail, Item.ItemMesh, Item.WeaponClass.Get() };
+		for (const UObject* Reference : References)
+		{
+			uint32 NetGUID = Reference ? (uint32)Reference->GetUniqueID() : 0;
+			Ar.SerializeIntPacked(NetGUID);
+		}
+		bool Bits[] = { Item.bIsStackable, Item.bCanBeUsed, Item.bIsEquippable, Item.bIsEquipped, Item.bIsModifiedItem, Item.bHaveStatsBeenSet };
+		for (bool& Bit : Bits)
+		{
+			uint8 Value = Bit ? 1 : 0;
+			Ar.SerializeBits(&Value, 1);
+		}
+		SerializeSignedPacked(Ar, Item.PickupCharacterStats.Armor);
+		SerializeSignedPacked(Ar, Item.PickupCharacterStats.PhysicalAttack);
+		SerializeSignedPacked(Ar, Item.PickupCharacterStats.Fortitude);
+		SerializeSignedPacked(Ar, Item.PickupCharacterStats.Agility);
+		SerializeSignedPacked(Ar, Item.PickupCharacterStats.MagicAttack);
+		Ar << Item.PickupCharacterStats.DamageAmount;
+	}
+
+	bool AreSlotsEqual(const TArray<FInventorySlotState>& A, const TArray<FInventorySlotState>& B)
+	{
+		if (A.Num() != B.Num()) return false;
+		for (int32 i = 0; i < A.Num(); i++)
+		{
+			if (A[i].DiffFields(B[i]) != 0) return false;
+		}
+		return true;
+	}
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryDeltaTest, "Inventory.Delta.LossyLink", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// Round trips random slot changes through FInventoryDeltaSender and FInventoryDeltaReceiver over a lossy, reordering link
+// A fifth of the packets are lost, a fifth arrive after the next packet and a fifth of the acks are lost
+// Once the changes stop, deltas are resent until the server has an ack for everything, the client must then hold exactly the server's slots
+// A truncated packet must be refused without changing the client's slots or being acknowledged
+bool FInventoryDeltaTest::RunTest(const FString& Parameters)
+{
+	using namespace InventoryDeltaReplicationTest;
+	const int32 NumChanges = 20000;
+
+	FRandomStream Random(NumChanges);
+	TArray<FInventorySlotState> ServerSlots;
+	TArray<FInventorySlotState> ClientSlots;
+	FInventoryDeltaSender Sender;
+	FInventoryDeltaReceiver Receiver;
+	TArray<int32> ChangedSlots;
+	TArray<uint8> LatePacket;
+	int64 LatePacketBits = 0;
+	int32 NumRefused = 0;
+
+	auto Deliver = [&](const TArray<uint8>& Bytes, int64 NumBits)
+	{
+		FBitReader Reader(const_cast<uint8*>(Bytes.GetData()), NumBits);
+		ChangedSlots.Reset();
+		if (!Receiver.ReadDelta(Reader, ClientSlots, ChangedSlots)) NumRefused++;
+	};
+
+	for (int32 Change = 0; Change < NumChanges; Change++)
+	{
+		ApplyRandomChange(Random, ServerSlots, 64, Sender);
+		FBitWriter Writer(0, true);
+		const int32 Fate = Sender.WriteDelta(ServerSlots, Writer) ? Random.RandHelper(5) : 0; // 0 lost, 1 late, anything else on time
+		if (Fate > 1) Deliver(TArray<uint8>(Writer.GetData(), Writer.GetNumBytes()), Writer.GetNumBits());
+		if (LatePacket.Num() > 0)
+		{
+			Deliver(LatePacket, LatePacketBits); // after the packet that overtook it, so it is refused as stale
+			LatePacket.Reset();
+		}
+		if (Fate == 1)
+		{
+			LatePacket = TArray<uint8>(Writer.GetData(), Writer.GetNumBytes());
+			LatePacketBits = Writer.GetNumBits();
+		}
+		if (Random.RandHelper(5) != 0) Sender.OnAck(Receiver.GetAckSequence());
+	}
+	if (LatePacket.Num() > 0) Deliver(LatePacket, LatePacketBits);
+
+	int32 NumResends = 0;
+	while (NumResends < 100)
+	{
+		FBitWriter Writer(0, true);
+		if (!Sender.WriteDelta(ServerSlots, Writer) && !Sender.IsWaitingForAck()) break;
+		if (Writer.GetNumBits() > 0) Deliver(TArray<uint8>(Writer.GetData(), Writer.GetNumBytes()), Writer.GetNumBits());
+		Sender.OnAck(Receiver.GetAckSequence());
+		NumResends++;
+	}
+	TestTrue(TEXT("Client matches the server"), AreSlotsEqual(ServerSlots, ClientSlots));
+	TestFalse(TEXT("Server still waiting for an ack"), Sender.IsWaitingForAck());
+
+	// Every slot of a fresh sender is written with every field, cutting that packet anywhere must not change the client
+	// The client starts from other slots than the server's, so a slot written before the cut would show up as a difference
+	{
+		FInventoryDeltaSender FreshSender;
+		for (int32 i = 0; i < ServerSlots.Num(); i++) FreshSender.MarkDirty(i);
+		FBitWriter Writer(0, true);
+		FreshSender.WriteDelta(ServerSlots, Writer);
+		const TArray<uint8> Bytes(Writer.GetData(), Writer.GetNumBytes());
+		TArray<FInventorySlotState> Before = ServerSlots;
+		Before.SetNum(ServerSlots.Num() / 2);
+		for (FInventorySlotState& Slot : Before) Slot.Quantity += 1000;
+		for (int32 Cut = 1; Cut < 64; Cut++)
+		{
+			FInventoryDeltaReceiver FreshReceiver;
+			TArray<FInventorySlotState> Slots = Before;
+			FBitReader Reader(const_cast<uint8*>(Bytes.GetData()), FMath::Max<int64>(Writer.GetNumBits() - Cut, 0));
+			ChangedSlots.Reset();
+			const FString What = FString::Printf(TEXT("Packet cut %d bits short"), Cut);
+			if (!TestFalse(What + TEXT(" was applied"), FreshReceiver.ReadDelta(Reader, Slots, ChangedSlots))) break;
+			TestEqual(What + TEXT(": ack sequence"), FreshReceiver.GetAckSequence(), 0);
+			TestTrue(What + TEXT(": client slots unchanged"), AreSlotsEqual(Slots, Before));
+			TestEqual(What + TEXT(": changed slots"), ChangedSlots.Num(), 0);
+		}
+	}
+	AddInfo(FString::Printf(TEXT("%d changes, %d slots at the end, %d packets refused as stale or malformed, %d resends to settle"), NumChanges, ServerSlots.Num(), NumRefused, NumResends));
+	return true;
+}
+#endif
+
+// Each change is flushed and acked right away, as on a healthy connection
+// The full side writes every element as the FInventoryItem the client used to receive, display texts included, after each change
+// Definitions have display text of the length a real item has, so the full side is not understated
+static void RunInventoryDeltaBenchmark(const TArray<FString>& Args)
+{
+	using namespace InventoryDeltaReplicationTest;
+	const int32 NumChanges = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+	const int32 MaxSlots = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 60;
+
+	FItemDefinitionRegistry Registry;
+	for (int32 i = 0; i < 400; i++)
+	{
+		FInventoryItem Definition;
+		Definition.ItemID = FName(*FString::Printf(TEXT("LootItem_%d"), i));
+		Definition.ItemName = FText::FromString(FString::Printf(TEXT("Loot Item %d"), i));
+		Definition.ItemDescription = FText::FromString(FString::Printf(TEXT("Generated loot item %d, its description is about as long as one written for a real item in the data table."), i));
+		Definition.Weight = 0.25f * (i % 9);
+		Definition.ItemValue = i;
+		Definition.bIsStackable = true;
+		Registry.Add(Definition);
+	}
+
+	FRandomStream Random(NumChanges);
+	TArray<FInventorySlotState> Slots;
+	TArray<FInventoryElement> Elements;
+	FInventoryDeltaSender Sender;
+	FInventoryDeltaReceiver Receiver;
+	TArray<FInventorySlotState> ClientSlots;
+	TArray<int32> ChangedSlots;
+	int64 DeltaBits = 0;
+	int64 FullBits = 0;
+	double DeltaSeconds = 0.0;
+	for (int32 Change = 0; Change < NumChanges; Change++)
+	{
+		ApplyRandomChange(Random, Slots, MaxSlots, Sender);
+
+		FBitWriter Writer(0, true);
+		const double StartTime = FPlatformTime::Seconds();
+		const bool bHasPacket = Sender.WriteDelta(Slots, Writer);
+		DeltaSeconds += FPlatformTime::Seconds() - StartTime;
+		DeltaBits += Writer.GetNumBits();
+		if (bHasPacket)
+		{
+			FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+			ChangedSlots.Reset();
+			Receiver.ReadDelta(Reader, ClientSlots, ChangedSlots);
+			Sender.OnAck(Receiver.GetAckSequence());
+		}
+
+		Elements.SetNum(Slots.Num());
+		FBitWriter FullWriter(0, true);
+		for (int32 i = 0; i < Slots.Num(); i++)
+		{
+			Slots[i].ApplyTo(Elements[i], Registry);
+			FInventoryItem Item = Registry.MakeItemView(Elements[i]);
+			SerializeFullItem(FullWriter, Item);
+		}
+		FullBits += FullWriter.GetNumBits();
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Inventory.DeltaBench: %d changes, up to %d slots, %d at the end, client %s"),
+		NumChanges, MaxSlots, Slots.Num(), AreSlotsEqual(Slots, ClientSlots) ? TEXT("in sync") : TEXT("OUT OF SYNC"));
+	UE_LOG(LogTemp, Log, TEXT("Inventory.DeltaBench: deltas %.1f bytes a change, every FInventoryItem %.1f bytes a change, %.1fx less, %.2f us to write a delta"),
+		DeltaBits / (8.0 * NumChanges), FullBits / (8.0 * NumChanges), (DeltaBits > 0) ? ((double)FullBits / DeltaBits) : 0.0, DeltaSeconds * 1e6 / NumChanges);
+}
+#endif
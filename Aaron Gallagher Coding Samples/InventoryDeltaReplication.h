@@ -0,0 +1,145 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* The replicated part of one Inventory element, display data is resolved on the client from the Item ID */
+/* The Item ID is sent instead of a definition handle, handles depend on the order rows were added to the local registry */
+struct FInventorySlotState
+{
+public:
+
+	enum EField : uint8
+	{
+		SF_ItemID = 1 << 0,
+		SF_Quantity = 1 << 1,
+		SF_Flags = 1 << 2,
+		SF_Stats = 1 << 3,
+		SF_All = SF_ItemID | SF_Quantity | SF_Flags | SF_Stats
+	};
+
+	enum EFlags : uint8
+	{
+		SLF_Equipped = 1 << 0,
+		SLF_Modified = 1 << 1,
+		SLF_StatsSet = 1 << 2
+	};
+
+	FInventorySlotState()
+	{
+		Quantity = 0;
+		Flags = 0;
+	}
+
+	// Copies the per instance state of Element, Definition is the registry entry of its handle
+	static FInventorySlotState FromElement(const FInventoryElement& Element, const FInventoryItem& Definition);
+
+	// Points Element at the definition of ItemID in Registry and copies this state over it, used by clients and when loading a save
+	// Game thread only, the Item ID is resolved through Registry
+	void ApplyTo(FInventoryElement& Element, FItemDefinitionRegistry& Registry) const;
+
+	// Fields of this state that are different from Other
+	uint8 DiffFields(const FInventorySlotState& Other) const;
+
+	FName ItemID; // NAME_None when the element has no definition
+
+	int32 Quantity;
+
+	uint8 Flags;
+
+	FCharacterStats ModifiedStats; // only sent while SLF_Modified is set
+};
+
+
+/* Server side of delta replication, one per receiving connection */
+/* Tracks dirty slots and writes only the fields that differ from what the client has acknowledged */
+class FInventoryDeltaSender
+{
+public:
+
+	FInventoryDeltaSender()
+	{
+		NextSequence = 1;
+		AckedSequence = 0;
+		SentNumSlots = 0;
+		SentNumSlotsSequence = 0;
+		AckedNumSlots = 0;
+	}
+
+	// Called after an element is added or changed, a removal marks every slot from the removed index to the end
+	void MarkDirty(int32 SlotIndex);
+
+	// Writes the dirty slots of Slots to Writer, returns false and writes nothing if the client is already up to date
+	// Slots that were sent but not acknowledged yet are written again, so calling this on a timer also covers lost packets
+	bool WriteDelta(const TArray<FInventorySlotState>& Slots, FBitWriter& Writer);
+
+	// Cumulative ack from the client, every packet up to Sequence has been applied
+	void OnAck(int32 Sequence);
+
+	// Returns true if a packet has been sent that the client has not acknowledged yet
+	bool IsWaitingForAck() const { return AckedSequence < NextSequence - 1; }
+
+	// Packets written so far, each one is a ClientReceiveInventoryDelta call
+	int32 GetNumPacketsSent() const { return NextSequence - 1; }
+
+private:
+
+	struct FSlotTracking
+	{
+		FSlotTracking()
+		{
+			LastSentSequence = 0;
+			PendingFields = 0;
+		}
+
+		FInventorySlotState Acked; // state the client is known to have
+
+		FInventorySlotState LastSent;
+
+		int32 LastSentSequence;
+
+		uint8 PendingFields; // fields sent since Acked, the client may hold any of those values
+	};
+
+	TArray<FSlotTracking> Tracking;
+
+	TBitArray<> DirtySlots;
+
+	TArray<TPair<int32, uint8>> Entries; // slot index and fields, reused by WriteDelta
+
+	int32 NextSequence;
+
+	int32 AckedSequence;
+
+	int32 SentNumSlots; // slot count written in the last packet
+
+	int32 SentNumSlotsSequence; // packet that first carried SentNumSlots
+
+	int32 AckedNumSlots;
+};
+
+
+/* Client side of delta replication */
+class FInventoryDeltaReceiver
+{
+public:
+
+	FInventoryDeltaReceiver()
+	{
+		LastAppliedSequence = 0;
+	}
+
+	// Applies a delta written by FInventoryDeltaSender to Slots, packets older than the last applied one are ignored
+	// Indices of the slots that were written are appended to OutChangedSlots, returns false if the packet was stale or malformed
+	// Slots and OutChangedSlots are left untouched unless the whole packet could be read
+	bool ReadDelta(FBitReader& Reader, TArray<FInventorySlotState>& Slots, TArray<int32>& OutChangedSlots);
+
+	// Sequence to send back in the next batched ack
+	int32 GetAckSequence() const { return LastAppliedSequence; }
+
+private:
+
+	TArray<FInventorySlotState> ScratchSlots; // packet being decoded, swapped into the caller's slots once all of it has been read
+
+	int32 LastAppliedSequence;
+};
@@ -0,0 +1,156 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunInventoryEncumbranceBenchmark(const TArray<FString>& Args);
+
+// Inventory.EncumbranceBench <Changes>, times keeping the weight totals with deltas against summing the Inventory after every change, at 10, 100, 1k and 10k slots
+static FAutoConsoleCommandWithArgs GInventoryEncumbranceBenchCommand(
+	TEXT("Inventory.EncumbranceBench"),
+	TEXT("Inventory.EncumbranceBench <Changes>: times FInventoryEncumbrance deltas against summing the whole Inventory after every change, as IsEncombered() did, at 10, 100, 1k and 10k slots"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunInventoryEncumbranceBenchmark));
+#endif
+
+// Sums every element of the Inventory, only needed once or after the Inventory was replaced wholesale
+void FInventoryEncumbrance::Rebuild(const TArray<FInventoryElement>& Inventory, const FItemDefinitionRegistry& Registry)
+{
+	TotalWeight = 0.0;
+	TotalItems = 0;
+	TotalValue = 0;
+	for (const FInventoryElement& Element : Inventory)
+	{
+		const FInventoryItem& Definition = Registry.Get(Element.Handle);
+		TotalWeight += (double)Definition.Weight * Element.Quantity;
+		TotalItems += Element.Quantity;
+		TotalValue += (int64)Definition.ItemValue * Element.Quantity;
+	}
+	bIsBuilt = true;
+	UpdateOverweight();
+}
+
+// Applies QuantityDelta units of the item Definition describes to the totals, negative when items leave the Inventory
+// Returns true if the over weight state changed
+bool FInventoryEncumbrance::ApplyDelta(const FInventoryItem& Definition, int32 QuantityDelta)
+{
+	if (QuantityDelta == 0) return false;
+	TotalWeight += (double)Definition.Weight * QuantityDelta;
+	TotalItems += QuantityDelta;
+	TotalValue += (int64)Definition.ItemValue * QuantityDelta;
+	return UpdateOverweight();
+}
+
+// Returns true if the over weight state changed
+bool FInventoryEncumbrance::SetWeightLimit(float InWeightLimit)
+{
+	WeightLimit = InWeightLimit;
+	return UpdateOverweight();
+}
+
+// Full recompute used by WITH_INVENTORY_ENCUMBRANCE_CHECKS, returns false if the running totals have drifted
+bool FInventoryEncumbrance::Verify(const TArray<FInventoryElement>& Inventory, const FItemDefinitionRegistry& Registry) const
+{
+	FInventoryEncumbrance Recomputed;
+	Recomputed.Rebuild(Inventory, Registry);
+	return FMath::IsNearlyEqual(TotalWeight, Recomputed.TotalWeight, 0.01)
+		&& (TotalItems == Recomputed.TotalItems)
+		&& (TotalValue == Recomputed.TotalValue);
+}
+
+bool FInventoryEncumbrance::UpdateOverweight()
+{
+	const bool bWasOverweight = bIsOverweight;
+	bIsOverweight = (WeightLimit > 0.f) && (TotalWeight > WeightLimit);
+	return bWasOverweight != bIsOverweight;
+}
+
+#if !UE_BUILD_SHIPPING
+// Each change adds to or takes from one random element, the recompute side sums the whole Inventory after it the way IsEncombered() did
+// The weight limit moves between two values every eighth of the changes, the way a carry weight buff starting and ending changes MaxCarryWeight
+// Passes when both sides saw the same over weight changes and the running totals still match a full recompute after the last change
+static void RunInventoryEncumbranceBenchmark(const TArray<FString>& Args)
+{
+	const int32 NumChanges = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 8) : 100000;
+	const int32 SlotCounts[] = { 10, 100, 1000, 10000 };
+
+	for (int32 NumSlots : SlotCounts)
+	{
+		const float WeightLimits[] = { NumSlots * 10.f, NumSlots * 11.f }; // close to the average total of 10.5 a slot, so the state keeps changing
+		const int32 LimitPeriod = NumChanges / 8;
+
+		FRandomStream Random(NumSlots);
+		FItemDefinitionRegistry Registry;
+		TArray<FInventoryElement> Inventory;
+		Inventory.Reserve(NumSlots);
+		for (int32 i = 0; i < NumSlots; i++)
+		{
+			FInventoryItem Definition;
+			Definition.ItemID = FName(TEXT("EncumbranceItem"), i);
+			Definition.Weight = 0.25f * Random.RandRange(0, 8);
+			Definition.ItemValue = Random.RandRange(0, 100);
+			Inventory.Emplace(Registry.Add(Definition), Random.RandRange(1, 20));
+		}
+		TArray<TPair<int32, int32>> Changes; // element and quantity delta
+		for (int32 i = 0; i < NumChanges; i++)
+		{
+			const int32 Index = Random.RandHelper(NumSlots);
+			Changes.Add(TPair<int32, int32>(Index, (Random.RandHelper(2) == 0) ? 1 : -1));
+		}
+
+		TArray<FInventoryElement> DeltaInventory = Inventory;
+		FInventoryEncumbrance Encumbrance;
+		Encumbrance.SetWeightLimit(WeightLimits[0]);
+		Encumbrance.Rebuild(DeltaInventory, Registry);
+		int32 NumOverweightChanges = 0;
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumChanges; i++)
+		{
+			if ((i > 0) && (i % LimitPeriod == 0))
+			{
+				if (Encumbrance.SetWeightLimit(WeightLimits[(i / LimitPeriod) % 2])) NumOverweightChanges++;
+			}
+			FInventoryElement& Element = DeltaInventory[Changes[i].Key];
+			if (Element.Quantity + Changes[i].Value < 0) continue;
+			Element.Quantity += Changes[i].Value;
+			if (Encumbrance.ApplyDelta(Registry.Get(Element.Handle), Changes[i].Value)) NumOverweightChanges++;
+		}
+		const double DeltaSeconds = FPlatformTime::Seconds() - StartTime;
+
+		TArray<FInventoryElement> RecomputedInventory = Inventory;
+		int32 NumRecomputedChanges = 0;
+		auto SumWeight = [&RecomputedInventory, &Registry]()
+		{
+			double TotalWeight = 0.0;
+			for (const FInventoryElement& Element : RecomputedInventory)
+			{
+				TotalWeight += (double)Registry.Get(Element.Handle).Weight * Element.Quantity;
+			}
+			return TotalWeight;
+		};
+		bool bWasOverweight = SumWeight() > WeightLimits[0];
+		StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumChanges; i++)
+		{
+			const float WeightLimit = WeightLimits[(i / LimitPeriod) % 2];
+			if ((i > 0) && (i % LimitPeriod == 0))
+			{
+				const bool bIsOverweight = SumWeight() > WeightLimit;
+				if (bIsOverweight != bWasOverweight) NumRecomputedChanges++;
+				bWasOverweight = bIsOverweight;
+			}
+			FInventoryElement& Element = RecomputedInventory[Changes[i].Key];
+			if (Element.Quantity + Changes[i].Value < 0) continue;
+			Element.Quantity += Changes[i].Value;
+			const bool bIsOverweight = SumWeight() > WeightLimit;
+			if (bIsOverweight != bWasOverweight) NumRecomputedChanges++;
+			bWasOverweight = bIsOverweight;
+		}
+		const double RecomputedSeconds = FPlatformTime::Seconds() - StartTime;
+
+		const bool bPassed = Encumbrance.Verify(DeltaInventory, Registry) && (NumOverweightChanges == NumRecomputedChanges) && (Encumbrance.IsOverweight() == bWasOverweight);
+		UE_LOG(LogTemp, Log, TEXT("Inventory.EncumbranceBench: %d slots, %d changes, deltas %.1f ns a change, recompute %.1f ns a change, %.2fx, %d overweight changes, %s"),
+			NumSlots, NumChanges, DeltaSeconds * 1e9 / NumChanges, RecomputedSeconds * 1e9 / NumChanges, (DeltaSeconds > 0.0) ? (RecomputedSeconds / DeltaSeconds) : 0.0,
+			NumOverweightChanges, bPassed ? TEXT("passed") : TEXT("FAILED"));
+	}
+}
+#endif
@@ -0,0 +1,69 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+// Cross checks the running totals against a full recompute after every change
+// The recompute is O(N) per change, so it is only on in Debug builds, define it to 1 to track down drift in other configurations
+#ifndef WITH_INVENTORY_ENCUMBRANCE_CHECKS
+#define WITH_INVENTORY_ENCUMBRANCE_CHECKS UE_BUILD_DEBUG
+#endif
+
+
+/* Running weight, item count and value totals for an Inventory, updated by deltas instead of summing every element on each change */
+/* Only uses Core types so it can be driven without a World */
+struct FInventoryEncumbrance
+{
+public:
+
+	FInventoryEncumbrance()
+	{
+		TotalWeight = 0.0;
+		TotalItems = 0;
+		TotalValue = 0;
+		WeightLimit = 0.f;
+		bIsOverweight = false;
+		bIsBuilt = false;
+	}
+
+	// Sums every element of the Inventory, only needed once or after the Inventory was replaced wholesale
+	void Rebuild(const TArray<FInventoryElement>& Inventory, const FItemDefinitionRegistry& Registry);
+
+	// Applies QuantityDelta units of the item Definition describes to the totals, negative when items leave the Inventory
+	// Returns true if the over weight state changed
+	bool ApplyDelta(const FInventoryItem& Definition, int32 QuantityDelta);
+
+	// Returns true if the over weight state changed
+	bool SetWeightLimit(float InWeightLimit);
+
+	// Full recompute used by WITH_INVENTORY_ENCUMBRANCE_CHECKS, returns false if the running totals have drifted
+	bool Verify(const TArray<FInventoryElement>& Inventory, const FItemDefinitionRegistry& Registry) const;
+
+	float GetTotalWeight() const { return (float)TotalWeight; }
+
+	int32 GetTotalItems() const { return TotalItems; }
+
+	int64 GetTotalValue() const { return TotalValue; }
+
+	bool IsOverweight() const { return bIsOverweight; }
+
+	bool IsBuilt() const { return bIsBuilt; }
+
+	void Invalidate() { bIsBuilt = false; }
+
+private:
+
+	// Returns true if the over weight state changed
+	bool UpdateOverweight();
+
+	double TotalWeight; // double so repeated add and remove deltas do not drift
+
+	int32 TotalItems;
+
+	int64 TotalValue;
+
+	float WeightLimit;
+
+	bool bIsOverweight;
+
+	bool bIsBuilt;
+};
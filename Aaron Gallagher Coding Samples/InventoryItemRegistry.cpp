@@ -0,0 +1,219 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunItemRegistryBenchmark(const TArray<FString>& Args, UWorld* World);
+
+// Inventory.RegistryBench <Rows> <Lookups>, times item lookups through the registry against FindRow and a copy of the row, as AddItemtoInventoryByID did
+static FAutoConsoleCommandWithWorldAndArgs GItemRegistryBenchCommand(
+	TEXT("Inventory.RegistryBench"),
+	TEXT("Inventory.RegistryBench <Rows> <Lookups>: times FItemDefinitionRegistry lookups against UDataTable::FindRow plus a copy of the row, and checks the registry is rebuilt in place when its table changes"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunItemRegistryBenchmark));
+#endif
+
+// Copies every row of ItemTable, rows are stored in row map order
+// Building again keeps every handle, rows already stored are overwritten in place and new rows are added after them
+// Rows no longer in the table keep their definition so elements holding their handle still read it, FindHandle stops returning them
+// Returns false without changing anything if the table's rows are not FInventoryItem
+bool FItemDefinitionRegistry::Build(const UDataTable& ItemTable)
+{
+	const UScriptStruct* RowStruct = ItemTable.GetRowStruct();
+	if (!RowStruct || !RowStruct->IsChildOf(FInventoryItem::StaticStruct())) return false; // the rows below are read as FInventoryItem
+
+	// Every handle given out so far, whether or not its row was in the table last time
+	TMap<FName, int32> PreviousHandles = MoveTemp(HandlesByID);
+	PreviousHandles.Append(RemovedHandlesByID);
+	HandlesByID.Reset();
+	RemovedHandlesByID.Reset();
+	MissingIDs.Reset();
+	for (const TPair<FName, uint8*>& Row : ItemTable.GetRowMap())
+	{
+		FInventoryItem Definition = *reinterpret_cast<const FInventoryItem*>(Row.Value);
+		Definition.ItemID = Row.Key; // the row name is the ID that AddItemtoInventoryByID looks items up with
+		Definition.Quantity = 0;
+		int32 Index = INDEX_NONE;
+		if (PreviousHandles.RemoveAndCopyValue(Row.Key, Index))
+		{
+			Definitions[Index] = Definition; // references returned by Get() read the new row from here on
+			HandlesByID.Add(Row.Key, Index);
+		}
+		else Add(Definition);
+	}
+	RemovedHandlesByID = MoveTemp(PreviousHandles);
+	return true;
+}
+
+// Reads definitions from the item catalog at Filename from now on, returns false if the file could not be opened
+bool FItemDefinitionRegistry::OpenCatalog(const FString& Filename)
+{
+	TUniquePtr<FItemCatalog> NewCatalog = MakeUnique<FItemCatalog>();
+	if (!NewCatalog->Open(Filename)) return false;
+	Catalog = MoveTemp(NewCatalog);
+	return true;
+}
+
+// Adds one definition without a data table, returns the existing handle if the ID was already added
+FItemDefinitionHandle FItemDefinitionRegistry::Add(const FInventoryItem& Definition)
+{
+	if (const int32* Existing = HandlesByID.Find(Definition.ItemID))
+	{
+		return FItemDefinitionHandle(*Existing);
+	}
+	return AddDefinition(Definition);
+}
+
+// Same as FindHandle, and copies the row from the catalog when ID has not been looked up before
+// Game thread only, Item IDs from pickups, transactions, replication and saves are resolved through here
+FItemDefinitionHandle FItemDefinitionRegistry::Resolve(FName ID)
+{
+	const FItemDefinitionHandle Handle = FindHandle(ID);
+	if (Handle.IsValid() || !Catalog.IsValid()) return Handle;
+	return AddFromCatalog(ID);
+}
+
+// Only finds definitions already stored, safe on any thread while nothing calls Build, Add or Resolve
+FItemDefinitionHandle FItemDefinitionRegistry::FindHandle(FName ID) const
+{
+	INC_DWORD_STAT(STAT_InventoryDefinitionLookups);
+	GAMEPLAY_PROFILE_COUNT(DataTableLookups, 1);
+	const int32* Index = HandlesByID.Find(ID);
+	return Index ? FItemDefinitionHandle(*Index) : FItemDefinitionHandle();
+}
+
+const FInventoryItem* FItemDefinitionRegistry::Find(FName ID) const
+{
+	const FItemDefinitionHandle Handle = FindHandle(ID);
+	return Handle.IsValid() ? &Definitions[Handle.Index] : nullptr;
+}
+
+// Full FInventoryItem of an element for Blueprint and UI code, the definition with the element's quantity and state copied over it
+FInventoryItem FItemDefinitionRegistry::MakeItemView(const FInventoryElement& Element) const
+{
+	INVENTORY_COUNT_ITEM_COPY();
+	FInventoryItem Item = Get(Element.Handle);
+	Item.Quantity = Element.Quantity;
+	Item.bIsEquipped = Element.bIsEquipped;
+	Item.bIsModifiedItem = Element.bIsModifiedItem;
+	Item.bHaveStatsBeenSet = Element.bHaveStatsBeenSet;
+	Item.PickupCharacterStats = Element.GetStats(Item);
+	return Item;
+}
+
+// Stores Definition under a new handle, the caller has checked the ID is not already stored
+FItemDefinitionHandle FItemDefinitionRegistry::AddDefinition(const FInventoryItem& Definition)
+{
+	const int32 Index = Definitions.AddElement(Definition);
+	HandlesByID.Add(Definition.ItemID, Index);
+	return FItemDefinitionHandle(Index);
+}
+
+// Copies ID's row from the catalog, game thread only
+// Pickup and WeaponClass are loaded here because every machine spawns them, thumbnails and meshes are only loaded where they are rendered
+FItemDefinitionHandle FItemDefinitionRegistry::AddFromCatalog(FName ID)
+{
+	check(IsInGameThread());
+	if (MissingIDs.Contains(ID)) return FItemDefinitionHandle();
+	const int32 Row = Catalog->FindRow(ID);
+	FInventoryItem Definition;
+	FItemCatalogAssetPaths AssetPaths;
+	const bool bWithDisplayData = !IsRunningDedicatedServer();
+	if (Row == INDEX_NONE || !Catalog->MakeDefinition(Row, bWithDisplayData, Definition, AssetPaths))
+	{
+		MissingIDs.Add(ID);
+		return FItemDefinitionHandle();
+	}
+
+	Definition.ItemID = ID; // keeps the caller's FName instead of making a new one from the catalog's string
+	Definition.Pickup = Cast<UClass>(AssetPaths.Pickup.TryLoad());
+	Definition.WeaponClass = Cast<UClass>(AssetPaths.WeaponClass.TryLoad());
+	if (bWithDisplayData)
+	{
+		Definition.Thumbnail = Cast<UTexture2D>(AssetPaths.Thumbnail.TryLoad());
+		Definition.ItemMesh = Cast<UStaticMesh>(AssetPaths.ItemMesh.TryLoad());
+	}
+	return AddDefinition(Definition);
+}
+
+#if !UE_BUILD_SHIPPING
+// Builds a transient item table so it runs in any World, then looks up random rows both ways
+// Also checks the game instance's registry is rebuilt in place after OnDataTableChanged, keeping its handles, and that a table with other rows is refused
+static void RunItemRegistryBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	const int32 NumRows = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 2) : 1000; // the rebuild check changes the first row and removes the last
+	const int32 NumLookups = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 100000;
+
+	UDataTable* ItemTable = NewObject<UDataTable>(GetTransientPackage());
+	ItemTable->RowStruct = FInventoryItem::StaticStruct();
+	TArray<FName> IDs;
+	for (int32 i = 0; i < NumRows; i++)
+	{
+		FInventoryItem Row;
+		Row.ItemID = FName(TEXT("RegistryItem"), i);
+		Row.Weight = 0.25f * (i % 9);
+		Row.bIsStackable = (i % 2) == 0;
+		ItemTable->AddRow(Row.ItemID, Row);
+		IDs.Add(Row.ItemID);
+	}
+	FRandomStream Random(NumRows);
+	TArray<FName> Lookups;
+	for (int32 i = 0; i < NumLookups; i++)
+	{
+		Lookups.Add(IDs[Random.RandHelper(NumRows)]);
+	}
+
+	double TableWeight = 0.0;
+	double StartTime = FPlatformTime::Seconds();
+	for (FName ID : Lookups)
+	{
+		const FInventoryItem* Row = ItemTable->FindRow<FInventoryItem>(ID, TEXT(""));
+		if (!Row) continue;
+		FInventoryItem ItemToAdd = *Row; // every add copied the row, display text and asset pointers included
+		TableWeight += ItemToAdd.Weight;
+	}
+	const double TableSeconds = FPlatformTime::Seconds() - StartTime;
+
+	FItemDefinitionRegistry Registry;
+	double RegistryWeight = 0.0;
+	StartTime = FPlatformTime::Seconds();
+	const bool bIsBuilt = Registry.Build(*ItemTable); // timed, the registry is built by the first lookup in game
+	for (FName ID : Lookups)
+	{
+		const FItemDefinitionHandle Handle = Registry.FindHandle(ID);
+		if (!Handle.IsValid()) continue;
+		RegistryWeight += Registry.Get(Handle).Weight;
+	}
+	const double RegistrySeconds = FPlatformTime::Seconds() - StartTime;
+
+	// The owned registry is rebuilt in place when the table changes, so simulations and batches holding it never see it go away
+	// A changed row is read through the handle it had before, a removed row keeps its definition and a new row gets a new handle
+	// A table with other rows is never read as FInventoryItem
+	bool bIsRebuilt = true;
+	bool bIsWrongRowRefused = true;
+	if (UItemRegistrySubsystem* Registries = UItemRegistrySubsystem::Get(World))
+	{
+		const FItemDefinitionRegistry* Before = Registries->GetTableRegistry(ItemTable);
+		const FItemDefinitionHandle ChangedHandle = Before ? Before->FindHandle(IDs[0]) : FItemDefinitionHandle();
+		const FItemDefinitionHandle RemovedHandle = Before ? Before->FindHandle(IDs.Last()) : FItemDefinitionHandle();
+		FInventoryItem ChangedRow = *ItemTable->FindRow<FInventoryItem>(IDs[0], TEXT(""));
+		ChangedRow.Weight = 123.f;
+		ItemTable->AddRow(IDs[0], ChangedRow);
+		ItemTable->RemoveRow(IDs.Last());
+		ItemTable->AddRow(FName(TEXT("RegistryItemAdded")), ChangedRow);
+		ItemTable->OnDataTableChanged().Broadcast();
+		const FItemDefinitionRegistry* After = Registries->GetTableRegistry(ItemTable);
+		bIsRebuilt = Before && (After == Before) && (After->Num() == NumRows + 1) && (After->FindHandle(IDs[0]) == ChangedHandle)
+			&& (After->Get(ChangedHandle).Weight == 123.f) && After->IsValidHandle(RemovedHandle) && !After->FindHandle(IDs.Last()).IsValid()
+			&& (After->FindHandle(FName(TEXT("RegistryItemAdded"))).Index == NumRows);
+		UDataTable* OtherTable = NewObject<UDataTable>(GetTransientPackage());
+		OtherTable->RowStruct = FTableRowBase::StaticStruct();
+		bIsWrongRowRefused = (Registries->GetTableRegistry(OtherTable) == nullptr);
+	}
+
+	const bool bPassed = bIsBuilt && FMath::IsNearlyEqual(TableWeight, RegistryWeight) && bIsRebuilt && bIsWrongRowRefused;
+	UE_LOG(LogTemp, Log, TEXT("Inventory.RegistryBench: %d rows, %d lookups, FindRow and copy %.1f ns a lookup, registry %.1f ns a lookup, %.2fx, %d bytes not copied per lookup"),
+		NumRows, NumLookups, TableSeconds * 1e9 / NumLookups, RegistrySeconds * 1e9 / NumLookups, (RegistrySeconds > 0.0) ? (TableSeconds / RegistrySeconds) : 0.0, (int32)sizeof(FInventoryItem));
+	UE_LOG(LogTemp, Log, TEXT("Inventory.RegistryBench: rebuilt after the table changed %s, other row struct %s, %s"),
+		bIsRebuilt ? TEXT("in place") : TEXT("NO"), bIsWrongRowRefused ? TEXT("refused") : TEXT("ACCEPTED"), bPassed ? TEXT("passed") : TEXT("FAILED"));
+}
+#endif
@@ -0,0 +1,147 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Dense integer handle to an item definition, resolved once from the Item ID */
+struct FItemDefinitionHandle
+{
+public:
+
+	FItemDefinitionHandle()
+	{
+		Index = INDEX_NONE;
+	}
+
+	explicit FItemDefinitionHandle(int32 InIndex)
+	{
+		Index = InIndex;
+	}
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+
+	bool operator == (const FItemDefinitionHandle& Handle) const { return Index == Handle.Index; }
+
+	bool operator != (const FItemDefinitionHandle& Handle) const { return Index != Handle.Index; }
+
+	friend uint32 GetTypeHash(const FItemDefinitionHandle& Handle) { return ::GetTypeHash(Handle.Index); }
+
+	int32 Index;
+};
+
+
+/* One element of an Inventory, the handle of its item definition plus the state that belongs to this element alone */
+/* Names, weights, meshes and every other definition field are read through the handle, never copied into the element */
+/* Only uses Core types so it can be built and driven without a World */
+struct FInventoryElement
+{
+public:
+
+	FInventoryElement()
+	{
+		Quantity = 0;
+		bIsEquipped = false;
+		bIsModifiedItem = false;
+		bHaveStatsBeenSet = false;
+		EquipSlot = INDEX_NONE;
+		EquipSerial = 0;
+	}
+
+	FInventoryElement(FItemDefinitionHandle InHandle, int32 InQuantity)
+		: FInventoryElement()
+	{
+		Handle = InHandle;
+		Quantity = InQuantity;
+	}
+
+	// Rolled stats of a modified element, otherwise the stats every element of the item shares
+	const FCharacterStats& GetStats(const FInventoryItem& Definition) const { return bIsModifiedItem ? ModifiedStats : Definition.PickupCharacterStats; }
+
+	FItemDefinitionHandle Handle; // invalid for an empty slot of a static Inventory, or an Item ID the client could not resolve
+
+	int32 Quantity;
+
+	FCharacterStats ModifiedStats; // only used while bIsModifiedItem is set
+
+	bool bIsEquipped;
+
+	bool bIsModifiedItem;
+
+	bool bHaveStatsBeenSet;
+
+	// Weapon component this element was equipped in and the serial of that equip, set by EquipWeapon so UnEquipWeaponFromIndex goes straight to the weapon
+	// Server side runtime state, never saved or replicated
+	int32 EquipSlot;
+
+	uint32 EquipSerial;
+};
+
+
+/* Copy of every row in the item data table, shared by every Inventory Component */
+/* Per instance state lives in the Inventory elements, which only hold a handle to their row */
+/* A registry opened on an item catalog starts empty and copies a row from the catalog the first time Resolve() is given its ID */
+/* The const lookups never change the registry, so worker threads can use them on handles resolved before the work was dispatched */
+/* Owned by UItemRegistrySubsystem, which rebuilds it in place when its data table changes */
+class FItemDefinitionRegistry
+{
+public:
+
+	FItemDefinitionRegistry()
+	{
+		EmptyDefinition.ItemID = NAME_None;
+	}
+
+	// Copies every row of ItemTable, rows are stored in row map order
+	// Building again keeps every handle, rows already stored are overwritten in place and new rows are added after them
+	// Rows no longer in the table keep their definition so elements holding their handle still read it, FindHandle stops returning them
+	// Returns false without changing anything if the table's rows are not FInventoryItem
+	bool Build(const UDataTable& ItemTable);
+
+	// Reads definitions from the item catalog at Filename from now on, returns false if the file could not be opened
+	// Dedicated servers never decode display text or load thumbnails and meshes
+	bool OpenCatalog(const FString& Filename);
+
+	// Adds one definition without a data table, returns the existing handle if the ID was already added
+	FItemDefinitionHandle Add(const FInventoryItem& Definition);
+
+	// Same as FindHandle, and copies the row from the catalog when ID has not been looked up before
+	// Game thread only, Item IDs from pickups, transactions, replication and saves are resolved through here
+	FItemDefinitionHandle Resolve(FName ID);
+
+	// Only finds definitions already stored, safe on any thread while nothing calls Build, Add or Resolve
+	FItemDefinitionHandle FindHandle(FName ID) const;
+
+	const FInventoryItem* Find(FName ID) const;
+
+	// An invalid handle reads as an empty definition with no ID, weight or value, handles from another registry are not detected
+	const FInventoryItem& Get(FItemDefinitionHandle Handle) const { return IsValidHandle(Handle) ? Definitions[Handle.Index] : EmptyDefinition; }
+
+	bool IsValidHandle(FItemDefinitionHandle Handle) const { return (Handle.Index >= 0) && (Handle.Index < Definitions.Num()); }
+
+	// Full FInventoryItem of an element for Blueprint and UI code, the definition with the element's quantity and state copied over it
+	FInventoryItem MakeItemView(const FInventoryElement& Element) const;
+
+	// Definitions copied so far, only the ones that have been resolved for a catalog registry
+	int32 Num() const { return Definitions.Num(); }
+
+private:
+
+	// Stores Definition under a new handle, the caller has checked the ID is not already stored
+	FItemDefinitionHandle AddDefinition(const FInventoryItem& Definition);
+
+	// Copies ID's row from the catalog, game thread only
+	FItemDefinitionHandle AddFromCatalog(FName ID);
+
+	// Chunked so references returned by Get() stay valid while it grows
+	TChunkedArray<FInventoryItem> Definitions;
+
+	TMap<FName, int32> HandlesByID;
+
+	TMap<FName, int32> RemovedHandlesByID; // rows a rebuild no longer found, given their old handle back if they return
+
+	TSet<FName> MissingIDs; // IDs the catalog does not have, so they are not searched for again
+
+	FInventoryItem EmptyDefinition;
+
+	TUniquePtr<FItemCatalog> Catalog; // null for a registry built from a data table
+};
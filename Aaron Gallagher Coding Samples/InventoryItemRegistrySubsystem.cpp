@@ -0,0 +1,88 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+void UItemRegistrySubsystem::Deinitialize()
+{
+	for (TPair<TWeakObjectPtr<UDataTable>, FTableRegistry>& Pair : TableRegistries)
+	{
+		if (UDataTable* ItemTable = Pair.Key.Get()) ItemTable->OnDataTableChanged().Remove(Pair.Value.ChangedHandle);
+	}
+	TableRegistries.Empty();
+	CatalogRegistries.Empty();
+	Super::Deinitialize();
+}
+
+// Returns the subsystem of WorldContextObject's game instance, nullptr outside of a game instance
+UItemRegistrySubsystem* UItemRegistrySubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UItemRegistrySubsystem>() : nullptr;
+}
+
+// Returns the registry for ItemTable, building it the first time the table is seen
+// Returns nullptr if the table's rows are not FInventoryItem
+FItemDefinitionRegistry* UItemRegistrySubsystem::GetTableRegistry(UDataTable* ItemTable)
+{
+	check(IsInGameThread());
+	if (!ItemTable) return nullptr;
+	if (FTableRegistry* Existing = TableRegistries.Find(ItemTable))
+	{
+		return Existing->Registry.Get();
+	}
+
+	TUniquePtr<FItemDefinitionRegistry> Registry = MakeUnique<FItemDefinitionRegistry>();
+	if (!Registry->Build(*ItemTable))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Item table %s does not use FInventoryItem rows"), *ItemTable->GetName());
+		return nullptr;
+	}
+	RemoveStaleTables();
+	FTableRegistry& Entry = TableRegistries.Add(ItemTable);
+	Entry.Registry = MoveTemp(Registry);
+	Entry.ChangedHandle = ItemTable->OnDataTableChanged().AddUObject(this, &UItemRegistrySubsystem::OnTableChanged, TWeakObjectPtr<UDataTable>(ItemTable));
+	return Entry.Registry.Get();
+}
+
+// Returns the registry for the item catalog at Filename, opening it the first time the file is seen
+FItemDefinitionRegistry* UItemRegistrySubsystem::GetCatalogRegistry(const FString& Filename)
+{
+	check(IsInGameThread());
+	if (TUniquePtr<FItemDefinitionRegistry>* Existing = CatalogRegistries.Find(Filename))
+	{
+		return Existing->Get();
+	}
+
+	TUniquePtr<FItemDefinitionRegistry> Registry = MakeUnique<FItemDefinitionRegistry>();
+	if (!Registry->OpenCatalog(Filename))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Item catalog %s could not be opened"), *Filename);
+		return nullptr; // tried again next time, the file may not have been cooked yet
+	}
+	return CatalogRegistries.Add(Filename, MoveTemp(Registry)).Get();
+}
+
+// Bound to the table's OnDataTableChanged, rebuilds the registry without moving it
+// Inventory Components, simulations and batches keep their registry pointer and the handles in their elements, changed rows are read through the same handles
+// Game thread only, batches run and merge inside FlushBatch so no worker is reading the registry while it is rebuilt
+void UItemRegistrySubsystem::OnTableChanged(TWeakObjectPtr<UDataTable> ItemTable)
+{
+	check(IsInGameThread());
+	FTableRegistry* Found = TableRegistries.Find(ItemTable);
+	UDataTable* Table = ItemTable.Get();
+	if (!Found || !Table) return;
+	if (!Found->Registry->Build(*Table))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Item table %s no longer uses FInventoryItem rows, its registry keeps the rows it had"), *Table->GetName());
+	}
+}
+
+// Forgets registries of tables that were unloaded
+void UItemRegistrySubsystem::RemoveStaleTables()
+{
+	for (TMap<TWeakObjectPtr<UDataTable>, FTableRegistry>::TIterator It(TableRegistries); It; ++It)
+	{
+		if (!It.Key().IsValid()) It.RemoveCurrent();
+	}
+}
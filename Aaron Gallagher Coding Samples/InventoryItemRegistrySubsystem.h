@@ -0,0 +1,45 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Owns the item definition registries of the game instance, one per item data table and one per item catalog */
+/* A table's registry is rebuilt in place when the table changes, for example when it is reimported, so pointers and handles into it stay valid */
+/* Game thread only, every Inventory Component and the drop subsystem resolve their registry through here */
+UCLASS()
+class INVENTORY_API UItemRegistrySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	// Returns the subsystem of WorldContextObject's game instance, nullptr outside of a game instance
+	static UItemRegistrySubsystem* Get(const UObject* WorldContextObject);
+
+	// Returns the registry for ItemTable, building it the first time the table is seen
+	// Returns nullptr if the table's rows are not FInventoryItem
+	FItemDefinitionRegistry* GetTableRegistry(UDataTable* ItemTable);
+
+	// Returns the registry for the item catalog at Filename, opening it the first time the file is seen
+	FItemDefinitionRegistry* GetCatalogRegistry(const FString& Filename);
+
+private:
+
+	struct FTableRegistry
+	{
+		TUniquePtr<FItemDefinitionRegistry> Registry;
+		FDelegateHandle ChangedHandle;
+	};
+
+	// Bound to the table's OnDataTableChanged, rebuilds the registry without moving it
+	void OnTableChanged(TWeakObjectPtr<UDataTable> ItemTable);
+
+	// Forgets registries of tables that were unloaded
+	void RemoveStaleTables();
+
+	TMap<TWeakObjectPtr<UDataTable>, FTableRegistry> TableRegistries;
+
+	TMap<FString, TUniquePtr<FItemDefinitionRegistry>> CatalogRegistries;
+};
@@ -0,0 +1,205 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunInventoryItemStorageBenchmark(const TArray<FString>& Args);
+
+// Inventory.StorageBench <Elements> <Scans>, builds one Inventory as a TArray<FInventoryItem> and as FInventoryItemStorage and times adds, open stack searches and weight sums on both
+static FAutoConsoleCommandWithArgs GInventoryItemStorageBenchCommand(
+	TEXT("Inventory.StorageBench"),
+	TEXT("Inventory.StorageBench <Elements> <Scans>: times adding elements, searching for open stacks and summing weight with a TArray<FInventoryItem> against FInventoryItemStorage, and checks both agree"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunInventoryItemStorageBenchmark));
+#endif
+
+// Copies the hot fields of the definition into the arrays and keeps only the handle for the cold data
+int32 FInventoryItemStorage::Add(FItemDefinitionHandle Handle, int32 Quantity)
+{
+	if (!Registry || !Registry->IsValidHandle(Handle)) return INDEX_NONE;
+	const FInventoryItem& Row = Registry->Get(Handle);
+
+	uint8 NewFlags = IF_None;
+	if (Row.bIsStackable) NewFlags |= IF_Stackable;
+
+	ItemIDs.Add(Row.ItemID);
+	Quantities.Add(Quantity);
+	Weights.Add(Row.Weight);
+	Flags.Add(NewFlags);
+	Handles.Add(Handle);
+	return ModifiedStats.Add(Row.PickupCharacterStats);
+}
+
+// Removes one element, every element after Index is shifted down by one to keep the same order as the TArray version
+void FInventoryItemStorage::RemoveAt(int32 Index)
+{
+	if (!IsValidIndex(Index)) return;
+	ItemIDs.RemoveAt(Index);
+	Quantities.RemoveAt(Index);
+	Weights.RemoveAt(Index);
+	Flags.RemoveAt(Index);
+	Handles.RemoveAt(Index);
+	ModifiedStats.RemoveAt(Index);
+}
+
+void FInventoryItemStorage::Reset()
+{
+	ItemIDs.Reset();
+	Quantities.Reset();
+	Weights.Reset();
+	Flags.Reset();
+	Handles.Reset();
+	ModifiedStats.Reset();
+}
+
+// Only reads the ID and Quantity arrays
+int32 FInventoryItemStorage::FindOpenStack(FName ID, int32 MaxStackSize) const
+{
+	for (int32 i = 0; i < ItemIDs.Num(); i++)
+	{
+		if ((ItemIDs[i] == ID) && (Quantities[i] < MaxStackSize) && ((Flags[i] & (IF_Stackable | IF_Equipped)) == IF_Stackable))
+		{
+			return i;
+		}
+	}
+	return INDEX_NONE;
+}
+
+// Only reads the Weight and Quantity arrays
+float FInventoryItemStorage::GetTotalWeight() const
+{
+	float TotalWeight = 0.f;
+	for (int32 i = 0; i < Weights.Num(); i++)
+	{
+		TotalWeight += Weights[i] * Quantities[i];
+	}
+	return TotalWeight;
+}
+
+void FInventoryItemStorage::SetFlag(int32 Index, EItemFlags Flag, bool bValue)
+{
+	if (bValue) Flags[Index] |= Flag;
+	else Flags[Index] &= ~Flag;
+}
+
+void FInventoryItemStorage::SetModifiedStats(int32 Index, const FCharacterStats& Stats)
+{
+	ModifiedStats[Index] = Stats;
+	Flags[Index] |= (IF_Modified | IF_StatsSet);
+}
+
+// Rebuilds a full FInventoryItem from the definition and the element's own fields
+FInventoryItem FInventoryItemStorage::GetItemView(int32 Index) const
+{
+	FInventoryItem Item = Registry->Get(Handles[Index]);
+	Item.Quantity = Quantities[Index];
+	Item.bIsEquipped = HasFlag(Index, IF_Equipped);
+	Item.bIsModifiedItem = HasFlag(Index, IF_Modified);
+	Item.bHaveStatsBeenSet = HasFlag(Index, IF_StatsSet);
+	Item.PickupCharacterStats = ModifiedStats[Index];
+	return Item;
+}
+
+#if !UE_BUILD_SHIPPING
+// Every definition has display text of the length a real item has, the TArray copies it into each element the way AddInventoryElement does
+// Both containers get the same elements in the same order, so every search must find the same Index and both weights must match
+// Uses generated items so it runs without a World or an item data table
+static void RunInventoryItemStorageBenchmark(const TArray<FString>& Args)
+{
+	const int32 NumElements = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+	const int32 NumScans = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 200;
+	const int32 MaxStackSize = 20;
+	const int32 NumIDs = FMath::Max(NumElements / 8, 1);
+
+	FItemDefinitionRegistry Registry;
+	TArray<FItemDefinitionHandle> Handles;
+	for (int32 i = 0; i < NumIDs; i++)
+	{
+		FInventoryItem Definition;
+		Definition.ItemID = FName(TEXT("StorageItem"), i);
+		Definition.ItemName = FText::FromString(FString::Printf(TEXT("Storage Item %d"), i));
+		Definition.ItemDescription = FText::FromString(FString::Printf(TEXT("Generated item %d, its description is about as long as one written for a real item in the data table."), i));
+		Definition.Weight = 0.25f * (i % 9);
+		Definition.bIsStackable = (i % 4) != 0;
+		Handles.Add(Registry.Add(Definition));
+	}
+	FRandomStream Random(NumElements);
+	TArray<TPair<FItemDefinitionHandle, int32>> Adds;
+	for (int32 i = 0; i < NumElements; i++)
+	{
+		const int32 Quantity = (Random.RandHelper(4) == 0) ? Random.RandRange(1, MaxStackSize - 1) : MaxStackSize;
+		Adds.Emplace(Handles[Random.RandHelper(NumIDs)], Quantity);
+	}
+	TArray<FName> Searches;
+	for (int32 i = 0; i < NumScans; i++)
+	{
+		Searches.Add(Registry.Get(Handles[Random.RandHelper(NumIDs)]).ItemID);
+	}
+
+	TArray<FInventoryItem> Items;
+	double StartTime = FPlatformTime::Seconds();
+	for (const TPair<FItemDefinitionHandle, int32>& Add : Adds)
+	{
+		FInventoryItem& Item = Items.Add_GetRef(Registry.Get(Add.Key)); // copies the display text and asset pointers
+		Item.Quantity = Add.Value;
+	}
+	const double ArrayAddSeconds = FPlatformTime::Seconds() - StartTime;
+
+	FInventoryItemStorage Storage(&Registry);
+	StartTime = FPlatformTime::Seconds();
+	for (const TPair<FItemDefinitionHandle, int32>& Add : Adds)
+	{
+		Storage.Add(Add.Key, Add.Value);
+	}
+	const double StorageAddSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TArray<int32> ArrayFound;
+	StartTime = FPlatformTime::Seconds();
+	for (FName ID : Searches)
+	{
+		ArrayFound.Add(Items.IndexOfByPredicate([ID, MaxStackSize](const FInventoryItem& Item) { return (Item.ItemID == ID) && Item.bIsStackable && !Item.bIsEquipped && (Item.Quantity < MaxStackSize); }));
+	}
+	float ArrayWeight = 0.f;
+	for (int32 Scan = 0; Scan < NumScans; Scan++)
+	{
+		ArrayWeight = 0.f;
+		for (const FInventoryItem& Item : Items)
+		{
+			ArrayWeight += Item.Weight * Item.Quantity;
+		}
+	}
+	const double ArrayScanSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TArray<int32> StorageFound;
+	StartTime = FPlatformTime::Seconds();
+	for (FName ID : Searches)
+	{
+		StorageFound.Add(Storage.FindOpenStack(ID, MaxStackSize));
+	}
+	float StorageWeight = 0.f;
+	for (int32 Scan = 0; Scan < NumScans; Scan++)
+	{
+		StorageWeight = Storage.GetTotalWeight();
+	}
+	const double StorageScanSeconds = FPlatformTime::Seconds() - StartTime;
+
+	// The adapter has to give back the element the TArray holds, display text included
+	int32 NumBadViews = 0;
+	for (int32 i = 0; i < Items.Num(); i += FMath::Max(Items.Num() / 64, 1))
+	{
+		const FInventoryItem View = Storage.GetItemView(i);
+		if ((View.ItemID != Items[i].ItemID) || (View.Quantity != Items[i].Quantity) || !View.ItemDescription.EqualTo(Items[i].ItemDescription)) NumBadViews++;
+	}
+
+	const int32 ArrayBytes = (int32)sizeof(FInventoryItem);
+	const int32 HotBytes = (int32)(sizeof(FName) + sizeof(int32) + sizeof(float) + sizeof(uint8));
+	const int32 ColdBytes = (int32)(sizeof(FItemDefinitionHandle) + sizeof(FCharacterStats));
+	const bool bPassed = (ArrayFound == StorageFound) && FMath::IsNearlyEqual(ArrayWeight, StorageWeight, FMath::Max(ArrayWeight, 1.f) * 1e-5f) && (NumBadViews == 0);
+	UE_LOG(LogTemp, Log, TEXT("Inventory.StorageBench: %d elements, TArray %d bytes an element, storage %d hot and %d cold bytes an element"),
+		NumElements, ArrayBytes, HotBytes, ColdBytes);
+	UE_LOG(LogTemp, Log, TEXT("Inventory.StorageBench: adding TArray %.1f ns, storage %.1f ns an element, %.2fx"),
+		ArrayAddSeconds * 1e9 / NumElements, StorageAddSeconds * 1e9 / NumElements, (StorageAddSeconds > 0.0) ? (ArrayAddSeconds / StorageAddSeconds) : 0.0);
+	UE_LOG(LogTemp, Log, TEXT("Inventory.StorageBench: %d searches and %d weight sums, TArray %.3f ms, storage %.3f ms, %.2fx, %s"),
+		NumScans, NumScans, ArrayScanSeconds * 1000.0, StorageScanSeconds * 1000.0, (StorageScanSeconds > 0.0) ? (ArrayScanSeconds / StorageScanSeconds) : 0.0,
+		bPassed ? TEXT("passed") : TEXT("FAILED, the storage does not match the TArray"));
+}
+#endif
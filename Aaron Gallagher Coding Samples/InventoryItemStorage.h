@@ -0,0 +1,84 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Alternative to TArray<FInventoryItem> that keeps the fields touched by every Inventory scan in their own contiguous arrays */
+/* Display data (names, description, thumbnail, mesh and spawn classes) stays in the item definition registry and is only read through GetItemView() */
+/* Standalone, only Inventory.StorageBench builds one, UInventoryComponent keeps FInventoryElement in its shared core and builds views with FItemDefinitionRegistry::MakeItemView() */
+struct FInventoryItemStorage
+{
+public:
+
+	FInventoryItemStorage()
+	{
+		Registry = nullptr;
+	}
+
+	// Registry the definition handles of every element are resolved against, must outlive the storage
+	explicit FInventoryItemStorage(const FItemDefinitionRegistry* InRegistry)
+	{
+		Registry = InRegistry;
+	}
+
+	enum EItemFlags : uint8
+	{
+		IF_None = 0,
+		IF_Stackable = 1 << 0,
+		IF_Equipped = 1 << 1,
+		IF_Modified = 1 << 2,
+		IF_StatsSet = 1 << 3
+	};
+
+	// Copies the hot fields of the definition into the arrays and keeps only the handle for the cold data
+	int32 Add(FItemDefinitionHandle Handle, int32 Quantity);
+
+	// Removes one element, every element after Index is shifted down by one to keep the same order as the TArray version
+	void RemoveAt(int32 Index);
+
+	void Reset();
+
+	int32 Num() const { return ItemIDs.Num(); }
+
+	bool IsValidIndex(int32 Index) const { return ItemIDs.IsValidIndex(Index); }
+
+	// Only reads the ID and Quantity arrays
+	int32 FindOpenStack(FName ID, int32 MaxStackSize) const;
+
+	// Only reads the Weight and Quantity arrays
+	float GetTotalWeight() const;
+
+	FName GetItemID(int32 Index) const { return ItemIDs[Index]; }
+
+	FItemDefinitionHandle GetHandle(int32 Index) const { return Handles[Index]; }
+
+	int32 GetQuantity(int32 Index) const { return Quantities[Index]; }
+
+	void SetQuantity(int32 Index, int32 Quantity) { Quantities[Index] = Quantity; }
+
+	bool HasFlag(int32 Index, EItemFlags Flag) const { return (Flags[Index] & Flag) != 0; }
+
+	void SetFlag(int32 Index, EItemFlags Flag, bool bValue);
+
+	// Per instance stats, only meaningful when IF_Modified is set
+	const FCharacterStats& GetModifiedStats(int32 Index) const { return ModifiedStats[Index]; }
+
+	void SetModifiedStats(int32 Index, const FCharacterStats& Stats);
+
+	// Rebuilds a full FInventoryItem from the definition and the element's own fields
+	FInventoryItem GetItemView(int32 Index) const;
+
+private:
+
+	// Hot data, one entry per element
+	TArray<FName> ItemIDs;
+	TArray<int32> Quantities;
+	TArray<float> Weights;
+	TArray<uint8> Flags;
+
+	// Cold data, one entry per element
+	TArray<FItemDefinitionHandle> Handles; // definition holding the display data
+	TArray<FCharacterStats> ModifiedStats;
+
+	const FItemDefinitionRegistry* Registry;
+};
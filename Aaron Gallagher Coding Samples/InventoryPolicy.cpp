@@ -0,0 +1,177 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunInventoryPolicyBenchmark(const TArray<FString>& Args);
+
+// Inventory.PolicyBench <Operations>, runs one script through the Inventory core with each compile time policy and with runtime flags, and times both
+static FAutoConsoleCommandWithArgs GInventoryPolicyBenchCommand(
+	TEXT("Inventory.PolicyBench"),
+	TEXT("Inventory.PolicyBench <Operations>: times the Inventory core built with each compile time policy against the same core reading runtime flags"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunInventoryPolicyBenchmark));
+
+namespace InventoryPolicyBench
+{
+	const int32 InventorySize = 60;
+	const int32 MaxStackSize = 99;
+	const float WeightLimit = 400.f;
+
+	struct FOperation
+	{
+		FItemDefinitionHandle Handle;
+		int32 Index;
+		int32 Quantity;
+		uint8 Op; // 0 add, 1 remove, 2 equip
+	};
+
+	// Generated items, so the benchmark and tests run without a World or an item data table
+	void MakeRegistry(FItemDefinitionRegistry& Registry)
+	{
+		for (int32 i = 0; i < 64; i++)
+		{
+			FInventoryItem Definition;
+			Definition.ItemID = FName(TEXT("PolicyItem"), i);
+			Definition.bIsStackable = (i % 2) == 0;
+			Definition.bIsEquippable = (i % 5) == 0;
+			Definition.Weight = 0.25f * (i % 9);
+			Registry.Add(Definition);
+		}
+	}
+
+	TArray<FOperation> MakeScript(const FItemDefinitionRegistry& Registry, int32 NumOperations)
+	{
+		FRandomStream Random(NumOperations);
+		TArray<FOperation> Script;
+		for (int32 i = 0; i < NumOperations; i++)
+		{
+			FOperation& Operation = Script.AddDefaulted_GetRef();
+			Operation.Op = (uint8)((Random.RandHelper(10) < 6) ? 0 : Random.RandRange(1, 2));
+			Operation.Handle = FItemDefinitionHandle(Random.RandHelper(Registry.Num()));
+			Operation.Index = Random.RandHelper(InventorySize);
+			Operation.Quantity = Random.RandRange(1, 120);
+		}
+		return Script;
+	}
+
+	// Returns the total quantity AddItem could not fit
+	template<typename PolicyType>
+	int32 ApplyScript(TInventorySimulation<PolicyType>& Inventory, const TArray<FOperation>& Script)
+	{
+		int32 Leftover = 0;
+		for (const FOperation& Operation : Script)
+		{
+			if (Operation.Op == 0) Leftover += Inventory.AddItem(Operation.Handle, Operation.Quantity);
+			else if (Operation.Op == 1) Inventory.RemoveItem(Operation.Index, Operation.Quantity);
+			else Inventory.SetEquipped(Operation.Index, (Operation.Quantity % 2) == 0);
+		}
+		return Leftover;
+	}
+
+	// Runs Script against a new Inventory Repeats times, returns the digest of the last run and its leftover
+	template<typename PolicyType>
+	uint32 RunScript(const FItemDefinitionRegistry& Registry, const PolicyType& Policy, const TArray<FOperation>& Script, int32 Repeats, double& OutSeconds)
+	{
+		uint32 Digest = 0;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Repeat = 0; Repeat < Repeats; Repeat++)
+		{
+			TInventorySimulation<PolicyType> Inventory(&Registry, InventorySize, MaxStackSize, WeightLimit, Policy);
+			const int32 Leftover = ApplyScript(Inventory, Script);
+			Digest = HashCombine(Inventory.GetDigest(), GetTypeHash(Leftover));
+		}
+		OutSeconds = FPlatformTime::Seconds() - StartTime;
+		return Digest;
+	}
+
+	// Times one compile time policy against the runtime flags it stands for
+	template<typename PolicyType>
+	void Compare(const TCHAR* Name, const FItemDefinitionRegistry& Registry, const FInventoryRuntimePolicy& RuntimePolicy, const TArray<FOperation>& Script, int32 Repeats)
+	{
+		double PolicySeconds = 0.0;
+		double RuntimeSeconds = 0.0;
+		const uint32 PolicyDigest = RunScript(Registry, PolicyType(), Script, Repeats, PolicySeconds);
+		const uint32 RuntimeDigest = RunScript(Registry, RuntimePolicy, Script, Repeats, RuntimeSeconds);
+		UE_LOG(LogTemp, Log, TEXT("Inventory.PolicyBench: %s %.3f ms, runtime flags %.3f ms, %.2fx%s"), Name, PolicySeconds * 1000.0, RuntimeSeconds * 1000.0,
+			(PolicySeconds > 0.0) ? (RuntimeSeconds / PolicySeconds) : 0.0, (PolicyDigest == RuntimeDigest) ? TEXT("") : TEXT(", the Inventories differ, run Inventory.Policy in the automation tests"));
+	}
+}
+
+static void RunInventoryPolicyBenchmark(const TArray<FString>& Args)
+{
+	using namespace InventoryPolicyBench;
+	const int32 NumOperations = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 4096;
+	const int32 Repeats = 64;
+
+	FItemDefinitionRegistry Registry;
+	MakeRegistry(Registry);
+	const TArray<FOperation> Script = MakeScript(Registry, NumOperations);
+
+	Compare<FDynamicInventoryPolicy>(TEXT("dynamic policy"), Registry, FInventoryRuntimePolicy(false, EInventoryWeightRule::AllowOverweight), Script, Repeats);
+	Compare<FStaticInventoryPolicy>(TEXT("static policy"), Registry, FInventoryRuntimePolicy(true, EInventoryWeightRule::AllowOverweight), Script, Repeats);
+	Compare<FWeightCappedInventoryPolicy>(TEXT("weight capped policy"), Registry, FInventoryRuntimePolicy(false, EInventoryWeightRule::DropOverweight), Script, Repeats);
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryPolicyMatchesRuntimeFlagsTest, "Inventory.Policy.MatchesRuntimeFlags", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// Every compile time policy must leave the same Inventory and leftover as the runtime flags it replaces
+bool FInventoryPolicyMatchesRuntimeFlagsTest::RunTest(const FString& Parameters)
+{
+	using namespace InventoryPolicyBench;
+	FItemDefinitionRegistry Registry;
+	MakeRegistry(Registry);
+	const TArray<FOperation> Script = MakeScript(Registry, 4096);
+
+	double Seconds = 0.0;
+	TestEqual(TEXT("Dynamic policy digest"), RunScript(Registry, FDynamicInventoryPolicy(), Script, 1, Seconds),
+		RunScript(Registry, FInventoryRuntimePolicy(false, EInventoryWeightRule::AllowOverweight), Script, 1, Seconds));
+	TestEqual(TEXT("Static policy digest"), RunScript(Registry, FStaticInventoryPolicy(), Script, 1, Seconds),
+		RunScript(Registry, FInventoryRuntimePolicy(true, EInventoryWeightRule::AllowOverweight), Script, 1, Seconds));
+	TestEqual(TEXT("Weight capped policy digest"), RunScript(Registry, FWeightCappedInventoryPolicy(), Script, 1, Seconds),
+		RunScript(Registry, FInventoryRuntimePolicy(false, EInventoryWeightRule::DropOverweight), Script, 1, Seconds));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryPolicyStaticLayoutTest, "Inventory.Policy.StaticLayout", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// A static layout never changes its slot count, and an emptied slot is the next one filled
+bool FInventoryPolicyStaticLayoutTest::RunTest(const FString& Parameters)
+{
+	using namespace InventoryPolicyBench;
+	FItemDefinitionRegistry Registry;
+	MakeRegistry(Registry);
+
+	TInventorySimulation<FStaticInventoryPolicy> Inventory(&Registry, InventorySize, MaxStackSize, WeightLimit);
+	TestEqual(TEXT("Empty slots"), Inventory.GetFreeSlotCount(), InventorySize);
+	ApplyScript(Inventory, MakeScript(Registry, 4096));
+	TestEqual(TEXT("Slots after the script"), Inventory.GetInventory().Num(), InventorySize);
+
+	const FItemDefinitionHandle Unstackable(1);
+	TInventorySimulation<FStaticInventoryPolicy> Refill(&Registry, InventorySize, MaxStackSize, 0.f);
+	TestEqual(TEXT("Unstackable leftover"), Refill.AddItem(Unstackable, 3), 0);
+	TestTrue(TEXT("Removed the middle element"), Refill.RemoveItem(1, 1));
+	TestFalse(TEXT("Emptied slot is kept"), Refill.GetInventory()[1].Handle.IsValid());
+	Refill.AddItem(Unstackable, 1);
+	TestTrue(TEXT("Emptied slot is filled first"), Refill.GetInventory()[1].Handle == Unstackable);
+	TestEqual(TEXT("Slots after refilling"), Refill.GetInventory().Num(), InventorySize);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryPolicyWeightCapTest, "Inventory.Policy.WeightCap", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// Dropping what would go over the weight limit, the Inventory must never end up over weight
+bool FInventoryPolicyWeightCapTest::RunTest(const FString& Parameters)
+{
+	using namespace InventoryPolicyBench;
+	FItemDefinitionRegistry Registry;
+	MakeRegistry(Registry);
+
+	TInventorySimulation<FWeightCappedInventoryPolicy> Inventory(&Registry, InventorySize, MaxStackSize, WeightLimit);
+	ApplyScript(Inventory, MakeScript(Registry, 4096));
+	TestTrue(TEXT("Carried weight is under the limit"), Inventory.GetEncumbrance().GetTotalWeight() <= WeightLimit);
+	TestFalse(TEXT("Over weight"), Inventory.GetEncumbrance().IsOverweight());
+	return true;
+}
+#endif
+#endif
@@ -0,0 +1,69 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+// Selects the Inventory Component's layout for the build, define it to 1 to give every Inventory fixed slots that are filled and emptied in place
+// Replaces checking IsInventoryStatic() on every add, the layout is a constant each configuration compiles its add path against
+#ifndef WITH_STATIC_INVENTORY
+#define WITH_STATIC_INVENTORY 0
+#endif
+
+
+/* What an add does with the quantity that would take the Inventory over its weight limit */
+enum class EInventoryWeightRule : uint8
+{
+	AllowOverweight, // everything is added and the Inventory is flagged as over weight, the Inventory Component's rule
+	DropOverweight, // only the quantity that fits under the limit is added, the rest is handed back like any other leftover
+};
+
+
+/* Inventory rules fixed at compile time, every check TInventorySimulation makes on them is a constant the compiler folds away */
+/* bInIsStatic gives the Inventory fixed slots that are filled and emptied in place */
+/* The stack size is not part of the policy, it is the component's MaxStackSize and is set per asset through Configure */
+template<bool bInIsStatic, EInventoryWeightRule InWeightRule>
+struct TInventoryPolicy
+{
+	static constexpr bool IsStatic() { return bInIsStatic; }
+
+	static constexpr EInventoryWeightRule GetWeightRule() { return InWeightRule; }
+};
+
+// The Inventory Component's two layouts with its weight rule
+typedef TInventoryPolicy<false, EInventoryWeightRule::AllowOverweight> FDynamicInventoryPolicy;
+typedef TInventoryPolicy<true, EInventoryWeightRule::AllowOverweight> FStaticInventoryPolicy;
+
+// Dynamic layout that never goes over its weight limit
+typedef TInventoryPolicy<false, EInventoryWeightRule::DropOverweight> FWeightCappedInventoryPolicy;
+
+// The policy UInventoryComponent, replays and batched jobs run with in this build
+typedef TInventoryPolicy<WITH_STATIC_INVENTORY != 0, EInventoryWeightRule::AllowOverweight> FInventoryComponentPolicy;
+
+
+/* The same rules read from members at runtime, the way the Inventory Component checked them on every add */
+/* Only used to measure and check the compile time policies against */
+struct FInventoryRuntimePolicy
+{
+public:
+
+	FInventoryRuntimePolicy()
+	{
+		bIsStatic = false;
+		WeightRule = EInventoryWeightRule::AllowOverweight;
+	}
+
+	FInventoryRuntimePolicy(bool bInIsStatic, EInventoryWeightRule InWeightRule)
+	{
+		bIsStatic = bInIsStatic;
+		WeightRule = InWeightRule;
+	}
+
+	bool IsStatic() const { return bIsStatic; }
+
+	EInventoryWeightRule GetWeightRule() const { return WeightRule; }
+
+private:
+
+	bool bIsStatic;
+
+	EInventoryWeightRule WeightRule;
+};
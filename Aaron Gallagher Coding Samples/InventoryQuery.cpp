@@ -0,0 +1,409 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunInventoryQueryBenchmark(const TArray<FString>& Args);
+
+static FAutoConsoleCommandWithArgs GInventoryQueryBenchCommand(
+	TEXT("Inventory.QueryBench"),
+	TEXT("Inventory.QueryBench <Iterations>: times typical UI and AI queries on 50, 500 and 50000 item inventories, indexed against a linear walk, then checks the indexes after random changes"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunInventoryQueryBenchmark));
+#endif
+
+// Clears the indexes and refills them from every element of the Inventory
+void FInventoryQueryIndex::Rebuild(const TArray<FInventoryElement>& Inventory, const FItemDefinitionRegistry& Registry)
+{
+	Slots.Reset(Inventory.Num());
+	SlotsByType.Reset();
+	EquippedSlots.Reset();
+	for (int32 k = 0; k < NumSortKeys; k++)
+	{
+		SortedSlots[k].Reset(Inventory.Num());
+	}
+
+	// Appending in element order keeps the per type and equipped lists sorted, the sort key lists are sorted once at the end
+	for (int32 i = 0; i < Inventory.Num(); i++)
+	{
+		const FSlotEntry& Entry = Slots.Add_GetRef(MakeEntry(Inventory[i], Registry.Get(Inventory[i].Handle)));
+		SlotsByType.FindOrAdd(Entry.ItemType).Add(i);
+		if (Entry.bIsEquipped) EquippedSlots.Add(i);
+		for (int32 k = 0; k < NumSortKeys; k++)
+		{
+			SortedSlots[k].Add({ Entry.Keys[k], i });
+		}
+	}
+	for (int32 k = 0; k < NumSortKeys; k++)
+	{
+		SortedSlots[k].Sort();
+	}
+	bIsBuilt = true;
+}
+
+// Called after an element is added to the end of the Inventory, Definition is the registry entry of its handle
+void FInventoryQueryIndex::OnSlotAdded(const FInventoryElement& Element, const FInventoryItem& Definition, int32 Index)
+{
+	if (!bIsBuilt) return;
+	if (Index != Slots.Num())
+	{
+		Invalidate(); // only appends are tracked, anything else rebuilds on the next query
+		return;
+	}
+	const FSlotEntry& Entry = Slots.Add_GetRef(MakeEntry(Element, Definition));
+	AddToIndexes(Entry, Index);
+}
+
+// Called after an element changes, only type, equipped state, value, weight or stat changes touch the indexes
+void FInventoryQueryIndex::OnSlotChanged(const FInventoryElement& Element, const FInventoryItem& Definition, int32 Index)
+{
+	if (!bIsBuilt) return;
+	if (!Slots.IsValidIndex(Index))
+	{
+		Invalidate();
+		return;
+	}
+	const FSlotEntry Entry = MakeEntry(Element, Definition);
+	if (Entry == Slots[Index]) return; // a Quantity change, which nothing is sorted by
+	RemoveFromIndexes(Slots[Index], Index);
+	Slots[Index] = Entry;
+	AddToIndexes(Entry, Index);
+}
+
+// Called when an element is removed from the Inventory, every element after Index is shifted down by one
+void FInventoryQueryIndex::OnSlotRemoved(int32 Index)
+{
+	if (!bIsBuilt) return;
+	if (!Slots.IsValidIndex(Index))
+	{
+		Invalidate();
+		return;
+	}
+	RemoveFromIndexes(Slots[Index], Index);
+	Slots.RemoveAt(Index);
+
+	// Shifting every later index down by one keeps each list in the same order, so nothing has to be re-sorted
+	for (TPair<EItemType, TArray<int32>>& Pair : SlotsByType)
+	{
+		for (int32& SlotIndex : Pair.Value)
+		{
+			if (SlotIndex > Index) --SlotIndex;
+		}
+	}
+	for (int32& SlotIndex : EquippedSlots)
+	{
+		if (SlotIndex > Index) --SlotIndex;
+	}
+	for (int32 k = 0; k < NumSortKeys; k++)
+	{
+		for (FSortedSlot& Sorted : SortedSlots[k])
+		{
+			if (Sorted.Index > Index) --Sorted.Index;
+		}
+	}
+}
+
+// Fills OutIndices with the Inventory indices that match Query, in the order Query asks for
+// Starts from the smallest index that every result has to be in, and walks a sorted index instead of sorting whenever that is cheaper
+void FInventoryQueryIndex::Run(const TArray<FInventoryElement>& Inventory, const FItemDefinitionRegistry& Registry, const FInventoryQuery& Query, TArray<int32>& OutIndices) const
+{
+	OutIndices.Reset();
+	if (!bIsBuilt || Slots.Num() != Inventory.Num())
+	{
+		RunLinear(Inventory, Registry, Query, OutIndices);
+		return;
+	}
+	const int32 MaxResults = (Query.MaxResults > 0) ? Query.MaxResults : MAX_int32;
+
+	const TArray<int32>* Candidates = nullptr;
+	if (Query.EquippedFilter == EInventoryEquippedFilter::IEF_Equipped)
+	{
+		Candidates = &EquippedSlots;
+	}
+	if (Query.bFilterByType)
+	{
+		const TArray<int32>* TypeSlots = SlotsByType.Find(Query.ItemType);
+		if (!TypeSlots) return;
+		if (!Candidates || TypeSlots->Num() < Candidates->Num()) Candidates = TypeSlots;
+	}
+
+	if (Query.SortKey == EInventorySortKey::ISK_None || Query.SortKey == EInventorySortKey::ISK_MAX)
+	{
+		if (!Candidates)
+		{
+			RunLinear(Inventory, Registry, Query, OutIndices); // nothing to narrow the search with
+			return;
+		}
+		int32 Scanned = 0;
+		for (int32 Index : *Candidates)
+		{
+			++Scanned;
+			if (!Matches(Inventory[Index], Registry.Get(Inventory[Index].Handle), Query)) continue;
+			OutIndices.Add(Index);
+			if (OutIndices.Num() == MaxResults) break;
+		}
+		GAMEPLAY_PROFILE_COUNT(ItemsScanned, Scanned);
+		return;
+	}
+
+	const int32 SortKeyIndex = (int32)Query.SortKey - 1;
+	const TArray<FSortedSlot>& Sorted = SortedSlots[SortKeyIndex];
+
+	// A small candidate list is cheaper to filter and sort than walking the whole sorted index past everything it filters out
+	if (Candidates && (Candidates->Num() * 8 <= Sorted.Num()))
+	{
+		GAMEPLAY_PROFILE_COUNT(ItemsScanned, Candidates->Num());
+		for (int32 Index : *Candidates)
+		{
+			if (Matches(Inventory[Index], Registry.Get(Inventory[Index].Handle), Query)) OutIndices.Add(Index);
+		}
+		OutIndices.Sort([this, SortKeyIndex, &Query](int32 A, int32 B)
+		{
+			const FSortedSlot SlotA = { Slots[A].Keys[SortKeyIndex], A };
+			const FSortedSlot SlotB = { Slots[B].Keys[SortKeyIndex], B };
+			return Query.bDescending ? (SlotB < SlotA) : (SlotA < SlotB);
+		});
+		if (OutIndices.Num() > MaxResults) OutIndices.SetNum(MaxResults, false);
+		return;
+	}
+
+	// Sorted by value, anything above MaxValue can be skipped without looking at it
+	int32 End = Sorted.Num();
+	if (Query.SortKey == EInventorySortKey::ISK_Value && Query.MaxValue >= 0)
+	{
+		End = Algo::UpperBoundBy(Sorted, (float)Query.MaxValue, [](const FSortedSlot& Slot) { return Slot.Key; });
+	}
+	int32 Scanned = 0;
+	for (int32 i = 0; i < End; i++)
+	{
+		const int32 Index = Sorted[Query.bDescending ? (End - 1 - i) : i].Index;
+		++Scanned;
+		if (!Matches(Inventory[Index], Registry.Get(Inventory[Index].Handle), Query)) continue;
+		OutIndices.Add(Index);
+		if (OutIndices.Num() == MaxResults) break;
+	}
+	GAMEPLAY_PROFILE_COUNT(ItemsScanned, Scanned);
+}
+
+// Walks the whole Inventory, what UI and AI code did before the indexes existed
+// Returns the same indices in the same order as Run()
+void FInventoryQueryIndex::RunLinear(const TArray<FInventoryElement>& Inventory, const FItemDefinitionRegistry& Registry, const FInventoryQuery& Query, TArray<int32>& OutIndices)
+{
+	OutIndices.Reset();
+	GAMEPLAY_PROFILE_COUNT(ItemsScanned, Inventory.Num());
+	for (int32 i = 0; i < Inventory.Num(); i++)
+	{
+		if (Matches(Inventory[i], Registry.Get(Inventory[i].Handle), Query)) OutIndices.Add(i);
+	}
+	if (Query.SortKey != EInventorySortKey::ISK_None && Query.SortKey != EInventorySortKey::ISK_MAX)
+	{
+		OutIndices.Sort([&Inventory, &Registry, &Query](int32 A, int32 B)
+		{
+			const FSortedSlot SlotA = { GetSortKey(Inventory[A], Registry.Get(Inventory[A].Handle), Query.SortKey), A };
+			const FSortedSlot SlotB = { GetSortKey(Inventory[B], Registry.Get(Inventory[B].Handle), Query.SortKey), B };
+			return Query.bDescending ? (SlotB < SlotA) : (SlotA < SlotB);
+		});
+	}
+	if (Query.MaxResults > 0 && OutIndices.Num() > Query.MaxResults) OutIndices.SetNum(Query.MaxResults, false);
+}
+
+// Value and weight come from the definition, stats from the element when it was modified
+float FInventoryQueryIndex::GetSortKey(const FInventoryElement& Element, const FInventoryItem& Definition, EInventorySortKey SortKey)
+{
+	const FCharacterStats& Stats = Element.GetStats(Definition);
+	switch (SortKey)
+	{
+	case EInventorySortKey::ISK_Value:			return (float)Definition.ItemValue;
+	case EInventorySortKey::ISK_Weight:			return Definition.Weight;
+	case EInventorySortKey::ISK_Armor:			return (float)Stats.Armor;
+	case EInventorySortKey::ISK_PhysicalAttack:	return (float)Stats.PhysicalAttack;
+	case EInventorySortKey::ISK_Fortitude:		return (float)Stats.Fortitude;
+	case EInventorySortKey::ISK_Agility:		return (float)Stats.Agility;
+	case EInventorySortKey::ISK_MagicAttack:	return (float)Stats.MagicAttack;
+	case EInventorySortKey::ISK_DamageAmount:	return Stats.DamageAmount;
+	default:									return 0.f;
+	}
+}
+
+FInventoryQueryIndex::FSlotEntry FInventoryQueryIndex::MakeEntry(const FInventoryElement& Element, const FInventoryItem& Definition)
+{
+	FSlotEntry Entry;
+	for (int32 k = 0; k < NumSortKeys; k++)
+	{
+		Entry.Keys[k] = GetSortKey(Element, Definition, (EInventorySortKey)(k + 1));
+	}
+	Entry.ItemType = Definition.ItemType;
+	Entry.bIsEquipped = Element.bIsEquipped;
+	return Entry;
+}
+
+bool FInventoryQueryIndex::Matches(const FInventoryElement& Element, const FInventoryItem& Definition, const FInventoryQuery& Query)
+{
+	if (!Element.Handle.IsValid()) return false; // an empty slot of a static layout
+	if (Query.bFilterByType && Definition.ItemType != Query.ItemType) return false;
+	if (Query.EquippedFilter == EInventoryEquippedFilter::IEF_Equipped && !Element.bIsEquipped) return false;
+	if (Query.EquippedFilter == EInventoryEquippedFilter::IEF_Unequipped && Element.bIsEquipped) return false;
+	if (Query.bEquippableOnly && !Definition.bIsEquippable) return false;
+	if (Query.MaxValue >= 0 && Definition.ItemValue > Query.MaxValue) return false;
+	return true;
+}
+
+void FInventoryQueryIndex::AddToIndexes(const FSlotEntry& Entry, int32 Index)
+{
+	TArray<int32>& TypeSlots = SlotsByType.FindOrAdd(Entry.ItemType);
+	TypeSlots.Insert(Index, Algo::LowerBound(TypeSlots, Index));
+	if (Entry.bIsEquipped) EquippedSlots.Insert(Index, Algo::LowerBound(EquippedSlots, Index));
+	for (int32 k = 0; k < NumSortKeys; k++)
+	{
+		const FSortedSlot Sorted = { Entry.Keys[k], Index };
+		SortedSlots[k].Insert(Sorted, Algo::LowerBound(SortedSlots[k], Sorted));
+	}
+}
+
+void FInventoryQueryIndex::RemoveFromIndexes(const FSlotEntry& Entry, int32 Index)
+{
+	if (TArray<int32>* TypeSlots = SlotsByType.Find(Entry.ItemType))
+	{
+		const int32 Found = Algo::BinarySearch(*TypeSlots, Index);
+		if (Found != INDEX_NONE) TypeSlots->RemoveAt(Found, 1, false);
+		if (TypeSlots->Num() == 0) SlotsByType.Remove(Entry.ItemType);
+	}
+	if (Entry.bIsEquipped)
+	{
+		const int32 Found = Algo::BinarySearch(EquippedSlots, Index);
+		if (Found != INDEX_NONE) EquippedSlots.RemoveAt(Found, 1, false);
+	}
+	for (int32 k = 0; k < NumSortKeys; k++)
+	{
+		const int32 Found = Algo::BinarySearch(SortedSlots[k], FSortedSlot{ Entry.Keys[k], Index });
+		if (Found != INDEX_NONE) SortedSlots[k].RemoveAt(Found, 1, false);
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+// Inventory.QueryBench <Iterations>, times typical UI and AI queries on 50, 500 and 50000 item inventories, indexed against a linear walk
+// Also checks that both return the same indices, before and after a run of adds, changes and removes kept in sync through the slot callbacks
+static void RunInventoryQueryBenchmark(const TArray<FString>& Args)
+{
+	const int32 Iterations = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100;
+	const int32 InventorySizes[] = { 50, 500, 50000 };
+	const int32 NumItemTypes = 4; // the first few EItemType values
+
+	FInventoryQuery EquippableByAttack; // UI list: equippable items of one type, strongest first
+	EquippableByAttack.bFilterByType = true;
+	EquippableByAttack.ItemType = (EItemType)1;
+	EquippableByAttack.bEquippableOnly = true;
+	EquippableByAttack.SortKey = EInventorySortKey::ISK_PhysicalAttack;
+	EquippableByAttack.bDescending = true;
+
+	FInventoryQuery BestAffordableArmor; // AI: best armor the character can afford
+	BestAffordableArmor.bFilterByType = true;
+	BestAffordableArmor.ItemType = (EItemType)2;
+	BestAffordableArmor.MaxValue = 500;
+	BestAffordableArmor.SortKey = EInventorySortKey::ISK_Armor;
+	BestAffordableArmor.bDescending = true;
+	BestAffordableArmor.MaxResults = 1;
+
+	FInventoryQuery Equipped; // equipment screen
+	Equipped.EquippedFilter = EInventoryEquippedFilter::IEF_Equipped;
+
+	FInventoryQuery CheapestFirst; // vendor sell list
+	CheapestFirst.SortKey = EInventorySortKey::ISK_Value;
+	CheapestFirst.MaxResults = 20;
+
+	const FInventoryQuery* Queries[] = { &EquippableByAttack, &BestAffordableArmor, &Equipped, &CheapestFirst };
+	const TCHAR* QueryNames[] = { TEXT("EquippableByAttack"), TEXT("BestAffordableArmor"), TEXT("Equipped"), TEXT("CheapestFirst") };
+
+	FRandomStream Random(1234);
+
+	for (int32 InventorySize : InventorySizes)
+	{
+		// Every element gets a definition of its own, so values, weights and stats are spread the same as before elements shared definitions
+		FItemDefinitionRegistry Registry;
+		auto MakeElement = [&Random, &Registry, NumItemTypes](int32 Seed)
+		{
+			FInventoryItem Definition;
+			Definition.ItemID = FName(TEXT("BenchItem"), Registry.Num());
+			Definition.ItemType = (EItemType)(Seed % NumItemTypes);
+			Definition.ItemValue = Random.RandRange(1, 1000);
+			Definition.Weight = Random.FRandRange(0.1f, 20.f);
+			Definition.bIsEquippable = Random.FRand() < 0.5f;
+			Definition.PickupCharacterStats.Armor = Random.RandRange(0, 100);
+			Definition.PickupCharacterStats.PhysicalAttack = Random.RandRange(0, 100);
+			FInventoryElement Element(Registry.Add(Definition), 1);
+			Element.bIsEquipped = Definition.bIsEquippable && (Seed % 97 == 0);
+			return Element;
+		};
+
+		TArray<FInventoryElement> Inventory;
+		Inventory.Reserve(InventorySize);
+		for (int32 i = 0; i < InventorySize; i++)
+		{
+			Inventory.Add(MakeElement(i));
+		}
+
+		FInventoryQueryIndex QueryIndex;
+		const double BuildStart = FPlatformTime::Seconds();
+		QueryIndex.Rebuild(Inventory, Registry);
+		const double BuildTime = FPlatformTime::Seconds() - BuildStart;
+		UE_LOG(LogTemp, Log, TEXT("Inventory.QueryBench: %d items, index built in %.3f ms"), InventorySize, BuildTime * 1000.0);
+
+		TArray<int32> LinearResults;
+		TArray<int32> IndexedResults;
+		for (int32 q = 0; q < UE_ARRAY_COUNT(Queries); q++)
+		{
+			const double LinearStart = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Iterations; i++)
+			{
+				FInventoryQueryIndex::RunLinear(Inventory, Registry, *Queries[q], LinearResults);
+			}
+			const double IndexedStart = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Iterations; i++)
+			{
+				QueryIndex.Run(Inventory, Registry, *Queries[q], IndexedResults);
+			}
+			const double IndexedEnd = FPlatformTime::Seconds();
+
+			UE_LOG(LogTemp, Log, TEXT("Inventory.QueryBench: %d items, %s: linear %.4f ms, indexed %.4f ms, %d results%s"),
+				InventorySize, QueryNames[q], (IndexedStart - LinearStart) * 1000.0 / Iterations, (IndexedEnd - IndexedStart) * 1000.0 / Iterations,
+				IndexedResults.Num(), (LinearResults == IndexedResults) ? TEXT("") : TEXT(" MISMATCH"));
+		}
+
+		// Loot, sell, equip and reroll changes in the mix the component reports them, the index must answer like a linear walk afterwards
+		const int32 NumChanges = FMath::Min(InventorySize, 1000);
+		const double ChangesStart = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumChanges; i++)
+		{
+			const int32 Roll = Random.RandHelper(4);
+			if (Roll == 0 || Inventory.Num() == 0)
+			{
+				const int32 Index = Inventory.Add(MakeElement(Inventory.Num() + i));
+				QueryIndex.OnSlotAdded(Inventory[Index], Registry.Get(Inventory[Index].Handle), Index);
+			}
+			else if (Roll == 1)
+			{
+				const int32 Index = Random.RandHelper(Inventory.Num());
+				QueryIndex.OnSlotRemoved(Index);
+				Inventory.RemoveAt(Index);
+			}
+			else
+			{
+				const int32 Index = Random.RandHelper(Inventory.Num());
+				if (Roll == 2) Inventory[Index].bIsEquipped = Registry.Get(Inventory[Index].Handle).bIsEquippable && !Inventory[Index].bIsEquipped;
+				else Inventory[Index] = MakeElement(Index + i);
+				QueryIndex.OnSlotChanged(Inventory[Index], Registry.Get(Inventory[Index].Handle), Index);
+			}
+		}
+		const double ChangesTime = FPlatformTime::Seconds() - ChangesStart;
+
+		int32 NumMismatches = 0;
+		for (const FInventoryQuery* Query : Queries)
+		{
+			FInventoryQueryIndex::RunLinear(Inventory, Registry, *Query, LinearResults);
+			QueryIndex.Run(Inventory, Registry, *Query, IndexedResults);
+			if (!QueryIndex.IsBuilt() || LinearResults != IndexedResults) NumMismatches++;
+		}
+		UE_LOG(LogTemp, Log, TEXT("Inventory.QueryBench: %d items, %d changes at %.1f us a change, %d queries differ from a linear walk afterwards, %s"),
+			InventorySize, NumChanges, ChangesTime * 1e6 / NumChanges, NumMismatches, (NumMismatches == 0) ? TEXT("passed") : TEXT("FAILED"));
+	}
+}
+#endif
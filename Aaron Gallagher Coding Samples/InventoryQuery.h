@@ -0,0 +1,162 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+UENUM(BlueprintType)
+enum class EInventorySortKey : uint8
+{
+	ISK_None			UMETA(DisplayName = "Inventory Order"),
+	ISK_Value			UMETA(DisplayName = "Value"),
+	ISK_Weight			UMETA(DisplayName = "Weight"),
+	ISK_Armor			UMETA(DisplayName = "Armor"),
+	ISK_PhysicalAttack	UMETA(DisplayName = "Physical Attack"),
+	ISK_Fortitude		UMETA(DisplayName = "Fortitude"),
+	ISK_Agility			UMETA(DisplayName = "Agility"),
+	ISK_MagicAttack		UMETA(DisplayName = "Magic Attack"),
+	ISK_DamageAmount	UMETA(DisplayName = "Damage Amount"),
+	ISK_MAX				UMETA(Hidden)
+};
+
+UENUM(BlueprintType)
+enum class EInventoryEquippedFilter : uint8
+{
+	IEF_Any				UMETA(DisplayName = "Any"),
+	IEF_Equipped		UMETA(DisplayName = "Equipped"),
+	IEF_Unequipped		UMETA(DisplayName = "Unequipped")
+};
+
+
+/* Filter and sort used by UI and AI code instead of walking the Inventory themselves */
+/* e.g. the best armor the character can afford is ItemType Armor, MaxValue gold, SortKey Armor, descending, MaxResults 1 */
+USTRUCT(BlueprintType)
+struct FInventoryQuery
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	FInventoryQuery()
+	{
+		bFilterByType = false;
+		ItemType = EItemType::ET_NONE;
+		EquippedFilter = EInventoryEquippedFilter::IEF_Any;
+		bEquippableOnly = false;
+		MaxValue = -1;
+		SortKey = EInventorySortKey::ISK_None;
+		bDescending = false;
+		MaxResults = 0;
+	}
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Query")
+		bool bFilterByType;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Query")
+		EItemType ItemType; // only used when bFilterByType is set
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Query")
+		EInventoryEquippedFilter EquippedFilter;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Query")
+		bool bEquippableOnly;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Query")
+		int32 MaxValue; // negative for no limit
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Query")
+		EInventorySortKey SortKey;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Query")
+		bool bDescending; // equal keys come out in the reverse of the ascending order
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Query")
+		int32 MaxResults; // 0 for every match
+};
+
+
+/* Secondary indexes over the Inventory by item type, equipped state and every sort key, kept in sync by the same slot callbacks as FInventoryStackIndex */
+/* Built the first time a query runs, until then the callbacks do nothing */
+/* Only uses Core containers so it can be built and driven without a World */
+class FInventoryQueryIndex
+{
+public:
+
+	FInventoryQueryIndex()
+	{
+		bIsBuilt = false;
+	}
+
+	// Clears the indexes and refills them from every element of the Inventory
+	void Rebuild(const TArray<FInventoryElement>& Inventory, const FItemDefinitionRegistry& Registry);
+
+	// Called after an element is added to the end of the Inventory, Definition is the registry entry of its handle
+	void OnSlotAdded(const FInventoryElement& Element, const FInventoryItem& Definition, int32 Index);
+
+	// Called after an element changes, only type, equipped state, value, weight or stat changes touch the indexes
+	void OnSlotChanged(const FInventoryElement& Element, const FInventoryItem& Definition, int32 Index);
+
+	// Called when an element is removed from the Inventory, every element after Index is shifted down by one
+	void OnSlotRemoved(int32 Index);
+
+	// Fills OutIndices with the Inventory indices that match Query, in the order Query asks for
+	void Run(const TArray<FInventoryElement>& Inventory, const FItemDefinitionRegistry& Registry, const FInventoryQuery& Query, TArray<int32>& OutIndices) const;
+
+	// Walks the whole Inventory, what UI and AI code did before the indexes existed
+	// Returns the same indices in the same order as Run()
+	static void RunLinear(const TArray<FInventoryElement>& Inventory, const FItemDefinitionRegistry& Registry, const FInventoryQuery& Query, TArray<int32>& OutIndices);
+
+	// Value and weight come from the definition, stats from the element when it was modified
+	static float GetSortKey(const FInventoryElement& Element, const FInventoryItem& Definition, EInventorySortKey SortKey);
+
+	bool IsBuilt() const { return bIsBuilt; }
+
+	void Invalidate() { bIsBuilt = false; }
+
+private:
+
+	static const int32 NumSortKeys = (int32)EInventorySortKey::ISK_MAX - 1; // ISK_None has no index
+
+	struct FSortedSlot
+	{
+		float Key;
+		int32 Index;
+
+		bool operator < (const FSortedSlot& Other) const { return (Key < Other.Key) || ((Key == Other.Key) && (Index < Other.Index)); }
+	};
+
+	// What the indexes last saw of an element, so a change only moves the entries whose key actually changed
+	struct FSlotEntry
+	{
+		float Keys[NumSortKeys];
+		EItemType ItemType;
+		bool bIsEquipped;
+
+		bool operator == (const FSlotEntry& Other) const
+		{
+			if (ItemType != Other.ItemType || bIsEquipped != Other.bIsEquipped) return false;
+			for (int32 k = 0; k < NumSortKeys; k++)
+			{
+				if (Keys[k] != Other.Keys[k]) return false;
+			}
+			return true;
+		}
+	};
+
+	static FSlotEntry MakeEntry(const FInventoryElement& Element, const FInventoryItem& Definition);
+
+	static bool Matches(const FInventoryElement& Element, const FInventoryItem& Definition, const FInventoryQuery& Query);
+
+	void AddToIndexes(const FSlotEntry& Entry, int32 Index);
+
+	void RemoveFromIndexes(const FSlotEntry& Entry, int32 Index);
+
+	TArray<FSlotEntry> Slots; // one per Inventory element
+
+	TMap<EItemType, TArray<int32>> SlotsByType; // sorted element indices per type
+
+	TArray<int32> EquippedSlots; // sorted
+
+	TArray<FSortedSlot> SortedSlots[NumSortKeys]; // one per EInventorySortKey after ISK_None, ascending
+
+	bool bIsBuilt;
+};
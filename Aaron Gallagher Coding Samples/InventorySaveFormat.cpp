@@ -0,0 +1,448 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunInventorySaveBenchmark(const TArray<FString>& Args);
+
+// Inventory.SaveBench <Records>, logs the startup cost of a save of that many records
+static FAutoConsoleCommandWithArgs GInventorySaveBenchCommand(
+	TEXT("Inventory.SaveBench"),
+	TEXT("Inventory.SaveBench <Records>: writes a save of that many records to the Saved folder, then logs the time to open it, find and decode one inventory and decode every inventory"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunInventorySaveBenchmark));
+#endif
+
+// Adds one character's inventory, IDs are resolved through Registry, game thread only
+void FInventorySaveWriter::AddInventory(uint64 OwnerID, const TArray<FInventorySlotState>& Slots, FItemDefinitionRegistry& Registry)
+{
+	FPendingInventory& Inventory = Inventories.AddDefaulted_GetRef();
+	Inventory.OwnerID = OwnerID;
+	Inventory.FirstRecord = Records.Num();
+	Inventory.NumRecords = Slots.Num();
+
+	Records.Reserve(Records.Num() + Slots.Num());
+	for (const FInventorySlotState& Slot : Slots)
+	{
+		const FName ID = Registry.Resolve(Slot.ItemID).IsValid() ? Slot.ItemID : NAME_None;
+		uint32* NameIndex = NameIndices.Find(ID);
+		if (!NameIndex)
+		{
+			NameIndex = &NameIndices.Add(ID, (uint32)Names.Add(ID));
+		}
+
+		FInventorySaveRecord& Record = Records.AddZeroed_GetRef();
+		Record.NameIndex = *NameIndex;
+		Record.Quantity = Slot.Quantity;
+		Record.Flags = Slot.Flags;
+		if (Slot.Flags & FInventorySlotState::SLF_Modified)
+		{
+			Record.Armor = Slot.ModifiedStats.Armor;
+			Record.PhysicalAttack = Slot.ModifiedStats.PhysicalAttack;
+			Record.Fortitude = Slot.ModifiedStats.Fortitude;
+			Record.Agility = Slot.ModifiedStats.Agility;
+			Record.MagicAttack = Slot.ModifiedStats.MagicAttack;
+			Record.DamageAmount = Slot.ModifiedStats.DamageAmount;
+		}
+	}
+}
+
+// Writes every added inventory to OutBytes, returns false and writes nothing if the file would not fit the format's 32 bit offsets
+bool FInventorySaveWriter::Write(TArray<uint8>& OutBytes) const
+{
+	OutBytes.Reset();
+	// The directory is sorted so the loader can binary search it without building a map
+	TArray<FPendingInventory> SortedInventories = Inventories;
+	SortedInventories.StableSort([](const FPendingInventory& A, const FPendingInventory& B) { return A.OwnerID < B.OwnerID; });
+
+	TArray<uint8> NameBytes;
+	for (const FName& Name : Names)
+	{
+		FTCHARToUTF8 Utf8(*Name.ToString());
+		const uint16 Length = (uint16)FMath::Min(Utf8.Length(), (int32)MAX_uint16);
+		NameBytes.Append(reinterpret_cast<const uint8*>(&Length), sizeof(Length));
+		NameBytes.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Length);
+	}
+
+	FInventorySaveHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.RecordSize = sizeof(FInventorySaveRecord);
+	Header.NumInventories = (uint32)SortedInventories.Num();
+	Header.NumRecords = (uint32)Records.Num();
+	Header.NumNames = (uint32)Names.Num();
+	const uint64 NamesOffset = sizeof(FInventorySaveHeader) + ((uint64)SortedInventories.Num() * sizeof(FInventorySaveDirectoryEntry)) + ((uint64)Records.Num() * sizeof(FInventorySaveRecord));
+	if (NamesOffset + NameBytes.Num() > (uint64)MAX_int32) return false; // NamesOffset is 32 bits and the file is built in one TArray
+	Header.NamesOffset = (uint32)NamesOffset;
+	Header.NamesSize = (uint32)NameBytes.Num();
+
+	OutBytes.Reserve(Header.NamesOffset + Header.NamesSize);
+	OutBytes.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	for (const FPendingInventory& Inventory : SortedInventories)
+	{
+		FInventorySaveDirectoryEntry Entry;
+		Entry.OwnerID = Inventory.OwnerID;
+		Entry.FirstRecord = (uint32)Inventory.FirstRecord;
+		Entry.NumRecords = (uint32)Inventory.NumRecords;
+		OutBytes.Append(reinterpret_cast<const uint8*>(&Entry), sizeof(Entry));
+	}
+	OutBytes.Append(reinterpret_cast<const uint8*>(Records.GetData()), Records.Num() * sizeof(FInventorySaveRecord));
+	OutBytes.Append(NameBytes);
+	return true;
+}
+
+bool FInventorySaveWriter::SaveToFile(const FString& Filename) const
+{
+	TArray<uint8> Bytes;
+	return Write(Bytes) && FFileHelper::SaveArrayToFile(Bytes, *Filename);
+}
+
+FInventorySaveFile::~FInventorySaveFile()
+{
+	Close();
+}
+
+// Maps Filename, or reads it into memory if the platform cannot map files, and checks the header and directory
+bool FInventorySaveFile::Open(const FString& Filename)
+{
+	Close();
+	MappedHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (MappedHandle.IsValid())
+	{
+		MappedRegion.Reset(MappedHandle->MapRegion());
+		if (MappedRegion.IsValid())
+		{
+			Data = MappedRegion->GetMappedPtr();
+			DataSize = MappedRegion->GetMappedSize();
+			if (Validate()) return true;
+			Close();
+			return false;
+		}
+		MappedHandle.Reset();
+	}
+
+	if (!FFileHelper::LoadFileToArray(LoadedBytes, *Filename)) return false;
+	Data = LoadedBytes.GetData();
+	DataSize = LoadedBytes.Num();
+	if (Validate()) return true;
+	Close();
+	return false;
+}
+
+// Uses bytes that are already in memory, Bytes must outlive this object
+bool FInventorySaveFile::OpenFromMemory(const uint8* Bytes, int64 Size)
+{
+	Close();
+	Data = Bytes;
+	DataSize = Size;
+	if (Validate()) return true;
+	Close();
+	return false;
+}
+
+void FInventorySaveFile::Close()
+{
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+	LoadedBytes.Empty();
+	Names.Reset();
+	NameHandles.Reset();
+	ResolvedRegistry = nullptr;
+	Data = nullptr;
+	DataSize = 0;
+}
+
+// Binary search of the directory, returns INDEX_NONE if OwnerID has no saved inventory
+int32 FInventorySaveFile::FindInventory(uint64 OwnerID) const
+{
+	int32 Low = 0;
+	int32 High = NumInventories() - 1;
+	while (Low <= High)
+	{
+		const int32 Middle = Low + ((High - Low) / 2);
+		const uint64 MiddleID = GetOwnerID(Middle);
+		if (MiddleID == OwnerID) return Middle;
+		if (MiddleID < OwnerID) Low = Middle + 1;
+		else High = Middle - 1;
+	}
+	return INDEX_NONE;
+}
+
+uint64 FInventorySaveFile::GetOwnerID(int32 InventoryIndex) const
+{
+	return GetDirectoryEntry(InventoryIndex).OwnerID;
+}
+
+// Decodes one inventory into OutSlots, Item IDs that are no longer in Registry come back as NAME_None
+// Game thread only, the file's Item IDs are resolved through Registry
+bool FInventorySaveFile::DecodeInventory(int32 InventoryIndex, FItemDefinitionRegistry& Registry, TArray<FInventorySlotState>& OutSlots)
+{
+	OutSlots.Reset();
+	if (InventoryIndex < 0 || InventoryIndex >= NumInventories()) return false;
+	if (ResolvedRegistry != &Registry) ResolveNames(Registry);
+
+	const FInventorySaveDirectoryEntry Entry = GetDirectoryEntry(InventoryIndex);
+	const uint8* FirstRecord = Data + sizeof(FInventorySaveHeader) + (GetHeader().NumInventories * sizeof(FInventorySaveDirectoryEntry)) + ((int64)Entry.FirstRecord * sizeof(FInventorySaveRecord));
+	OutSlots.SetNum(Entry.NumRecords);
+	for (uint32 i = 0; i < Entry.NumRecords; i++)
+	{
+		FInventorySaveRecord Record;
+		FMemory::Memcpy(&Record, FirstRecord + (i * sizeof(FInventorySaveRecord)), sizeof(Record)); // the mapped file has no alignment guarantee
+		if (Record.NameIndex >= (uint32)NameHandles.Num()) return false;
+
+		FInventorySlotState& Slot = OutSlots[i];
+		Slot.ItemID = NameHandles[Record.NameIndex].IsValid() ? Names[Record.NameIndex] : NAME_None;
+		Slot.Quantity = Record.Quantity;
+		Slot.Flags = (uint8)Record.Flags;
+		Slot.ModifiedStats.Armor = Record.Armor;
+		Slot.ModifiedStats.PhysicalAttack = Record.PhysicalAttack;
+		Slot.ModifiedStats.Fortitude = Record.Fortitude;
+		Slot.ModifiedStats.Agility = Record.Agility;
+		Slot.ModifiedStats.MagicAttack = Record.MagicAttack;
+		Slot.ModifiedStats.DamageAmount = Record.DamageAmount;
+	}
+	return true;
+}
+
+// Checks every offset and count against the file size once, so decoding does not have to
+bool FInventorySaveFile::Validate()
+{
+	if (!Data || DataSize < (int64)sizeof(FInventorySaveHeader)) return false;
+	const FInventorySaveHeader& Header = GetHeader();
+	if (Header.Magic != FInventorySaveWriter::Magic || Header.Version != FInventorySaveWriter::Version) return false;
+	if (Header.RecordSize != sizeof(FInventorySaveRecord)) return false;
+
+	const int64 RecordsOffset = sizeof(FInventorySaveHeader) + ((int64)Header.NumInventories * sizeof(FInventorySaveDirectoryEntry));
+	const int64 RecordsEnd = RecordsOffset + ((int64)Header.NumRecords * sizeof(FInventorySaveRecord));
+	if (RecordsEnd > DataSize || Header.NamesOffset != RecordsEnd) return false;
+	if ((int64)Header.NamesOffset + Header.NamesSize > DataSize) return false;
+
+	uint64 PreviousOwnerID = 0;
+	for (int32 i = 0; i < (int32)Header.NumInventories; i++)
+	{
+		const FInventorySaveDirectoryEntry Entry = GetDirectoryEntry(i);
+		if ((uint64)Entry.FirstRecord + Entry.NumRecords > Header.NumRecords) return false;
+		if (i > 0 && Entry.OwnerID < PreviousOwnerID) return false; // FindInventory needs a sorted directory
+		PreviousOwnerID = Entry.OwnerID;
+	}
+
+	// The name table is small next to the records, it is parsed up front
+	// Every name takes at least its length, so a count the table cannot hold is refused before anything is allocated for it
+	if (Header.NumNames > Header.NamesSize / sizeof(uint16)) return false;
+	Names.Reset(Header.NumNames);
+	const uint8* Cursor = Data + Header.NamesOffset;
+	const uint8* End = Cursor + Header.NamesSize;
+	for (uint32 i = 0; i < Header.NumNames; i++)
+	{
+		uint16 Length = 0;
+		if (End - Cursor < (int64)sizeof(Length)) return false;
+		FMemory::Memcpy(&Length, Cursor, sizeof(Length));
+		Cursor += sizeof(Length);
+		if (End - Cursor < Length) return false;
+		const FUTF8ToTCHAR Name(reinterpret_cast<const ANSICHAR*>(Cursor), Length);
+		Names.Add(FName(Name.Length(), Name.Get()));
+		Cursor += Length;
+	}
+	return true;
+}
+
+FInventorySaveDirectoryEntry FInventorySaveFile::GetDirectoryEntry(int32 InventoryIndex) const
+{
+	FInventorySaveDirectoryEntry Entry;
+	FMemory::Memcpy(&Entry, Data + sizeof(FInventorySaveHeader) + (InventoryIndex * sizeof(FInventorySaveDirectoryEntry)), sizeof(Entry));
+	return Entry;
+}
+
+// Resolves the file's name table against Registry, done once per registry
+void FInventorySaveFile::ResolveNames(FItemDefinitionRegistry& Registry)
+{
+	NameHandles.Reset(Names.Num());
+	for (const FName& Name : Names)
+	{
+		NameHandles.Add(Registry.Resolve(Name));
+	}
+	ResolvedRegistry = &Registry;
+}
+
+#if !UE_BUILD_SHIPPING
+namespace InventorySaveFormatTest
+{
+	// Registry of NumItems items, a few of them stackable, shared by the writer and the reader
+	void BuildRegistry(FItemDefinitionRegistry& Registry, int32 NumItems)
+	{
+		for (int32 i = 0; i < NumItems; i++)
+		{
+			FInventoryItem Definition;
+			Definition.ItemID = FName(*FString::Printf(TEXT("SaveItem_%d"), i));
+			Definition.bIsStackable = (i % 4) != 0;
+			Registry.Add(Definition);
+		}
+	}
+
+	// NumInventories inventories of 1 to MaxSlots random slots, owners are not added in order so the directory has to be sorted
+	void MakeInventories(FRandomStream& Random, int32 NumInventories, int32 MaxSlots, int32 NumItems, TArray<TPair<uint64, TArray<FInventorySlotState>>>& OutInventories)
+	{
+		for (int32 i = 0; i < NumInventories; i++)
+		{
+			TPair<uint64, TArray<FInventorySlotState>>& Inventory = OutInventories.AddDefaulted_GetRef();
+			Inventory.Key = ((uint64)Random.GetUnsignedInt() << 32) | (uint32)i; // unique, the low bits are the index
+			for (int32 Slot = Random.RandRange(1, MaxSlots); Slot > 0; Slot--)
+			{
+				FInventorySlotState& State = Inventory.Value.AddDefaulted_GetRef();
+				State.ItemID = FName(*FString::Printf(TEXT("SaveItem_%d"), Random.RandHelper(NumItems)));
+				State.Quantity = Random.RandRange(1, 99);
+				if (Random.RandHelper(4) == 0)
+				{
+					State.Flags = FInventorySlotState::SLF_Modified | FInventorySlotState::SLF_StatsSet;
+					State.ModifiedStats.Armor = Random.RandRange(0, 50);
+					State.ModifiedStats.DamageAmount = 0.5f * Random.RandRange(0, 40);
+				}
+			}
+		}
+	}
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventorySaveRoundTripTest, "Inventory.Save.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// Every inventory written must come back with the same slots, found through the directory by its owner
+// Then copies of the file are truncated or have bytes overwritten, each must either be refused by Open or decode every inventory without reading out of bounds
+bool FInventorySaveRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace InventorySaveFormatTest;
+	const int32 NumMutations = 5000;
+
+	FRandomStream Random(NumMutations);
+	FItemDefinitionRegistry Registry;
+	BuildRegistry(Registry, 200);
+	TArray<TPair<uint64, TArray<FInventorySlotState>>> Inventories;
+	MakeInventories(Random, 64, 40, 200, Inventories);
+
+	FInventorySaveWriter Writer;
+	for (const TPair<uint64, TArray<FInventorySlotState>>& Inventory : Inventories)
+	{
+		Writer.AddInventory(Inventory.Key, Inventory.Value, Registry);
+	}
+	TArray<uint8> Bytes;
+	if (!TestTrue(TEXT("Writer accepted the inventories"), Writer.Write(Bytes))) return false;
+
+	FInventorySaveFile File;
+	TArray<FInventorySlotState> Slots;
+	if (!TestTrue(TEXT("Opened the written file"), File.OpenFromMemory(Bytes.GetData(), Bytes.Num()))) return false;
+	int32 NumBadInventories = 0;
+	for (const TPair<uint64, TArray<FInventorySlotState>>& Inventory : Inventories)
+	{
+		const int32 Index = File.FindInventory(Inventory.Key);
+		bool bMatches = (Index != INDEX_NONE) && File.DecodeInventory(Index, Registry, Slots) && (Slots.Num() == Inventory.Value.Num());
+		for (int32 i = 0; bMatches && i < Slots.Num(); i++)
+		{
+			bMatches = (Slots[i].DiffFields(Inventory.Value[i]) == 0);
+		}
+		if (!bMatches) NumBadInventories++;
+	}
+	TestEqual(TEXT("Inventories that did not round trip"), NumBadInventories, 0);
+	TestEqual(TEXT("Unknown owner"), File.FindInventory(MAX_uint64), (int32)INDEX_NONE);
+	File.Close();
+
+	// A name count larger than the name table can hold must be refused before it is reserved
+	TArray<uint8> HugeNameCount = Bytes;
+	FInventorySaveHeader Header;
+	FMemory::Memcpy(&Header, HugeNameCount.GetData(), sizeof(Header));
+	Header.NumNames = MAX_uint32;
+	FMemory::Memcpy(HugeNameCount.GetData(), &Header, sizeof(Header));
+	TestFalse(TEXT("Opened a file with an oversized name count"), File.OpenFromMemory(HugeNameCount.GetData(), HugeNameCount.Num()));
+
+	// Decoding is only asked to stay in bounds, a mutation can still produce a file that is valid but different
+	int32 NumOpened = 0;
+	int32 NumDecodeFailures = 0;
+	TArray<uint8> Mutated;
+	for (int32 Mutation = 0; Mutation < NumMutations; Mutation++)
+	{
+		Mutated = Bytes;
+		if (Random.RandHelper(4) == 0)
+		{
+			Mutated.SetNum(Random.RandHelper(Mutated.Num()));
+		}
+		else
+		{
+			// Mostly the header and directory, where the offsets and counts are
+			const int32 Range = (Random.RandHelper(2) == 0) ? FMath::Min(Mutated.Num(), 256) : Mutated.Num();
+			for (int32 Flip = Random.RandRange(1, 8); Flip > 0; Flip--)
+			{
+				Mutated[Random.RandHelper(Range)] = (uint8)Random.RandHelper(256);
+			}
+		}
+		// Copied so a read past the end lands outside the allocation, where the memory checker sees it
+		TArray<uint8> Exact(Mutated.GetData(), Mutated.Num());
+		if (!File.OpenFromMemory(Exact.GetData(), Exact.Num())) continue;
+		NumOpened++;
+		for (int32 i = 0; i < File.NumInventories(); i++)
+		{
+			if (!File.DecodeInventory(i, Registry, Slots)) NumDecodeFailures++;
+		}
+		File.Close();
+	}
+
+	AddInfo(FString::Printf(TEXT("%d inventories in %d bytes, %d corrupted copies, %d opened, %d decodes refused"), Inventories.Num(), Bytes.Num(), NumMutations, NumOpened, NumDecodeFailures));
+	return true;
+}
+#endif
+
+// Startup is what a server does before the first player can load in, open the file and decode that player's inventory
+// Decoding every inventory is logged too, as a shard migration or an offline tool would
+static void RunInventorySaveBenchmark(const TArray<FString>& Args)
+{
+	using namespace InventorySaveFormatTest;
+	const int32 NumRecords = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+	const int32 SlotsPerInventory = 40;
+	const int32 NumInventories = FMath::DivideAndRoundUp(NumRecords, SlotsPerInventory);
+	const FString Filename = FPaths::ProjectSavedDir() / TEXT("InventorySaveBench.bin");
+
+	FRandomStream Random(NumRecords);
+	FItemDefinitionRegistry Registry;
+	BuildRegistry(Registry, 2000);
+	TArray<TPair<uint64, TArray<FInventorySlotState>>> Inventories;
+	MakeInventories(Random, NumInventories, SlotsPerInventory, 2000, Inventories);
+	{
+		FInventorySaveWriter Writer;
+		for (const TPair<uint64, TArray<FInventorySlotState>>& Inventory : Inventories)
+		{
+			Writer.AddInventory(Inventory.Key, Inventory.Value, Registry);
+		}
+		if (!Writer.SaveToFile(Filename))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Inventory.SaveBench: could not write %s"), *Filename);
+			return;
+		}
+	}
+
+	FInventorySaveFile File;
+	TArray<FInventorySlotState> Slots;
+	double StartTime = FPlatformTime::Seconds();
+	const bool bIsOpen = File.Open(Filename);
+	const double OpenSeconds = FPlatformTime::Seconds() - StartTime;
+	if (!bIsOpen)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Inventory.SaveBench: could not open %s"), *Filename);
+		return;
+	}
+
+	StartTime = FPlatformTime::Seconds();
+	const int32 Index = File.FindInventory(Inventories[Random.RandHelper(Inventories.Num())].Key);
+	const bool bIsFirstDecoded = (Index != INDEX_NONE) && File.DecodeInventory(Index, Registry, Slots);
+	const double FirstSeconds = FPlatformTime::Seconds() - StartTime;
+
+	int32 NumDecoded = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < File.NumInventories(); i++)
+	{
+		if (File.DecodeInventory(i, Registry, Slots)) NumDecoded += Slots.Num();
+	}
+	const double AllSeconds = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(LogTemp, Log, TEXT("Inventory.SaveBench: %d inventories, %d records, open %.2f ms, first inventory %.3f ms, startup %.2f ms"),
+		File.NumInventories(), NumDecoded, OpenSeconds * 1000.0, FirstSeconds * 1000.0, (OpenSeconds + FirstSeconds) * 1000.0);
+	UE_LOG(LogTemp, Log, TEXT("Inventory.SaveBench: every inventory decoded in %.2f ms, %.1f ns a record, %s"),
+		AllSeconds * 1000.0, (NumDecoded > 0) ? (AllSeconds * 1e9 / NumDecoded) : 0.0, bIsFirstDecoded ? TEXT("passed") : TEXT("FAILED"));
+}
+#endif
@@ -0,0 +1,156 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+/*
+ * Layout of a saved inventory file, all values little endian
+ *
+ *   FInventorySaveHeader
+ *   FInventorySaveDirectoryEntry[NumInventories]   sorted by OwnerID
+ *   FInventorySaveRecord[NumRecords]               one per Inventory element
+ *   Name table                                     NumNames x (uint16 Length, Length bytes of UTF-8 Item ID)
+ *
+ * Records reference Item IDs through the file's own name table so saves stay valid when the item data table is reordered
+ */
+
+#pragma pack(push, 4)
+
+struct FInventorySaveHeader
+{
+	uint32 Magic;
+	uint16 Version;
+	uint16 RecordSize; // sizeof(FInventorySaveRecord) when the file was written
+	uint32 NumInventories;
+	uint32 NumRecords;
+	uint32 NumNames;
+	uint32 NamesOffset;
+	uint32 NamesSize;
+	uint32 Reserved;
+};
+
+struct FInventorySaveDirectoryEntry
+{
+	uint64 OwnerID;
+	uint32 FirstRecord;
+	uint32 NumRecords;
+};
+
+struct FInventorySaveRecord
+{
+	uint32 NameIndex;
+	int32 Quantity;
+	uint32 Flags; // FInventorySlotState::EFlags
+	int32 Armor;
+	int32 PhysicalAttack;
+	int32 Fortitude;
+	int32 Agility;
+	int32 MagicAttack;
+	float DamageAmount;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(FInventorySaveHeader) == 32, "FInventorySaveHeader layout is part of the file format");
+static_assert(sizeof(FInventorySaveDirectoryEntry) == 16, "FInventorySaveDirectoryEntry layout is part of the file format");
+static_assert(sizeof(FInventorySaveRecord) == 36, "FInventorySaveRecord layout is part of the file format");
+static_assert(PLATFORM_LITTLE_ENDIAN, "The inventory save format is read in place and assumes a little endian platform");
+
+
+/* Collects many inventories and writes them as one file */
+class FInventorySaveWriter
+{
+public:
+
+	static const uint32 Magic = 0x56494741; // "AGIV"
+	static const uint16 Version = 1;
+
+	// Adds one character's inventory, IDs are resolved through Registry, game thread only
+	void AddInventory(uint64 OwnerID, const TArray<FInventorySlotState>& Slots, FItemDefinitionRegistry& Registry);
+
+	// Writes every added inventory to OutBytes, returns false and writes nothing if the file would not fit the format's 32 bit offsets
+	bool Write(TArray<uint8>& OutBytes) const;
+
+	bool SaveToFile(const FString& Filename) const;
+
+private:
+
+	struct FPendingInventory
+	{
+		uint64 OwnerID;
+		int32 FirstRecord;
+		int32 NumRecords;
+	};
+
+	TArray<FPendingInventory> Inventories;
+
+	TArray<FInventorySaveRecord> Records;
+
+	TArray<FName> Names;
+
+	TMap<FName, uint32> NameIndices;
+};
+
+
+/* Read only view of a saved inventory file, inventories are only decoded when they are asked for */
+/* Large files are memory mapped so opening a shard's worth of characters does not read every record */
+class FInventorySaveFile
+{
+public:
+
+	FInventorySaveFile()
+	{
+		Data = nullptr;
+		DataSize = 0;
+		ResolvedRegistry = nullptr;
+	}
+
+	~FInventorySaveFile();
+
+	// Maps Filename, or reads it into memory if the platform cannot map files, and checks the header and directory
+	bool Open(const FString& Filename);
+
+	// Uses bytes that are already in memory, Bytes must outlive this object
+	bool OpenFromMemory(const uint8* Bytes, int64 Size);
+
+	void Close();
+
+	int32 NumInventories() const { return IsOpen() ? (int32)GetHeader().NumInventories : 0; }
+
+	bool IsOpen() const { return Data != nullptr; }
+
+	// Binary search of the directory, returns INDEX_NONE if OwnerID has no saved inventory
+	int32 FindInventory(uint64 OwnerID) const;
+
+	uint64 GetOwnerID(int32 InventoryIndex) const;
+
+	// Decodes one inventory into OutSlots, Item IDs that are no longer in Registry come back as NAME_None
+	// Game thread only, the file's Item IDs are resolved through Registry
+	bool DecodeInventory(int32 InventoryIndex, FItemDefinitionRegistry& Registry, TArray<FInventorySlotState>& OutSlots);
+
+private:
+
+	bool Validate();
+
+	const FInventorySaveHeader& GetHeader() const { return *reinterpret_cast<const FInventorySaveHeader*>(Data); }
+
+	FInventorySaveDirectoryEntry GetDirectoryEntry(int32 InventoryIndex) const;
+
+	// Resolves the file's name table against Registry, done once per registry
+	void ResolveNames(FItemDefinitionRegistry& Registry);
+
+	const uint8* Data;
+
+	int64 DataSize;
+
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	TArray<uint8> LoadedBytes; // used when the file could not be mapped
+
+	TArray<FName> Names; // parsed when the file is opened
+
+	TArray<FItemDefinitionHandle> NameHandles;
+
+	const FItemDefinitionRegistry* ResolvedRegistry;
+};
@@ -0,0 +1,103 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+// Splits QuantityToAdd between the existing stack and as many new stacks as FreeSlots allows
+// Full stacks are placed before the partial remainder stack, matching the order the old loop added them in
+FInventoryStackDistribution FInventoryStackDistribution::Compute(int32 CurrentQuantity, int32 QuantityToAdd, int32 MaxStackSize, int32 FreeSlots)
+{
+	FInventoryStackDistribution Result;
+	if (MaxStackSize <= 0 || QuantityToAdd <= 0)
+	{
+		Result.StackQuantity = CurrentQuantity;
+		Result.Leftover = FMath::Max(QuantityToAdd, 0);
+		return Result;
+	}
+
+	// Topping up the existing stack never needs a free slot
+	const int32 ToppedUp = FMath::Clamp(MaxStackSize - CurrentQuantity, 0, QuantityToAdd);
+	Result.StackQuantity = CurrentQuantity + ToppedUp;
+
+	const int32 Overflow = QuantityToAdd - ToppedUp;
+	const int32 StacksNeeded = FMath::DivideAndRoundUp(Overflow, MaxStackSize);
+	const int32 StacksUsed = FMath::Min(StacksNeeded, FMath::Max(FreeSlots, 0));
+	const int32 OverflowPlaced = FMath::Min(Overflow, StacksUsed * MaxStackSize);
+
+	Result.NumFullStacks = OverflowPlaced / MaxStackSize;
+	Result.Remainder = OverflowPlaced % MaxStackSize;
+	Result.QuantityAdded = ToppedUp + OverflowPlaced;
+	Result.Leftover = Overflow - OverflowPlaced;
+	return Result;
+}
+
+// Returns true if Index is the existing stack or one of the new stacks
+bool FInventoryStackDistribution::DidTouchIndex(int32 Index) const
+{
+	if (Index == INDEX_NONE) return false;
+	if (Index == StackIndex) return true;
+	return (FirstNewIndex != INDEX_NONE) && (Index >= FirstNewIndex) && (Index < FirstNewIndex + GetNumNewStacks());
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryStackDistributionTest, "Inventory.StackDistribution", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// Each case is worked out by hand, a Leftover above 0 is what the component passes to DropItemAtLocation so it covers the drop path when the Inventory is full
+// A top up that fits the open stack never needs a free slot, so it is placed even when the Inventory is full
+bool FInventoryStackDistributionTest::RunTest(const FString& Parameters)
+{
+	struct FCase
+	{
+		int32 CurrentQuantity;
+		int32 QuantityToAdd;
+		int32 MaxStackSize;
+		int32 FreeSlots;
+		int32 StackQuantity;
+		int32 NumFullStacks;
+		int32 Remainder;
+		int32 QuantityAdded;
+		int32 Leftover;
+	};
+	const FCase Cases[] =
+	{
+		//   Stack  Adding  Max  Free    Stack  Full  Remainder  Added  Dropped
+		{    5,     10,     20,  3,      15,    0,    0,         10,    0 },    // fits the open stack
+		{    5,     10,     20,  0,      15,    0,    0,         10,    0 },    // fits the open stack of a full Inventory
+		{    5,     15,     20,  0,      20,    0,    0,         15,    0 },    // fills the open stack of a full Inventory exactly
+		{    0,     40,     20,  2,      20,    1,    0,         40,    0 },    // one new full stack
+		{    20,    5,      20,  1,      20,    0,    5,         5,     0 },    // the stack is already full, one new partial stack
+		{    3,     45,     20,  5,      20,    1,    8,         45,    0 },    // full stacks before the remainder
+		{    18,    45,     20,  5,      20,    2,    3,         45,    0 },
+		{    18,    45,     20,  2,      20,    2,    0,         42,    3 },    // runs out of slots, the remainder is dropped
+		{    18,    45,     20,  0,      20,    0,    0,         2,     43 },   // full Inventory, only the top up fits
+		{    0,     3,      1,   1,      1,     1,    0,         2,     1 },    // unstackable sized stacks
+		{    7,     10000,  20,  1000,   20,    499,  7,         10000, 0 },    // looting 10,000 arrows, everything fits
+		{    7,     10000,  20,  100,    20,    100,  0,         2013,  7987 }, // most of it is dropped
+		{    7,     10000,  20,  0,      20,    0,    0,         13,    9987 }, // full Inventory, only the top up fits
+		{    4,     0,      20,  3,      4,     0,    0,         0,     0 },    // nothing to add
+		{    4,     -3,     20,  3,      4,     0,    0,         0,     0 },    // a negative quantity is ignored
+	};
+
+	for (const FCase& Case : Cases)
+	{
+		const FInventoryStackDistribution Result = FInventoryStackDistribution::Compute(Case.CurrentQuantity, Case.QuantityToAdd, Case.MaxStackSize, Case.FreeSlots);
+		const FString What = FString::Printf(TEXT("Stack %d adding %d, max %d, %d free slots"), Case.CurrentQuantity, Case.QuantityToAdd, Case.MaxStackSize, Case.FreeSlots);
+		TestEqual(What + TEXT(": stack"), Result.StackQuantity, Case.StackQuantity);
+		TestEqual(What + TEXT(": full stacks"), Result.NumFullStacks, Case.NumFullStacks);
+		TestEqual(What + TEXT(": remainder"), Result.Remainder, Case.Remainder);
+		TestEqual(What + TEXT(": added"), Result.QuantityAdded, Case.QuantityAdded);
+		TestEqual(What + TEXT(": dropped"), Result.Leftover, Case.Leftover);
+	}
+
+	// The touched slots are the topped up stack and the new stacks after FirstNewIndex, nothing else
+	FInventoryStackDistribution Touched = FInventoryStackDistribution::Compute(3, 45, 20, 5);
+	Touched.StackIndex = 2;
+	Touched.FirstNewIndex = 6;
+	TestTrue(TEXT("Touched the open stack"), Touched.DidTouchIndex(2));
+	TestTrue(TEXT("Touched the first new stack"), Touched.DidTouchIndex(6));
+	TestTrue(TEXT("Touched the remainder stack"), Touched.DidTouchIndex(7));
+	TestFalse(TEXT("Touched past the new stacks"), Touched.DidTouchIndex(8));
+	TestFalse(TEXT("Touched before the new stacks"), Touched.DidTouchIndex(5));
+	TestFalse(TEXT("Touched INDEX_NONE"), Touched.DidTouchIndex(INDEX_NONE));
+	return true;
+}
+#endif
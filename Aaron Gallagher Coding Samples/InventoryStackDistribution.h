@@ -0,0 +1,46 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Result of adding a bulk quantity to a stack, worked out in one pass instead of one loop iteration per stack */
+/* Only uses Core types so it can be computed without a World */
+struct FInventoryStackDistribution
+{
+public:
+
+	FInventoryStackDistribution()
+	{
+		StackIndex = INDEX_NONE;
+		StackQuantity = 0;
+		FirstNewIndex = INDEX_NONE;
+		NumFullStacks = 0;
+		Remainder = 0;
+		QuantityAdded = 0;
+		Leftover = 0;
+	}
+
+	// Splits QuantityToAdd between the existing stack and as many new stacks as FreeSlots allows
+	// Full stacks are placed before the partial remainder stack, matching the order the old loop added them in
+	static FInventoryStackDistribution Compute(int32 CurrentQuantity, int32 QuantityToAdd, int32 MaxStackSize, int32 FreeSlots);
+
+	// Number of new elements that have to be added to the Inventory
+	int32 GetNumNewStacks() const { return NumFullStacks + (Remainder > 0 ? 1 : 0); }
+
+	// Returns true if Index is the existing stack or one of the new stacks
+	bool DidTouchIndex(int32 Index) const;
+
+	int32 StackIndex; // Element that was topped up, INDEX_NONE when the distribution was computed without one
+
+	int32 StackQuantity; // Quantity of the existing stack after the add
+
+	int32 FirstNewIndex; // Index of the first new stack, new stacks are contiguous
+
+	int32 NumFullStacks; // New stacks that are filled to the max stack size
+
+	int32 Remainder; // Quantity of the last new stack when it is not full, 0 if there is none
+
+	int32 QuantityAdded; // Total quantity that was placed in the Inventory
+
+	int32 Leftover; // Quantity that did not fit and has to be dropped
+};
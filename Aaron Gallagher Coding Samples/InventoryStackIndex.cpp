@@ -0,0 +1,290 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunInventoryStackIndexBenchmark(const TArray<FString>& Args);
+
+// Inventory.StackIndexBench <Lookups>, times finding and topping up an open stack through the stack index against the linear search it replaced
+static FAutoConsoleCommandWithArgs GInventoryStackIndexBenchCommand(
+	TEXT("Inventory.StackIndexBench"),
+	TEXT("Inventory.StackIndexBench <Lookups>: times finding and topping up an open stack with FInventoryStackIndex against a linear search of the Inventory, at 10, 1k and 100k slots"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunInventoryStackIndexBenchmark));
+#endif
+
+// Clears the index and refills it from every element of the Inventory
+void FInventoryStackIndex::Rebuild(const TArray<FInventoryElement>& Inventory, const FItemDefinitionRegistry& Registry, int32 InMaxStackSize)
+{
+	OpenStacks.Reset();
+	SlotCounts.Reset();
+	LiveCounts.Reset(Inventory.Num() + 1);
+	LiveCounts.Add(0);
+	NumSlots = 0;
+	MaxStackSize = InMaxStackSize;
+	bIsBuilt = true;
+	for (int32 i = 0; i < Inventory.Num(); i++)
+	{
+		OnSlotAdded(Inventory[i], Registry.Get(Inventory[i].Handle), i);
+	}
+}
+
+// Called after an element is added to the end of the Inventory, Definition is the registry entry of its handle
+void FInventoryStackIndex::OnSlotAdded(const FInventoryElement& Element, const FInventoryItem& Definition, int32 Index)
+{
+	check(Index == NumSlots);
+	const int32 Position = LiveCounts.Num() - 1;
+	const int32 Node = Position + 1;
+	LiveCounts.Add(1 + GetIndex(Position) - GetIndex(Node - (Node & -Node))); // the new node also covers the positions below it in its range
+	NumSlots++;
+
+	if (Element.Handle.IsValid()) SlotCounts.FindOrAdd(Element.Handle)++; // empty slots of a fixed layout hold an invalid handle
+	if (IsOpenStack(Element, Definition))
+	{
+		AddOpenStack(Element.Handle, Position);
+	}
+}
+
+// Called after the Quantity or equipped state of an element changes
+void FInventoryStackIndex::OnSlotChanged(const FInventoryElement& Element, const FInventoryItem& Definition, int32 Index)
+{
+	const int32 Position = GetPosition(Index);
+	if (IsOpenStack(Element, Definition))
+	{
+		AddOpenStack(Element.Handle, Position);
+	}
+	else RemoveOpenStack(Element.Handle, Position);
+}
+
+// Called after an element is removed from the Inventory, every element after Index is shifted down by one
+// Only the open stacks of Handle are updated, later elements keep their positions and their indices shift through LiveCounts
+void FInventoryStackIndex::OnSlotRemoved(FItemDefinitionHandle Handle, int32 Index)
+{
+	const int32 Position = GetPosition(Index);
+	OnSlotCleared(Handle, Index);
+	AddLiveCount(Position, -1);
+	NumSlots--;
+
+	// Walks every open stack once per NumSlots removals, not once per removal
+	if (LiveCounts.Num() - 1 > 2 * NumSlots + 64)
+	{
+		Compact();
+	}
+}
+
+// Called after an element is emptied in place, used by Inventories with fixed slots where nothing after Index moves
+void FInventoryStackIndex::OnSlotCleared(FItemDefinitionHandle Handle, int32 Index)
+{
+	RemoveOpenStack(Handle, GetPosition(Index));
+	if (int32* Count = SlotCounts.Find(Handle))
+	{
+		if (--(*Count) <= 0) SlotCounts.Remove(Handle);
+	}
+}
+
+// Called after an empty slot is filled in place, the counterpart of OnSlotCleared
+void FInventoryStackIndex::OnSlotFilled(const FInventoryElement& Element, const FInventoryItem& Definition, int32 Index)
+{
+	SlotCounts.FindOrAdd(Element.Handle)++;
+	OnSlotChanged(Element, Definition, Index);
+}
+
+// Returns the lowest Index of a stack of the same definition that has not reached the max stack size, or INDEX_NONE
+int32 FInventoryStackIndex::FindOpenStack(FItemDefinitionHandle Handle) const
+{
+	const TArray<int32>* Positions = OpenStacks.Find(Handle);
+	if (!Positions || Positions->Num() == 0) return INDEX_NONE;
+	return GetIndex((*Positions)[0]);
+}
+
+// Adds the Index of every open stack of Handle to OutIndices in ascending order
+void FInventoryStackIndex::GetOpenStacks(FItemDefinitionHandle Handle, TArray<int32>& OutIndices) const
+{
+	if (const TArray<int32>* Positions = OpenStacks.Find(Handle))
+	{
+		for (int32 Position : *Positions)
+		{
+			OutIndices.Add(GetIndex(Position));
+		}
+	}
+}
+
+bool FInventoryStackIndex::IsOpenStack(const FInventoryElement& Element, const FInventoryItem& Definition) const
+{
+	return Definition.bIsStackable && !Element.bIsEquipped && (Element.Quantity < MaxStackSize);
+}
+
+void FInventoryStackIndex::AddOpenStack(FItemDefinitionHandle Handle, int32 Position)
+{
+	TArray<int32>& Positions = OpenStacks.FindOrAdd(Handle);
+	int32 Insert = Algo::LowerBound(Positions, Position);
+	if (Positions.IsValidIndex(Insert) && Positions[Insert] == Position) return; // already open
+	Positions.Insert(Position, Insert);
+}
+
+void FInventoryStackIndex::RemoveOpenStack(FItemDefinitionHandle Handle, int32 Position)
+{
+	TArray<int32>* Positions = OpenStacks.Find(Handle);
+	if (!Positions) return;
+	int32 Found = Algo::BinarySearch(*Positions, Position);
+	if (Found != INDEX_NONE) Positions->RemoveAt(Found, 1, false);
+	if (Positions->Num() == 0) OpenStacks.Remove(Handle);
+}
+
+// Index of the element at Position, the number of elements still in the Inventory at a lower position
+int32 FInventoryStackIndex::GetIndex(int32 Position) const
+{
+	int32 Index = 0;
+	for (int32 Node = Position; Node > 0; Node -= Node & -Node)
+	{
+		Index += LiveCounts[Node];
+	}
+	return Index;
+}
+
+// Position of the element at Index, found by walking down the tree past Index live elements
+int32 FInventoryStackIndex::GetPosition(int32 Index) const
+{
+	check(Index >= 0 && Index < NumSlots);
+	int32 Position = 0;
+	int32 Remaining = Index;
+	for (int32 Step = 1 << FMath::FloorLog2(LiveCounts.Num() - 1); Step > 0; Step >>= 1)
+	{
+		if ((Position + Step < LiveCounts.Num()) && (LiveCounts[Position + Step] <= Remaining))
+		{
+			Position += Step;
+			Remaining -= LiveCounts[Position];
+		}
+	}
+	return Position;
+}
+
+void FInventoryStackIndex::AddLiveCount(int32 Position, int32 Delta)
+{
+	for (int32 Node = Position + 1; Node < LiveCounts.Num(); Node += Node & -Node)
+	{
+		LiveCounts[Node] += Delta;
+	}
+}
+
+// Gives every element its Index as its position again once removed positions outnumber the elements
+void FInventoryStackIndex::Compact()
+{
+	for (TPair<FItemDefinitionHandle, TArray<int32>>& Pair : OpenStacks)
+	{
+		for (int32& Position : Pair.Value)
+		{
+			Position = GetIndex(Position);
+		}
+	}
+	LiveCounts.SetNumUninitialized(NumSlots + 1);
+	LiveCounts[0] = 0;
+	for (int32 Node = 1; Node <= NumSlots; Node++)
+	{
+		LiveCounts[Node] = Node & -Node; // every position is live, so each node counts its whole range
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+// Every slot holds a stackable item out of NumSlots / 4 IDs and most stacks are full, so the linear search walks far before it finds an open one
+// Each lookup adds one to the open stack it found, or starts a new stack when every stack of the ID is full, the same way AddItemtoInventoryByID does
+// Both sides run the same lookups on their own copy of the Inventory and must pick the same slot every time
+// Removals are then checked against a linear search, removing an element only updates the open stacks of its ID
+static void RunInventoryStackIndexBenchmark(const TArray<FString>& Args)
+{
+	const int32 NumLookups = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+	const int32 MaxStackSize = 20;
+	const int32 SlotCounts[] = { 10, 1000, 100000 };
+
+	for (int32 NumSlots : SlotCounts)
+	{
+		const int32 NumIDs = FMath::Max(NumSlots / 4, 1);
+		FRandomStream Random(NumSlots);
+		FItemDefinitionRegistry Registry;
+		for (int32 i = 0; i < NumIDs; i++)
+		{
+			FInventoryItem Definition;
+			Definition.ItemID = FName(TEXT("StackItem"), i);
+			Definition.bIsStackable = true;
+			Registry.Add(Definition);
+		}
+		TArray<FInventoryElement> Inventory;
+		Inventory.Reserve(NumSlots + NumLookups);
+		for (int32 i = 0; i < NumSlots; i++)
+		{
+			Inventory.Emplace(FItemDefinitionHandle(Random.RandHelper(NumIDs)), (Random.RandHelper(8) == 0) ? Random.RandRange(1, MaxStackSize - 1) : MaxStackSize);
+		}
+		TArray<FItemDefinitionHandle> Lookups;
+		for (int32 i = 0; i < NumLookups; i++)
+		{
+			Lookups.Add(FItemDefinitionHandle(Random.RandHelper(NumIDs)));
+		}
+
+		TArray<FInventoryElement> LinearInventory = Inventory;
+		TArray<int32> LinearFound;
+		LinearFound.Reserve(NumLookups);
+		double StartTime = FPlatformTime::Seconds();
+		for (FItemDefinitionHandle Handle : Lookups)
+		{
+			int32 Index = INDEX_NONE;
+			for (int32 i = 0; i < LinearInventory.Num(); i++)
+			{
+				if ((LinearInventory[i].Handle == Handle) && Registry.Get(Handle).bIsStackable && !LinearInventory[i].bIsEquipped && (LinearInventory[i].Quantity < MaxStackSize))
+				{
+					Index = i;
+					break;
+				}
+			}
+			if (Index == INDEX_NONE)
+			{
+				Index = LinearInventory.Emplace(Handle, 0);
+			}
+			LinearInventory[Index].Quantity++;
+			LinearFound.Add(Index);
+		}
+		const double LinearSeconds = FPlatformTime::Seconds() - StartTime;
+
+		TArray<FInventoryElement> IndexedInventory = Inventory;
+		TArray<int32> IndexedFound;
+		IndexedFound.Reserve(NumLookups);
+		FInventoryStackIndex StackIndex;
+		StartTime = FPlatformTime::Seconds();
+		StackIndex.Rebuild(IndexedInventory, Registry, MaxStackSize); // timed, the component builds it on first use
+		for (FItemDefinitionHandle Handle : Lookups)
+		{
+			const FInventoryItem& Definition = Registry.Get(Handle);
+			int32 Index = StackIndex.FindOpenStack(Handle);
+			if (Index == INDEX_NONE)
+			{
+				Index = IndexedInventory.Emplace(Handle, 0);
+				StackIndex.OnSlotAdded(IndexedInventory[Index], Definition, Index);
+			}
+			IndexedInventory[Index].Quantity++;
+			StackIndex.OnSlotChanged(IndexedInventory[Index], Definition, Index);
+			IndexedFound.Add(Index);
+		}
+		const double IndexedSeconds = FPlatformTime::Seconds() - StartTime;
+
+		// Removes half the elements at random, after each removal the index must find the same open stack as a linear search
+		int32 NumRemovalMismatches = 0;
+		const int32 NumRemovals = FMath::Min(IndexedInventory.Num() / 2, NumLookups);
+		StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumRemovals; i++)
+		{
+			const int32 Index = Random.RandHelper(IndexedInventory.Num());
+			const FItemDefinitionHandle Handle = IndexedInventory[Index].Handle;
+			IndexedInventory.RemoveAt(Index, 1, false);
+			StackIndex.OnSlotRemoved(Handle, Index);
+			const int32 Found = StackIndex.FindOpenStack(Handle);
+			const int32 Expected = IndexedInventory.IndexOfByPredicate([Handle, MaxStackSize](const FInventoryElement& Element) { return (Element.Handle == Handle) && (Element.Quantity < MaxStackSize); });
+			if (Found != Expected) NumRemovalMismatches++;
+		}
+		const double RemovalSeconds = FPlatformTime::Seconds() - StartTime; // includes the linear check
+
+		UE_LOG(LogTemp, Log, TEXT("Inventory.StackIndexBench: %d slots, %d lookups, linear %.1f ns a lookup, indexed %.1f ns a lookup, %.2fx, %s"),
+			NumSlots, NumLookups, LinearSeconds * 1e9 / NumLookups, IndexedSeconds * 1e9 / NumLookups, (IndexedSeconds > 0.0) ? (LinearSeconds / IndexedSeconds) : 0.0,
+			(LinearFound == IndexedFound) ? TEXT("passed") : TEXT("FAILED, the index picked a different stack"));
+		UE_LOG(LogTemp, Log, TEXT("Inventory.StackIndexBench: %d slots, %d removals with a linear check after each in %.3f ms, %s"),
+			NumSlots, NumRemovals, RemovalSeconds * 1000.0, (NumRemovalMismatches == 0) ? TEXT("passed") : TEXT("FAILED, the index lost track of a stack after a removal"));
+	}
+}
+#endif
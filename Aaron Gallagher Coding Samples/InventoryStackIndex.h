@@ -0,0 +1,84 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Lookup used by the Inventory Component to find stacks by item definition without scanning the Inventory */
+/* Only uses Core containers so it can be built and driven without a World */
+struct FInventoryStackIndex
+{
+public:
+
+	FInventoryStackIndex()
+	{
+		MaxStackSize = 0;
+		NumSlots = 0;
+		bIsBuilt = false;
+		LiveCounts.Add(0);
+	}
+
+	// Clears the index and refills it from every element of the Inventory
+	void Rebuild(const TArray<FInventoryElement>& Inventory, const FItemDefinitionRegistry& Registry, int32 InMaxStackSize);
+
+	// Called after an element is added to the end of the Inventory, Definition is the registry entry of its handle
+	void OnSlotAdded(const FInventoryElement& Element, const FInventoryItem& Definition, int32 Index);
+
+	// Called after the Quantity or equipped state of an element changes
+	void OnSlotChanged(const FInventoryElement& Element, const FInventoryItem& Definition, int32 Index);
+
+	// Called after an element is removed from the Inventory, every element after Index is shifted down by one
+	// Only the open stacks of Handle are updated, later elements keep their positions and their indices shift through LiveCounts
+	void OnSlotRemoved(FItemDefinitionHandle Handle, int32 Index);
+
+	// Called after an element is emptied in place, used by Inventories with fixed slots where nothing after Index moves
+	void OnSlotCleared(FItemDefinitionHandle Handle, int32 Index);
+
+	// Called after an empty slot is filled in place, the counterpart of OnSlotCleared
+	void OnSlotFilled(const FInventoryElement& Element, const FInventoryItem& Definition, int32 Index);
+
+	// Returns the lowest Index of a stack of the same definition that has not reached the max stack size, or INDEX_NONE
+	int32 FindOpenStack(FItemDefinitionHandle Handle) const;
+
+	// Adds the Index of every open stack of Handle to OutIndices in ascending order
+	void GetOpenStacks(FItemDefinitionHandle Handle, TArray<int32>& OutIndices) const;
+
+	// Replaces DoesInventoryContainID() without walking the Inventory
+	bool Contains(FItemDefinitionHandle Handle) const { return SlotCounts.Contains(Handle); }
+
+	bool IsBuilt() const { return bIsBuilt; }
+
+	void Invalidate() { bIsBuilt = false; }
+
+private:
+
+	// An element is open when it is stackable, not equipped and has room left in the stack
+	bool IsOpenStack(const FInventoryElement& Element, const FInventoryItem& Definition) const;
+
+	void AddOpenStack(FItemDefinitionHandle Handle, int32 Position);
+
+	void RemoveOpenStack(FItemDefinitionHandle Handle, int32 Position);
+
+	// Index of the element at Position, the number of elements still in the Inventory at a lower position
+	int32 GetIndex(int32 Position) const;
+
+	// Position of the element at Index
+	int32 GetPosition(int32 Index) const;
+
+	void AddLiveCount(int32 Position, int32 Delta);
+
+	// Gives every element its Index as its position again once removed positions outnumber the elements
+	void Compact();
+
+	// Every element gets the next position when it is added and keeps it until it is removed, so a removal leaves the positions of every other element alone
+	TMap<FItemDefinitionHandle, TArray<int32>> OpenStacks; // Sorted positions per definition, so the first open stack matches the old linear search
+
+	TArray<int32> LiveCounts; // Fenwick tree over positions, node Position + 1 counts 1 for an element still in the Inventory, node 0 is unused
+
+	TMap<FItemDefinitionHandle, int32> SlotCounts; // Number of elements holding each definition, empty slots of a fixed layout are not counted
+
+	int32 MaxStackSize;
+
+	int32 NumSlots;
+
+	bool bIsBuilt;
+};
@@ -0,0 +1,27 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+/* Stat counters for the Inventory System, view in game with "stat Inventory" */
+
+DECLARE_STATS_GROUP(TEXT("Inventory"), STATGROUP_Inventory, STATCAT_Advanced);
+
+// Number of Item ID to item definition lookups
+DECLARE_DWORD_COUNTER_STAT(TEXT("Definition Lookups"), STAT_InventoryDefinitionLookups, STATGROUP_Inventory);
+
+// Number of full FInventoryItem copies made while adding, stacking and dropping items
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Copies"), STAT_InventoryItemCopies, STATGROUP_Inventory);
+
+// Bytes moved by the copies counted in STAT_InventoryItemCopies
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Bytes Copied"), STAT_InventoryItemBytesCopied, STATGROUP_Inventory);
+
+// Number of times the Inventory array had to grow its allocation
+DECLARE_DWORD_COUNTER_STAT(TEXT("Inventory Allocations"), STAT_InventoryAllocations, STATGROUP_Inventory);
+
+// Counts one FInventoryItem copy
+#define INVENTORY_COUNT_ITEM_COPY() \
+	do \
+	{ \
+		INC_DWORD_STAT(STAT_InventoryItemCopies); \
+		INC_DWORD_STAT_BY(STAT_InventoryItemBytesCopied, sizeof(FInventoryItem)); \
+	} while (0)
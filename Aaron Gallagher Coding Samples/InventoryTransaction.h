@@ -0,0 +1,104 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+UENUM(BlueprintType)
+enum class EInventoryTransactionOp : uint8
+{
+	ITO_Add			UMETA(DisplayName = "Add"),
+	ITO_Remove		UMETA(DisplayName = "Remove")
+};
+
+UENUM(BlueprintType)
+enum class EInventoryTransactionResult : uint8
+{
+	ITR_Committed		UMETA(DisplayName = "Committed"),
+	ITR_NotEnoughSpace	UMETA(DisplayName = "Not Enough Space"),
+	ITR_Overweight		UMETA(DisplayName = "Overweight"),
+	ITR_InvalidItem		UMETA(DisplayName = "Invalid Item"),
+	ITR_InvalidSlot		UMETA(DisplayName = "Invalid Slot"),
+	ITR_NotAuthority	UMETA(DisplayName = "Not Authority")
+};
+
+
+/* One staged add or remove of a transaction */
+USTRUCT(BlueprintType)
+struct FInventoryTransactionOp
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	FInventoryTransactionOp()
+	{
+		Op = EInventoryTransactionOp::ITO_Add;
+		ItemID = NAME_None;
+		SlotIndex = INDEX_NONE;
+		Quantity = 0;
+		bIsModifiedItem = false;
+	}
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Transaction")
+		EInventoryTransactionOp Op;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Transaction")
+		FName ItemID; // Add only
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Transaction")
+		int32 SlotIndex; // Remove only, index into the Inventory before the transaction
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Transaction")
+		int32 Quantity;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Transaction")
+		bool bIsModifiedItem; // Add only, non stackable items receive ModifiedStats
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Transaction")
+		FCharacterStats ModifiedStats;
+};
+
+
+/* A batch of adds and removes that is checked once and then applied completely or not at all */
+/* Used for loot all, trades and crafting instead of calling AddItemtoInventoryByID once per item */
+USTRUCT(BlueprintType)
+struct FInventoryTransaction
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	FInventoryTransaction()
+	{
+		bAllowOverweight = true;
+	}
+
+	void StageAdd(FName ItemID, int32 Quantity)
+	{
+		FInventoryTransactionOp& NewOp = Ops.AddDefaulted_GetRef();
+		NewOp.Op = EInventoryTransactionOp::ITO_Add;
+		NewOp.ItemID = ItemID;
+		NewOp.Quantity = Quantity;
+	}
+
+	void StageModifiedAdd(FName ItemID, int32 Quantity, const FCharacterStats& ModifiedStats)
+	{
+		StageAdd(ItemID, Quantity);
+		Ops.Last().bIsModifiedItem = true;
+		Ops.Last().ModifiedStats = ModifiedStats;
+	}
+
+	void StageRemove(int32 SlotIndex, int32 Quantity)
+	{
+		FInventoryTransactionOp& NewOp = Ops.AddDefaulted_GetRef();
+		NewOp.Op = EInventoryTransactionOp::ITO_Remove;
+		NewOp.SlotIndex = SlotIndex;
+		NewOp.Quantity = Quantity;
+	}
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Transaction")
+		TArray<FInventoryTransactionOp> Ops;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Transaction")
+		bool bAllowOverweight; // false rejects the whole transaction if it would put the character over the weight limit
+};
@@ -0,0 +1,452 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunItemCatalogBenchmark(const TArray<FString>& Args);
+
+// Inventory.CatalogBench <Rows> <Lookups>, compares loading a synthetic catalog eagerly with streaming it
+static FAutoConsoleCommandWithArgs GItemCatalogBenchCommand(
+	TEXT("Inventory.CatalogBench"),
+	TEXT("Inventory.CatalogBench <Rows> <Lookups>: writes a synthetic item catalog, then logs startup time and resident memory of an eager registry against a streamed one"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunItemCatalogBenchmark));
+#endif
+
+static void AppendCatalogString(TArray<uint8>& Bytes, const FString& Value)
+{
+	FTCHARToUTF8 Utf8(*Value);
+	const uint16 Length = (uint16)FMath::Min(Utf8.Length(), (int32)MAX_uint16);
+	Bytes.Append(reinterpret_cast<const uint8*>(&Length), sizeof(Length));
+	Bytes.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Length);
+}
+
+// Moves Cursor past one string, OutValue is only decoded when it is not null
+static bool ReadCatalogString(const uint8*& Cursor, const uint8* End, FString* OutValue)
+{
+	uint16 Length = 0;
+	if (End - Cursor < (int64)sizeof(Length)) return false;
+	FMemory::Memcpy(&Length, Cursor, sizeof(Length));
+	Cursor += sizeof(Length);
+	if (End - Cursor < Length) return false;
+	if (OutValue)
+	{
+		const FUTF8ToTCHAR Value(reinterpret_cast<const ANSICHAR*>(Cursor), Length);
+		*OutValue = FString(Value.Length(), Value.Get());
+	}
+	Cursor += Length;
+	return true;
+}
+
+// Same order as the row map of FName, case is ignored
+static bool CatalogIDLess(const FString& A, const FString& B)
+{
+	return A.Compare(B, ESearchCase::IgnoreCase) < 0;
+}
+
+// Hard asset references of Definition are stored as soft paths, the first definition added for an ID is kept
+void FItemCatalogWriter::AddItem(const FInventoryItem& Definition)
+{
+	FPendingRow& Pending = Rows.AddDefaulted_GetRef();
+	Pending.ID = Definition.ItemID.ToString();
+
+	FItemCatalogRow& Row = Pending.Row;
+	FMemory::Memzero(Row);
+	Row.ItemType = (uint8)Definition.ItemType;
+	Row.Flags = (Definition.bIsStackable ? ICF_Stackable : ICF_None) | (Definition.bCanBeUsed ? ICF_CanBeUsed : ICF_None) | (Definition.bIsEquippable ? ICF_Equippable : ICF_None);
+	Row.ItemValue = Definition.ItemValue;
+	Row.Weight = Definition.Weight;
+	Row.Armor = Definition.PickupCharacterStats.Armor;
+	Row.PhysicalAttack = Definition.PickupCharacterStats.PhysicalAttack;
+	Row.Fortitude = Definition.PickupCharacterStats.Fortitude;
+	Row.Agility = Definition.PickupCharacterStats.Agility;
+	Row.MagicAttack = Definition.PickupCharacterStats.MagicAttack;
+	Row.DamageAmount = Definition.PickupCharacterStats.DamageAmount;
+
+	// Text keeps its localization key so clients still get translated names
+	const FText* Texts[] = { &Definition.ItemName, &Definition.ItemAction, &Definition.ItemDescription };
+	for (const FText* Text : Texts)
+	{
+		FString Buffer;
+		FTextStringHelper::WriteToBuffer(Buffer, *Text);
+		AppendCatalogString(Pending.Cold, Buffer);
+	}
+	AppendCatalogString(Pending.Cold, FSoftObjectPath(Definition.Thumbnail).ToString());
+	AppendCatalogString(Pending.Cold, FSoftObjectPath(Definition.ItemMesh).ToString());
+	AppendCatalogString(Pending.Cold, FSoftObjectPath(Definition.Pickup.Get()).ToString());
+	AppendCatalogString(Pending.Cold, FSoftObjectPath(Definition.WeaponClass.Get()).ToString());
+}
+
+// Adds every row of ItemTable, the row name is the Item ID
+void FItemCatalogWriter::AddTable(const UDataTable& ItemTable)
+{
+	Rows.Reserve(Rows.Num() + ItemTable.GetRowMap().Num());
+	for (const TPair<FName, uint8*>& Row : ItemTable.GetRowMap())
+	{
+		FInventoryItem Definition = *reinterpret_cast<const FInventoryItem*>(Row.Value);
+		Definition.ItemID = Row.Key;
+		AddItem(Definition);
+	}
+}
+
+// Sorts every added item by ID and writes them in pages of RowsPerPage rows
+void FItemCatalogWriter::Write(TArray<uint8>& OutBytes, int32 RowsPerPage) const
+{
+	RowsPerPage = FMath::Max(RowsPerPage, 1);
+
+	TArray<const FPendingRow*> SortedRows;
+	SortedRows.Reserve(Rows.Num());
+	for (const FPendingRow& Pending : Rows)
+	{
+		SortedRows.Add(&Pending);
+	}
+	Algo::StableSort(SortedRows, [](const FPendingRow* A, const FPendingRow* B) { return CatalogIDLess(A->ID, B->ID); });
+	int32 NumUnique = 0;
+	for (int32 i = 0; i < SortedRows.Num(); i++)
+	{
+		if (NumUnique > 0 && SortedRows[NumUnique - 1]->ID.Equals(SortedRows[i]->ID, ESearchCase::IgnoreCase)) continue; // FName would merge them too
+		SortedRows[NumUnique++] = SortedRows[i];
+	}
+	SortedRows.SetNum(NumUnique);
+
+	const int32 NumPages = FMath::DivideAndRoundUp(SortedRows.Num(), RowsPerPage);
+	TArray<uint8> KeyBytes;
+	TArray<TArray<uint8>> PageBytes;
+	PageBytes.SetNum(NumPages);
+	for (int32 PageIndex = 0; PageIndex < NumPages; PageIndex++)
+	{
+		const int32 FirstRow = PageIndex * RowsPerPage;
+		const int32 NumRows = FMath::Min(RowsPerPage, SortedRows.Num() - FirstRow);
+		const uint32 StringsOffset = NumRows * sizeof(FItemCatalogRow);
+		TArray<uint8>& Page = PageBytes[PageIndex];
+		TArray<uint8> Strings;
+		for (int32 i = FirstRow; i < FirstRow + NumRows; i++)
+		{
+			FItemCatalogRow Row = SortedRows[i]->Row;
+			FTCHARToUTF8 Utf8(*SortedRows[i]->ID);
+			Row.IDOffset = StringsOffset + Strings.Num();
+			Row.IDLength = (uint16)FMath::Min(Utf8.Length(), (int32)MAX_uint16);
+			Strings.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Row.IDLength);
+			Row.ColdOffset = StringsOffset + Strings.Num();
+			Row.ColdSize = (uint32)SortedRows[i]->Cold.Num();
+			Strings.Append(SortedRows[i]->Cold);
+			Page.Append(reinterpret_cast<const uint8*>(&Row), sizeof(Row));
+		}
+		Page.Append(Strings);
+		AppendCatalogString(KeyBytes, SortedRows[FirstRow]->ID);
+	}
+
+	FItemCatalogHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.RowSize = sizeof(FItemCatalogRow);
+	Header.NumRows = (uint32)SortedRows.Num();
+	Header.NumPages = (uint32)NumPages;
+	Header.RowsPerPage = (uint32)RowsPerPage;
+	Header.KeysOffset = sizeof(FItemCatalogHeader) + (NumPages * sizeof(FItemCatalogPageEntry));
+	Header.KeysSize = (uint32)KeyBytes.Num();
+
+	OutBytes.Reset();
+	OutBytes.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	uint64 PageOffset = Header.KeysOffset + Header.KeysSize;
+	for (int32 PageIndex = 0; PageIndex < NumPages; PageIndex++)
+	{
+		FItemCatalogPageEntry Entry;
+		Entry.Offset = PageOffset;
+		Entry.Size = (uint32)PageBytes[PageIndex].Num();
+		Entry.NumRows = (uint32)FMath::Min(RowsPerPage, SortedRows.Num() - (PageIndex * RowsPerPage));
+		OutBytes.Append(reinterpret_cast<const uint8*>(&Entry), sizeof(Entry));
+		PageOffset += Entry.Size;
+	}
+	OutBytes.Append(KeyBytes);
+	for (const TArray<uint8>& Page : PageBytes)
+	{
+		OutBytes.Append(Page);
+	}
+}
+
+bool FItemCatalogWriter::SaveToFile(const FString& Filename, int32 RowsPerPage) const
+{
+	TArray<uint8> Bytes;
+	Write(Bytes, RowsPerPage);
+	return FFileHelper::SaveArrayToFile(Bytes, *Filename);
+}
+
+FItemCatalog::~FItemCatalog()
+{
+	Close();
+}
+
+// Reads the header, page table and page keys of Filename and keeps the file open for page reads
+// At most MaxCachedPages pages are kept in memory, the least recently used page is dropped first
+// Every offset and count in the header and page table is checked here, rows are checked when their page is read
+bool FItemCatalog::Open(const FString& Filename, int32 MaxCachedPages)
+{
+	Close();
+	FileHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Filename));
+	if (!FileHandle.IsValid()) return false;
+
+	const int64 FileSize = FileHandle->Size();
+	bool bIsValid = (FileSize >= (int64)sizeof(FItemCatalogHeader)) && FileHandle->Read(reinterpret_cast<uint8*>(&Header), sizeof(Header));
+	bIsValid = bIsValid && (Header.Magic == FItemCatalogWriter::Magic) && (Header.Version == FItemCatalogWriter::Version) && (Header.RowSize == sizeof(FItemCatalogRow));
+	bIsValid = bIsValid && (Header.RowsPerPage > 0) && ((uint64)Header.NumPages * Header.RowsPerPage >= Header.NumRows);
+	bIsValid = bIsValid && (Header.KeysOffset == sizeof(FItemCatalogHeader) + ((uint64)Header.NumPages * sizeof(FItemCatalogPageEntry)));
+	bIsValid = bIsValid && ((int64)Header.KeysOffset + Header.KeysSize <= FileSize);
+	if (bIsValid)
+	{
+		Pages.SetNumUninitialized(Header.NumPages);
+		bIsValid = FileHandle->Read(reinterpret_cast<uint8*>(Pages.GetData()), Pages.Num() * sizeof(FItemCatalogPageEntry));
+	}
+
+	uint64 NumRows = 0;
+	for (int32 PageIndex = 0; bIsValid && PageIndex < Pages.Num(); PageIndex++)
+	{
+		const FItemCatalogPageEntry& Entry = Pages[PageIndex];
+		const bool bIsFull = (PageIndex == Pages.Num() - 1) || (Entry.NumRows == Header.RowsPerPage); // row indices assume every page but the last is full
+		bIsValid = bIsFull && (Entry.NumRows > 0) && (Entry.Offset + Entry.Size <= (uint64)FileSize) && ((uint64)Entry.NumRows * sizeof(FItemCatalogRow) <= Entry.Size);
+		NumRows += Entry.NumRows;
+	}
+	bIsValid = bIsValid && (NumRows == Header.NumRows);
+
+	// One key per page, small enough next to the rows to keep in memory
+	TArray<uint8> KeyBytes;
+	if (bIsValid)
+	{
+		KeyBytes.SetNumUninitialized(Header.KeysSize);
+		bIsValid = FileHandle->Seek(Header.KeysOffset) && FileHandle->Read(KeyBytes.GetData(), KeyBytes.Num());
+	}
+	const uint8* Cursor = KeyBytes.GetData();
+	const uint8* End = Cursor + KeyBytes.Num();
+	PageKeys.Reset(Pages.Num());
+	for (int32 PageIndex = 0; bIsValid && PageIndex < Pages.Num(); PageIndex++)
+	{
+		FString& Key = PageKeys.AddDefaulted_GetRef();
+		bIsValid = ReadCatalogString(Cursor, End, &Key) && (PageIndex == 0 || !CatalogIDLess(Key, PageKeys[PageIndex - 1])); // FindRow needs sorted keys
+	}
+
+	if (!bIsValid)
+	{
+		Close();
+		return false;
+	}
+	PageCache.Empty(FMath::Max(MaxCachedPages, 1));
+	return true;
+}
+
+void FItemCatalog::Close()
+{
+	FileHandle.Reset();
+	FMemory::Memzero(Header);
+	Pages.Reset();
+	PageKeys.Reset();
+	PageCache.Empty();
+	NumPageLoads = 0;
+}
+
+// Binary search of the page keys then of the page that can hold ID, returns the row index or INDEX_NONE
+int32 FItemCatalog::FindRow(FName ID)
+{
+	if (!IsOpen() || ID.IsNone()) return INDEX_NONE;
+	const FString Key = ID.ToString();
+
+	// The last page whose first ID is not after Key
+	const int32 PageIndex = Algo::UpperBound(PageKeys, Key, &CatalogIDLess) - 1;
+	if (PageIndex < 0) return INDEX_NONE;
+	const TArray<uint8>* Page = LoadPage(PageIndex);
+	if (!Page) return INDEX_NONE;
+
+	int32 Low = 0;
+	int32 High = (int32)Pages[PageIndex].NumRows - 1;
+	while (Low <= High)
+	{
+		const int32 Middle = Low + ((High - Low) / 2);
+		FItemCatalogRow Row;
+		FMemory::Memcpy(&Row, Page->GetData() + (Middle * sizeof(FItemCatalogRow)), sizeof(Row));
+		const int32 Compare = GetRowID(*Page, Row).Compare(Key, ESearchCase::IgnoreCase);
+		if (Compare == 0) return (PageIndex * (int32)Header.RowsPerPage) + Middle;
+		if (Compare < 0) Low = Middle + 1;
+		else High = Middle - 1;
+	}
+	return INDEX_NONE;
+}
+
+bool FItemCatalog::GetRow(int32 RowIndex, FItemCatalogRow& OutRow)
+{
+	return LoadRow(RowIndex, OutRow) != nullptr;
+}
+
+// Fills the gameplay fields of OutDefinition from a row, asset fields are left empty and returned as soft paths
+// Display text and the Thumbnail and ItemMesh paths are only decoded when bWithDisplayData is true
+bool FItemCatalog::MakeDefinition(int32 RowIndex, bool bWithDisplayData, FInventoryItem& OutDefinition, FItemCatalogAssetPaths& OutAssetPaths)
+{
+	FItemCatalogRow Row;
+	const TArray<uint8>* Page = LoadRow(RowIndex, Row);
+	if (!Page) return false;
+
+	OutDefinition = FInventoryItem();
+	OutDefinition.ItemID = FName(*GetRowID(*Page, Row));
+	OutDefinition.ItemType = (EItemType)Row.ItemType;
+	OutDefinition.bIsStackable = (Row.Flags & ICF_Stackable) != 0;
+	OutDefinition.bCanBeUsed = (Row.Flags & ICF_CanBeUsed) != 0;
+	OutDefinition.bIsEquippable = (Row.Flags & ICF_Equippable) != 0;
+	OutDefinition.ItemValue = Row.ItemValue;
+	OutDefinition.Weight = Row.Weight;
+	OutDefinition.PickupCharacterStats.Armor = Row.Armor;
+	OutDefinition.PickupCharacterStats.PhysicalAttack = Row.PhysicalAttack;
+	OutDefinition.PickupCharacterStats.Fortitude = Row.Fortitude;
+	OutDefinition.PickupCharacterStats.Agility = Row.Agility;
+	OutDefinition.PickupCharacterStats.MagicAttack = Row.MagicAttack;
+	OutDefinition.PickupCharacterStats.DamageAmount = Row.DamageAmount;
+
+	FString Texts[3];
+	FString Paths[4];
+	FString* Fields[] = { &Texts[0], &Texts[1], &Texts[2], &Paths[0], &Paths[1], &Paths[2], &Paths[3] };
+	const uint8* Cursor = Page->GetData() + Row.ColdOffset;
+	const uint8* End = Cursor + Row.ColdSize;
+	for (int32 i = 0; i < UE_ARRAY_COUNT(Fields); i++)
+	{
+		const bool bIsDisplayField = (i < 5); // text, thumbnail and mesh
+		if (!ReadCatalogString(Cursor, End, (bWithDisplayData || !bIsDisplayField) ? Fields[i] : nullptr)) return false;
+	}
+	if (bWithDisplayData)
+	{
+		FTextStringHelper::ReadFromBuffer(*Texts[0], OutDefinition.ItemName);
+		FTextStringHelper::ReadFromBuffer(*Texts[1], OutDefinition.ItemAction);
+		FTextStringHelper::ReadFromBuffer(*Texts[2], OutDefinition.ItemDescription);
+	}
+	OutAssetPaths.Thumbnail = FSoftObjectPath(Paths[0]);
+	OutAssetPaths.ItemMesh = FSoftObjectPath(Paths[1]);
+	OutAssetPaths.Pickup = FSoftObjectPath(Paths[2]);
+	OutAssetPaths.WeaponClass = FSoftObjectPath(Paths[3]);
+	return true;
+}
+
+// Returns the page from the cache or reads it, nullptr if the read failed
+// The page may be dropped by the next call, nothing on it is kept after that
+const TArray<uint8>* FItemCatalog::LoadPage(int32 PageIndex)
+{
+	if (const TSharedPtr<TArray<uint8>>* Cached = PageCache.FindAndTouch(PageIndex))
+	{
+		return Cached->Get();
+	}
+
+	const FItemCatalogPageEntry& Entry = Pages[PageIndex];
+	TSharedPtr<TArray<uint8>> Page = MakeShared<TArray<uint8>>();
+	Page->SetNumUninitialized(Entry.Size);
+	if (!FileHandle->Seek((int64)Entry.Offset) || !FileHandle->Read(Page->GetData(), Page->Num())) return nullptr;
+	for (uint32 i = 0; i < Entry.NumRows; i++)
+	{
+		FItemCatalogRow Row;
+		FMemory::Memcpy(&Row, Page->GetData() + (i * sizeof(FItemCatalogRow)), sizeof(Row));
+		if ((uint64)Row.IDOffset + Row.IDLength > Entry.Size || (uint64)Row.ColdOffset + Row.ColdSize > Entry.Size) return nullptr;
+	}
+	NumPageLoads++;
+	PageCache.Add(PageIndex, Page); // drops the least recently used page when the cache is full
+	return Page.Get();
+}
+
+// Copies a row out of its page, returns the page or nullptr if RowIndex is out of range or the read failed
+const TArray<uint8>* FItemCatalog::LoadRow(int32 RowIndex, FItemCatalogRow& OutRow)
+{
+	if (!IsOpen() || RowIndex < 0 || RowIndex >= (int32)Header.NumRows) return nullptr;
+	const int32 PageIndex = RowIndex / (int32)Header.RowsPerPage;
+	const int32 RowInPage = RowIndex % (int32)Header.RowsPerPage;
+	const TArray<uint8>* Page = LoadPage(PageIndex);
+	if (!Page) return nullptr;
+	FMemory::Memcpy(&OutRow, Page->GetData() + (RowInPage * sizeof(FItemCatalogRow)), sizeof(OutRow));
+	return Page;
+}
+
+// ID of a row on a page that was returned by LoadPage()
+FString FItemCatalog::GetRowID(const TArray<uint8>& Page, const FItemCatalogRow& Row)
+{
+	const FUTF8ToTCHAR ID(reinterpret_cast<const ANSICHAR*>(Page.GetData() + Row.IDOffset), Row.IDLength);
+	return FString(ID.Length(), ID.Get());
+}
+
+#if !UE_BUILD_SHIPPING
+// Writes Rows synthetic items to a catalog in the project's Saved folder, then builds an eager registry from the same items and opens a streamed one
+// Resident memory is the process's used physical memory before and after each, startup is the time to have every ID resolvable
+static void RunItemCatalogBenchmark(const TArray<FString>& Args)
+{
+	const int32 NumRows = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 200000;
+	const int32 NumLookups = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 20000;
+	const FString Filename = FPaths::ProjectSavedDir() / TEXT("ItemCatalogBench.bin");
+
+	auto MakeItem = [](int32 Index)
+	{
+		FInventoryItem Definition;
+		Definition.ItemID = FName(*FString::Printf(TEXT("CatalogItem_%d"), Index));
+		Definition.ItemName = FText::FromString(FString::Printf(TEXT("Catalog Item %d"), Index));
+		Definition.ItemDescription = FText::FromString(TEXT("A generated item used to measure the item catalog against the eager item registry."));
+		Definition.ItemValue = Index % 1000;
+		Definition.Weight = 0.5f * (Index % 17);
+		Definition.bIsStackable = (Index % 3) != 0;
+		Definition.bIsEquippable = (Index % 3) == 0;
+		Definition.PickupCharacterStats.Armor = Index % 50;
+		return Definition;
+	};
+	auto GetUsedPhysical = []() { return (double)FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0); };
+
+	{
+		FItemCatalogWriter Writer;
+		for (int32 i = 0; i < NumRows; i++)
+		{
+			Writer.AddItem(MakeItem(i));
+		}
+		if (!Writer.SaveToFile(Filename))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Inventory.CatalogBench: could not write %s"), *Filename);
+			return;
+		}
+	}
+
+	// Eager, every row is a full FInventoryItem the moment the registry exists, as it is built from the item data table today
+	{
+		const double MemoryBefore = GetUsedPhysical();
+		const double StartTime = FPlatformTime::Seconds();
+		TUniquePtr<FItemDefinitionRegistry> Eager = MakeUnique<FItemDefinitionRegistry>();
+		for (int32 i = 0; i < NumRows; i++)
+		{
+			Eager->Add(MakeItem(i));
+		}
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+		UE_LOG(LogTemp, Log, TEXT("Inventory.CatalogBench: eager registry of %d rows, startup %.1f ms, resident memory +%.1f MB"), NumRows, Elapsed * 1000.0, GetUsedPhysical() - MemoryBefore);
+	}
+
+	// Streamed, opening reads the page keys only and rows are decoded as they are looked up
+	FItemCatalog Catalog;
+	const double MemoryBefore = GetUsedPhysical();
+	const double OpenStart = FPlatformTime::Seconds();
+	if (!Catalog.Open(Filename))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Inventory.CatalogBench: could not open %s"), *Filename);
+		return;
+	}
+	const double OpenSeconds = FPlatformTime::Seconds() - OpenStart;
+	const double MemoryAfterOpen = GetUsedPhysical();
+
+	FRandomStream Random(NumRows);
+	int32 NumMismatches = 0;
+	const double LookupStart = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumLookups; i++)
+	{
+		// Most lookups go to a small set of popular items, the way loot tables and vendors reuse the same rows
+		const int32 Index = (Random.FRand() < 0.9f) ? Random.RandHelper(FMath::Min(NumRows, 2000)) : Random.RandHelper(NumRows);
+		const FInventoryItem Expected = MakeItem(Index);
+		FInventoryItem Definition;
+		FItemCatalogAssetPaths AssetPaths;
+		const int32 Row = Catalog.FindRow(Expected.ItemID);
+		const bool bMatches = (Row != INDEX_NONE) && Catalog.MakeDefinition(Row, false, Definition, AssetPaths)
+			&& (Definition.ItemID == Expected.ItemID) && (Definition.ItemValue == Expected.ItemValue) && (Definition.Weight == Expected.Weight)
+			&& (Definition.bIsStackable == Expected.bIsStackable) && (Definition.PickupCharacterStats == Expected.PickupCharacterStats);
+		if (!bMatches) NumMismatches++;
+	}
+	const double LookupSeconds = FPlatformTime::Seconds() - LookupStart;
+
+	UE_LOG(LogTemp, Log, TEXT("Inventory.CatalogBench: streamed catalog of %d rows, startup %.1f ms, resident memory +%.1f MB after open, +%.1f MB after lookups"),
+		Catalog.Num(), OpenSeconds * 1000.0, MemoryAfterOpen - MemoryBefore, GetUsedPhysical() - MemoryBefore);
+	UE_LOG(LogTemp, Log, TEXT("Inventory.CatalogBench: %d lookups in %.1f ms, %d page reads, %d pages cached, %s"),
+		NumLookups, LookupSeconds * 1000.0, Catalog.GetNumPageLoads(), Catalog.GetNumCachedPages(), (NumMismatches == 0) ? TEXT("every row matched") : TEXT("ROWS DID NOT MATCH"));
+}
+#endif
@@ -0,0 +1,182 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+/*
+ * Layout of an item catalog file, all values little endian
+ *
+ *   FItemCatalogHeader
+ *   FItemCatalogPageEntry[NumPages]   pages are in Item ID order
+ *   Page keys                         NumPages x (uint16 Length, Length bytes of the UTF-8 Item ID of the page's first row)
+ *   Pages                             each is FItemCatalogRow[NumRows] followed by the strings its rows point to
+ *
+ * Rows are sorted by Item ID ignoring case, the same way FName compares, so a lookup is a binary search of the page keys and then of one page
+ * Opening a catalog only reads the header, page table and page keys, pages are read when a row on them is first looked up
+ */
+
+#pragma pack(push, 4)
+
+struct FItemCatalogHeader
+{
+	uint32 Magic;
+	uint16 Version;
+	uint16 RowSize; // sizeof(FItemCatalogRow) when the file was written
+	uint32 NumRows;
+	uint32 NumPages;
+	uint32 RowsPerPage;
+	uint32 KeysOffset;
+	uint32 KeysSize;
+	uint32 Reserved;
+};
+
+struct FItemCatalogPageEntry
+{
+	uint64 Offset; // from the start of the file
+	uint32 Size;
+	uint32 NumRows;
+};
+
+/* Gameplay fields of one item, display text and asset paths are kept in the page's strings and only decoded when asked for */
+struct FItemCatalogRow
+{
+	uint32 IDOffset; // from the start of the page
+	uint32 ColdOffset; // from the start of the page, 7 x (uint16 Length, UTF-8 bytes) of ItemName, ItemAction, ItemDescription, Thumbnail, ItemMesh, Pickup and WeaponClass
+	uint32 ColdSize;
+	uint16 IDLength;
+	uint8 ItemType;
+	uint8 Flags; // EItemCatalogFlags
+	int32 ItemValue;
+	float Weight;
+	int32 Armor;
+	int32 PhysicalAttack;
+	int32 Fortitude;
+	int32 Agility;
+	int32 MagicAttack;
+	float DamageAmount;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(FItemCatalogHeader) == 32, "FItemCatalogHeader layout is part of the file format");
+static_assert(sizeof(FItemCatalogPageEntry) == 16, "FItemCatalogPageEntry layout is part of the file format");
+static_assert(sizeof(FItemCatalogRow) == 48, "FItemCatalogRow layout is part of the file format");
+static_assert(PLATFORM_LITTLE_ENDIAN, "The item catalog format is read in place and assumes a little endian platform");
+
+enum EItemCatalogFlags : uint8
+{
+	ICF_None = 0,
+	ICF_Stackable = 1 << 0,
+	ICF_CanBeUsed = 1 << 1,
+	ICF_Equippable = 1 << 2
+};
+
+
+/* Soft paths of the assets an item definition refers to, nothing is loaded until a path is resolved */
+struct FItemCatalogAssetPaths
+{
+	FSoftObjectPath Thumbnail;
+
+	FSoftObjectPath ItemMesh;
+
+	FSoftObjectPath Pickup;
+
+	FSoftObjectPath WeaponClass;
+};
+
+
+/* Collects item definitions and writes them as one catalog file, run when the item data table is cooked */
+class FItemCatalogWriter
+{
+public:
+
+	static const uint32 Magic = 0x43494741; // "AGIC"
+	static const uint16 Version = 1;
+
+	// Hard asset references of Definition are stored as soft paths, the first definition added for an ID is kept
+	void AddItem(const FInventoryItem& Definition);
+
+	// Adds every row of ItemTable, the row name is the Item ID
+	void AddTable(const UDataTable& ItemTable);
+
+	// Sorts every added item by ID and writes them in pages of RowsPerPage rows
+	void Write(TArray<uint8>& OutBytes, int32 RowsPerPage = 256) const;
+
+	bool SaveToFile(const FString& Filename, int32 RowsPerPage = 256) const;
+
+	int32 Num() const { return Rows.Num(); }
+
+private:
+
+	struct FPendingRow
+	{
+		FString ID;
+		FItemCatalogRow Row;
+		TArray<uint8> Cold;
+	};
+
+	TArray<FPendingRow> Rows;
+};
+
+
+/* Read only item catalog streamed from disk, the most recently used pages are kept in memory */
+/* Game thread only */
+class FItemCatalog
+{
+public:
+
+	FItemCatalog()
+	{
+		FMemory::Memzero(Header);
+		NumPageLoads = 0;
+	}
+
+	~FItemCatalog();
+
+	// Reads the header, page table and page keys of Filename and keeps the file open for page reads
+	// At most MaxCachedPages pages are kept in memory, the least recently used page is dropped first
+	bool Open(const FString& Filename, int32 MaxCachedPages = 64);
+
+	void Close();
+
+	bool IsOpen() const { return FileHandle.IsValid(); }
+
+	int32 Num() const { return IsOpen() ? (int32)Header.NumRows : 0; }
+
+	// Binary search of the page keys then of the page that can hold ID, returns the row index or INDEX_NONE
+	int32 FindRow(FName ID);
+
+	bool GetRow(int32 RowIndex, FItemCatalogRow& OutRow);
+
+	// Fills the gameplay fields of OutDefinition from a row, asset fields are left empty and returned as soft paths
+	// Display text and the Thumbnail and ItemMesh paths are only decoded when bWithDisplayData is true
+	bool MakeDefinition(int32 RowIndex, bool bWithDisplayData, FInventoryItem& OutDefinition, FItemCatalogAssetPaths& OutAssetPaths);
+
+	// Pages read from disk since the catalog was opened, including pages that were read again after being dropped
+	int32 GetNumPageLoads() const { return NumPageLoads; }
+
+	int32 GetNumCachedPages() const { return PageCache.Num(); }
+
+private:
+
+	// Returns the page from the cache or reads it, nullptr if the read failed
+	// The page may be dropped by the next call, nothing on it is kept after that
+	const TArray<uint8>* LoadPage(int32 PageIndex);
+
+	// Copies a row out of its page, returns the page or nullptr if RowIndex is out of range or the read failed
+	const TArray<uint8>* LoadRow(int32 RowIndex, FItemCatalogRow& OutRow);
+
+	// ID of a row on a page that was returned by LoadPage()
+	static FString GetRowID(const TArray<uint8>& Page, const FItemCatalogRow& Row);
+
+	TUniquePtr<IFileHandle> FileHandle;
+
+	FItemCatalogHeader Header;
+
+	TArray<FItemCatalogPageEntry> Pages;
+
+	TArray<FString> PageKeys; // ID of the first row of every page
+
+	TLruCache<int32, TSharedPtr<TArray<uint8>>> PageCache; // shared so a page is not copied when it is added
+
+	int32 NumPageLoads;
+};
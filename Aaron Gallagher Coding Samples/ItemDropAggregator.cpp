@@ -0,0 +1,101 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+void FItemDropAggregator::SetMergeSettings(float InMergeRadius, double InMergeWindow)
+{
+	MergeRadius = FMath::Max(InMergeRadius, 0.f);
+	MergeWindow = FMath::Max(InMergeWindow, 0.0);
+}
+
+// Adds Quantity to an open drop of the same item and stats within MergeRadius of Origin, or starts a new drop at SpawnLocation
+// Every merge keeps the drop open for another MergeWindow seconds
+// Returns the index of the drop that received the quantity
+int32 FItemDropAggregator::AddDrop(FName ItemID, bool bIsModified, const FCharacterStats& ModifiedStats, const FVector& Origin, const FVector& SpawnLocation, int32 Quantity, double Now)
+{
+	if (Quantity <= 0) return INDEX_NONE;
+
+	TArray<int32>& SameItemDrops = DropsByID.FindOrAdd(ItemID);
+	int32 DropIndex = INDEX_NONE;
+	for (int32 CandidateIndex : SameItemDrops)
+	{
+		const FAggregatedItemDrop& Candidate = Drops[CandidateIndex];
+		if (Candidate.MergeUntil < Now || Candidate.bIsModified != bIsModified) continue;
+		if (bIsModified && !(Candidate.ModifiedStats == ModifiedStats)) continue;
+		if (FVector::DistSquared(Candidate.Location, Origin) > FMath::Square(MergeRadius)) continue;
+		DropIndex = CandidateIndex;
+		break;
+	}
+
+	if (DropIndex == INDEX_NONE)
+	{
+		FAggregatedItemDrop NewDrop;
+		NewDrop.ItemID = ItemID;
+		NewDrop.bIsModified = bIsModified;
+		if (bIsModified) NewDrop.ModifiedStats = ModifiedStats;
+		NewDrop.Location = SpawnLocation;
+		DropIndex = Drops.Add(NewDrop);
+		SameItemDrops.Add(DropIndex);
+	}
+
+	FAggregatedItemDrop& Drop = Drops[DropIndex];
+	Drop.Quantity += Quantity;
+	Drop.PendingQuantity += Quantity;
+	Drop.MergeUntil = Now + MergeWindow;
+	if (!Drop.bIsQueued)
+	{
+		Drop.bIsQueued = true;
+		QueuedDrops.Add(DropIndex);
+	}
+	return DropIndex;
+}
+
+// Indices of every drop that received quantity since the last call, in the order they were first queued
+void FItemDropAggregator::CollectQueued(TArray<int32>& OutDropIndices)
+{
+	for (int32 DropIndex : QueuedDrops)
+	{
+		if (!Drops.IsValidIndex(DropIndex)) continue;
+		Drops[DropIndex].bIsQueued = false;
+		OutDropIndices.Add(DropIndex);
+	}
+	QueuedDrops.Reset();
+}
+
+// Returns the quantity merged into a drop since it was last taken and clears it
+int32 FItemDropAggregator::TakePendingQuantity(int32 DropIndex)
+{
+	if (!Drops.IsValidIndex(DropIndex)) return 0;
+	const int32 Quantity = Drops[DropIndex].PendingQuantity;
+	Drops[DropIndex].PendingQuantity = 0;
+	return Quantity;
+}
+
+// Removes every drop whose merge window has closed, OutExpired receives their indices
+// Drops with quantity that has not been taken yet are kept until it is
+void FItemDropAggregator::RemoveExpired(double Now, TArray<int32>& OutExpired)
+{
+	for (TSparseArray<FAggregatedItemDrop>::TIterator It(Drops); It; ++It)
+	{
+		if (It->MergeUntil >= Now || It->PendingQuantity > 0) continue;
+		OutExpired.Add(It.GetIndex());
+	}
+	for (int32 DropIndex : OutExpired)
+	{
+		Remove(DropIndex);
+	}
+}
+
+// Removes a drop early, for example when its pickup was collected
+void FItemDropAggregator::Remove(int32 DropIndex)
+{
+	if (!Drops.IsValidIndex(DropIndex)) return;
+	const FName ItemID = Drops[DropIndex].ItemID;
+	if (Drops[DropIndex].bIsQueued) QueuedDrops.RemoveSingle(DropIndex); // the index can be handed out again before the next flush
+	if (TArray<int32>* SameItemDrops = DropsByID.Find(ItemID))
+	{
+		SameItemDrops->RemoveSingleSwap(DropIndex, false);
+		if (SameItemDrops->Num() == 0) DropsByID.Remove(ItemID);
+	}
+	Drops.RemoveAt(DropIndex);
+}
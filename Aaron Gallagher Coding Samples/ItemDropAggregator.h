@@ -0,0 +1,88 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* One pile of dropped items, every drop of the same item and stats that lands near it while it is open is added to it */
+struct FAggregatedItemDrop
+{
+public:
+
+	FAggregatedItemDrop()
+	{
+		ItemID = NAME_None;
+		bIsModified = false;
+		Location = FVector::ZeroVector;
+		Quantity = 0;
+		PendingQuantity = 0;
+		MergeUntil = 0.0;
+		bIsQueued = false;
+	}
+
+	FName ItemID;
+
+	bool bIsModified;
+
+	FCharacterStats ModifiedStats; // only compared when bIsModified is set
+
+	FVector Location; // where the pickup is spawned
+
+	int32 Quantity; // everything merged into this drop so far
+
+	int32 PendingQuantity; // merged since the last flush and not yet handed to a pickup
+
+	double MergeUntil; // the drop stops accepting merges after this time
+
+	bool bIsQueued; // already listed in QueuedDrops
+};
+
+
+/* Merges overflow drops of the same item and stats within a radius and time window, so a full bag produces one pickup instead of one per drop */
+/* Only uses Core types, the World side spawning lives in UItemDropSubsystem */
+class FItemDropAggregator
+{
+public:
+
+	FItemDropAggregator()
+	{
+		MergeRadius = 200.f;
+		MergeWindow = 5.0;
+	}
+
+	void SetMergeSettings(float InMergeRadius, double InMergeWindow);
+
+	// Adds Quantity to an open drop of the same item and stats within MergeRadius of Origin, or starts a new drop at SpawnLocation
+	// Every merge keeps the drop open for another MergeWindow seconds
+	// Returns the index of the drop that received the quantity
+	int32 AddDrop(FName ItemID, bool bIsModified, const FCharacterStats& ModifiedStats, const FVector& Origin, const FVector& SpawnLocation, int32 Quantity, double Now);
+
+	// Indices of every drop that received quantity since the last call, in the order they were first queued
+	void CollectQueued(TArray<int32>& OutDropIndices);
+
+	// Returns the quantity merged into a drop since it was last taken and clears it
+	int32 TakePendingQuantity(int32 DropIndex);
+
+	// Removes every drop whose merge window has closed, OutExpired receives their indices
+	void RemoveExpired(double Now, TArray<int32>& OutExpired);
+
+	// Removes a drop early, for example when its pickup was collected
+	void Remove(int32 DropIndex);
+
+	const FAggregatedItemDrop& GetDrop(int32 DropIndex) const { return Drops[DropIndex]; }
+
+	bool IsValidDrop(int32 DropIndex) const { return Drops.IsValidIndex(DropIndex); }
+
+	int32 Num() const { return Drops.Num(); }
+
+private:
+
+	TSparseArray<FAggregatedItemDrop> Drops; // indices stay stable while other drops are removed
+
+	TMap<FName, TArray<int32>> DropsByID; // only drops of the same item are ever distance tested
+
+	TArray<int32> QueuedDrops;
+
+	float MergeRadius;
+
+	double MergeWindow;
+};
@@ -0,0 +1,186 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunDropStress(const TArray<FString>& Args, UWorld* World);
+
+static FAutoConsoleCommandWithWorldAndArgs GItemDropStressCommand(
+	TEXT("Inventory.DropStress"),
+	TEXT("Inventory.DropStress <Drops> <Items>: queues overflow drops around the first player and logs the pickup actors spawned and the flush time, against one SpawnActor per drop"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunDropStress));
+#endif
+
+void UItemDropSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UItemDropSubsystem::OnWorldPostActorTick);
+}
+
+void UItemDropSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	Super::Deinitialize();
+}
+
+// Queues Amount of Element around Origin, the pickup is spawned at the end of the frame or the amount is merged into a nearby pile
+// Definition is the registry entry of the element's handle, the pickup class comes from it and modified stats from the element
+// Replaces the SpawnActor and four RandRange calls DropItemAtLocation made for every drop
+void UItemDropSubsystem::QueueDrop(const FInventoryItem& Definition, const FInventoryElement& Element, int32 Amount, const FVector& Origin)
+{
+	UWorld* World = GetWorld();
+	if (!World || Amount <= 0 || !Definition.Pickup) return;
+
+	// Same 80 to 120 unit ring around the owner the old drop location used
+	const float Angle = FMath::FRand() * 2.f * PI;
+	const float Distance = FMath::RandRange(80.f, 120.f);
+	const FVector SpawnLocation = Origin + FVector(FMath::Cos(Angle) * Distance, FMath::Sin(Angle) * Distance, 10.f);
+
+	Aggregator.SetMergeSettings(MergeRadius, MergeWindow);
+	const int32 PileCount = Aggregator.Num();
+	const int32 DropIndex = Aggregator.AddDrop(Definition.ItemID, Element.bIsModifiedItem, Element.GetStats(Definition), Origin, SpawnLocation, Amount, World->GetTimeSeconds());
+	if (DropIndex == INDEX_NONE) return;
+
+	DropStats.DropsQueued++;
+	if (Aggregator.Num() == PileCount)
+	{
+		DropStats.DropsMerged++;
+		return;
+	}
+	FDropContext& Context = Contexts.Add(DropIndex);
+	Context.PickupClass = Definition.Pickup;
+}
+
+void UItemDropSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld()) return;
+	FlushDrops();
+}
+
+// Spawns or updates the pickup of every drop queued this frame and forgets piles whose merge window has closed
+void UItemDropSubsystem::FlushDrops()
+{
+	UWorld* World = GetWorld();
+	if (!World || Aggregator.Num() == 0) return;
+
+	QueuedDrops.Reset();
+	Aggregator.CollectQueued(QueuedDrops);
+	for (int32 DropIndex : QueuedDrops)
+	{
+		const int32 Quantity = Aggregator.TakePendingQuantity(DropIndex);
+		FDropContext* Context = Contexts.Find(DropIndex);
+		if (!Context || Quantity <= 0) continue;
+
+		if (APickup* Pickup = Context->Pickup.Get())
+		{
+			UPickupClaimSubsystem* PickupClaims = World->GetSubsystem<UPickupClaimSubsystem>();
+			if (PickupClaims) PickupClaims->AddToPickup(Pickup, Quantity); // players may be claiming from the pile this frame
+			else Pickup->Quantity += Quantity;
+			DropStats.PickupsUpdated++;
+			continue;
+		}
+
+		// New pile, or the pile's pickup was collected while it was still open
+		const FAggregatedItemDrop& Drop = Aggregator.GetDrop(DropIndex);
+		APickup* Pickup = World->SpawnActor<APickup>(Context->PickupClass, Drop.Location, FRotator::ZeroRotator);
+		if (!Pickup) continue;
+		GAMEPLAY_PROFILE_COUNT(ActorsSpawned, 1);
+		Pickup->Quantity = Quantity;
+		if (Drop.bIsModified)
+		{
+			Pickup->bIsModifiedPickup = true;
+			Pickup->PickupCStats = Drop.ModifiedStats;
+		}
+		Context->Pickup = Pickup;
+		DropStats.PickupsSpawned++;
+	}
+
+	ExpiredDrops.Reset();
+	Aggregator.RemoveExpired(World->GetTimeSeconds(), ExpiredDrops);
+	for (int32 DropIndex : ExpiredDrops)
+	{
+		Contexts.Remove(DropIndex); // the pickup stays in the World, later drops just start a new pile
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+// Inventory.DropStress <Drops> <Items>, queues overflow drops around the first player and logs the pickup actors spawned and the flush time
+// The same drops are then spawned one pickup each, the way DropItemAtLocation did before, and destroyed again
+// Checks the quantity carried by every pickup in the World grew by exactly the quantity dropped
+static void RunDropStress(const TArray<FString>& Args, UWorld* World)
+{
+	UItemDropSubsystem* ItemDrops = World ? World->GetSubsystem<UItemDropSubsystem>() : nullptr;
+	AInventoryGameMode* GameMode = World ? (AInventoryGameMode*)World->GetAuthGameMode() : nullptr;
+	APawn* Player = World ? UGameplayStatics::GetPlayerPawn(World, 0) : nullptr;
+	if (!ItemDrops || !GameMode || !Player) return;
+
+	UItemRegistrySubsystem* Registries = UItemRegistrySubsystem::Get(World);
+	const FItemDefinitionRegistry* ItemRegistry = Registries ? Registries->GetTableRegistry(GameMode->GetItemDB()) : nullptr;
+	if (!ItemRegistry || ItemRegistry->Num() == 0) return;
+
+	const int32 NumDrops = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+	const int32 NumItems = FMath::Clamp(Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 8, 1, ItemRegistry->Num());
+
+	auto CountPickups = [World](int32& OutQuantity)
+	{
+		int32 NumPickups = 0;
+		OutQuantity = 0;
+		for (TActorIterator<APickup> It(World); It; ++It)
+		{
+			NumPickups++;
+			OutQuantity += It->Quantity;
+		}
+		return NumPickups;
+	};
+	int32 QuantityBefore = 0;
+	const int32 PickupsBefore = CountPickups(QuantityBefore);
+	const FItemDropStats StatsBefore = ItemDrops->GetDropStats();
+
+	const FVector Origin = Player->GetActorLocation();
+	auto GetDropOrigin = [&Origin](int32 DropIndex)
+	{
+		return Origin + FVector((DropIndex % 4) * 50.f, ((DropIndex / 4) % 4) * 50.f, 0.f); // several players looting around the same spot
+	};
+	int32 QuantityDropped = 0;
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumDrops; i++)
+	{
+		const FInventoryElement Element(FItemDefinitionHandle(i % NumItems), 1);
+		const FInventoryItem& ItemToDrop = ItemRegistry->Get(Element.Handle);
+		if (ItemToDrop.Pickup) QuantityDropped++; // QueueDrop skips items without a pickup class
+		ItemDrops->QueueDrop(ItemToDrop, Element, 1, GetDropOrigin(i));
+	}
+	const double QueueTime = FPlatformTime::Seconds();
+	ItemDrops->FlushDrops();
+	const double EndTime = FPlatformTime::Seconds();
+
+	int32 QuantityAfter = 0;
+	const int32 PickupsAfter = CountPickups(QuantityAfter);
+	const FItemDropStats& StatsAfter = ItemDrops->GetDropStats();
+
+	// One pickup per drop with the ring position DropItemAtLocation used to roll
+	TArray<APickup*> Unbatched;
+	Unbatched.Reserve(NumDrops);
+	const double UnbatchedStartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumDrops; i++)
+	{
+		const FInventoryItem& ItemToDrop = ItemRegistry->Get(FItemDefinitionHandle(i % NumItems));
+		if (!ItemToDrop.Pickup) continue;
+		const FVector SpawnLocation = GetDropOrigin(i) + FVector(FMath::RandRange(80.f, 120.f) * (FMath::RandBool() ? 1.f : -1.f), FMath::RandRange(80.f, 120.f) * (FMath::RandBool() ? 1.f : -1.f), 10.f);
+		if (APickup* Pickup = World->SpawnActor<APickup>(ItemToDrop.Pickup, SpawnLocation, FRotator::ZeroRotator))
+		{
+			Pickup->Quantity = 1;
+			Unbatched.Add(Pickup);
+		}
+	}
+	const double UnbatchedSeconds = FPlatformTime::Seconds() - UnbatchedStartTime;
+	for (APickup* Pickup : Unbatched) Pickup->Destroy();
+
+	const bool bPassed = (QuantityAfter - QuantityBefore) == QuantityDropped;
+	UE_LOG(LogTemp, Log, TEXT("Inventory.DropStress: %d drops of %d items, %d pickup actors spawned (%d before, %d after), %d merged, queue %.3f ms, flush %.3f ms"),
+		NumDrops, NumItems, StatsAfter.PickupsSpawned - StatsBefore.PickupsSpawned, PickupsBefore, PickupsAfter,
+		StatsAfter.DropsMerged - StatsBefore.DropsMerged, (QueueTime - StartTime) * 1000.0, (EndTime - QueueTime) * 1000.0);
+	UE_LOG(LogTemp, Log, TEXT("Inventory.DropStress: one SpawnActor per drop %.3f ms with %d pickup actors, %d of %d items reached a pickup, %s"),
+		UnbatchedSeconds * 1000.0, Unbatched.Num(), QuantityAfter - QuantityBefore, QuantityDropped, bPassed ? TEXT("passed") : TEXT("FAILED"));
+}
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Drop counters, readable from Blueprint for debug displays */
+USTRUCT(BlueprintType)
+struct FItemDropStats
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	FItemDropStats()
+	{
+		DropsQueued = 0;
+		DropsMerged = 0;
+		PickupsSpawned = 0;
+		PickupsUpdated = 0;
+	}
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Drop Stats")
+		int32 DropsQueued; // Calls to QueueDrop
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Drop Stats")
+		int32 DropsMerged; // Drops added to an open pile instead of starting a new one
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Drop Stats")
+		int32 PickupsSpawned;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Drop Stats")
+		int32 PickupsUpdated; // Flushes that raised the quantity of a pickup already in the World
+};
+
+
+/* Collects every overflow drop of the frame and spawns the pickups once, after all actors have ticked */
+/* Drops of the same item and stats near an open pile raise that pile's quantity instead of spawning another pickup */
+UCLASS()
+class INVENTORY_API UItemDropSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	// Queues Amount of Element around Origin, the pickup is spawned at the end of the frame or the amount is merged into a nearby pile
+	// Definition is the registry entry of the element's handle, the pickup class comes from it and modified stats from the element
+	void QueueDrop(const FInventoryItem& Definition, const FInventoryElement& Element, int32 Amount, const FVector& Origin);
+
+	// Spawns or updates the pickup of every drop queued this frame and forgets piles whose merge window has closed
+	// Runs after all actors have ticked, call it directly only when the pickups are needed before then
+	void FlushDrops();
+
+	UFUNCTION(BlueprintPure, Category = "Utils")
+	FItemDropStats GetDropStats() const { return DropStats; }
+
+	// Drops within this distance of an open pile of the same item are merged into it
+	UPROPERTY(BlueprintReadWrite, Category = "Utils")
+	float MergeRadius = 200.f;
+
+	// Seconds a pile keeps accepting merges after the last drop was added to it
+	UPROPERTY(BlueprintReadWrite, Category = "Utils")
+	float MergeWindow = 5.f;
+
+private:
+
+	struct FDropContext
+	{
+		TSubclassOf<APickup> PickupClass;
+		TWeakObjectPtr<APickup> Pickup;
+	};
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	FItemDropAggregator Aggregator;
+
+	TMap<int32, FDropContext> Contexts; // keyed by aggregator drop index
+
+	FItemDropStats DropStats;
+
+	FDelegateHandle PostActorTickHandle;
+
+	TArray<int32> QueuedDrops; // reused every flush
+
+	TArray<int32> ExpiredDrops; // reused every flush
+};
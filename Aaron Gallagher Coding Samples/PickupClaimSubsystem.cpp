@@ -0,0 +1,75 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+void UPickupClaimSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UPickupClaimSubsystem::OnWorldPostActorTick);
+}
+
+void UPickupClaimSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	Super::Deinitialize();
+}
+
+// Takes up to Quantity from Pickup and returns what was taken, less than asked for when another player got there first
+// Pickup->Quantity is lowered to what is left so later interactions and the UI see the new amount
+int32 UPickupClaimSubsystem::ClaimPickup(APickup* Pickup, int32 Quantity)
+{
+	if (!Pickup || Quantity <= 0) return 0;
+	FPickupClaimHandle& Handle = HandlesByPickup.FindOrAdd(Pickup);
+	if (!Claims.IsValidHandle(Handle))
+	{
+		Handle = Claims.Register(Pickup->Quantity);
+		if (!Handle.IsValid())
+		{
+			// Every slot is in use, still safe on the game thread since nothing else can claim this pickup meanwhile
+			HandlesByPickup.Remove(Pickup);
+			const int32 Claimed = FMath::Clamp(Quantity, 0, Pickup->Quantity);
+			Pickup->Quantity -= Claimed;
+			return Claimed;
+		}
+	}
+	const int32 Claimed = Claims.Claim(Handle, Quantity);
+	Pickup->Quantity = Claims.GetRemaining(Handle);
+	return Claimed;
+}
+
+// Adds Quantity to a pickup that may have claims on it, used when a drop is merged into a pickup already in the World
+void UPickupClaimSubsystem::AddToPickup(APickup* Pickup, int32 Quantity)
+{
+	if (!Pickup || Quantity <= 0) return;
+	const FPickupClaimHandle Handle = HandlesByPickup.FindRef(Pickup);
+	if (Claims.AddQuantity(Handle, Quantity))
+	{
+		Pickup->Quantity = Claims.GetRemaining(Handle);
+		return;
+	}
+	Pickup->Quantity += Quantity; // nobody has claimed from it yet
+}
+
+void UPickupClaimSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld() || HandlesByPickup.Num() == 0) return;
+	ReleaseEmptyPickups();
+}
+
+// Destroys every pickup that was emptied and forgets pickups that were destroyed by anything else
+// Pickups that still hold quantity keep their slot, so a pickup looted by several players over a few frames is only registered once
+void UPickupClaimSubsystem::ReleaseEmptyPickups()
+{
+	for (TMap<TWeakObjectPtr<APickup>, FPickupClaimHandle>::TIterator It(HandlesByPickup); It; ++It)
+	{
+		APickup* Pickup = It.Key().Get();
+		if (Pickup && Claims.GetRemaining(It.Value()) > 0) continue;
+		Claims.Release(It.Value());
+		if (Pickup)
+		{
+			Pickup->Quantity = 0;
+			Pickup->Destroy();
+		}
+		It.RemoveCurrent();
+	}
+}
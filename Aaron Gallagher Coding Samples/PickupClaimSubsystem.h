@@ -0,0 +1,44 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Hands out the quantity of contested pickups so players interacting with one pickup in the same frame can never both receive it */
+/* A pickup is registered the first time it is claimed from, it is destroyed at the end of the frame it was emptied in */
+UCLASS()
+class INVENTORY_API UPickupClaimSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	// Takes up to Quantity from Pickup and returns what was taken, less than asked for when another player got there first
+	// Pickup->Quantity is lowered to what is left so later interactions and the UI see the new amount
+	int32 ClaimPickup(APickup* Pickup, int32 Quantity);
+
+	// Adds Quantity to a pickup that may have claims on it, used when a drop is merged into a pickup already in the World
+	void AddToPickup(APickup* Pickup, int32 Quantity);
+
+	// Handle of a registered pickup, for claims made off the game thread through GetClaims()
+	FPickupClaimHandle FindHandle(const APickup* Pickup) const { return HandlesByPickup.FindRef(Pickup); }
+
+	// Claim() can be called on the returned table from any thread while the game thread is not releasing pickups
+	FPickupClaimTable& GetClaims() { return Claims; }
+
+private:
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	// Destroys every pickup that was emptied and forgets pickups that were destroyed by anything else
+	void ReleaseEmptyPickups();
+
+	FPickupClaimTable Claims;
+
+	TMap<TWeakObjectPtr<APickup>, FPickupClaimHandle> HandlesByPickup;
+
+	FDelegateHandle PostActorTickHandle;
+};
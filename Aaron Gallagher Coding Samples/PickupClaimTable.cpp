@@ -0,0 +1,160 @@
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunPickupClaimStress(const TArray<FString>& Args);
+
+// Inventory.ClaimStress <Pickups> <Claimants> <Threads>, claims from every pickup on several threads at once and checks no quantity was lost or duplicated
+static FAutoConsoleCommandWithArgs GPickupClaimStressCommand(
+	TEXT("Inventory.ClaimStress"),
+	TEXT("Inventory.ClaimStress <Pickups> <Claimants> <Threads>: claims from every pickup on several threads at once, checks no quantity was lost or duplicated and logs claims per second"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunPickupClaimStress));
+#endif
+
+FPickupClaimTable::FPickupClaimTable(int32 InCapacity)
+{
+	Capacity = FMath::Max(InCapacity, 1);
+	States = MakeUnique<TAtomic<int64>[]>(Capacity);
+	FreeSlots.Reserve(Capacity);
+	for (int32 i = Capacity - 1; i >= 0; i--)
+	{
+		States[i].Store(MakeState(0, 0));
+		FreeSlots.Add(i); // popped from the back, so the lowest slot is used first
+	}
+}
+
+// Starts tracking a pickup holding Quantity, returns an invalid handle when every slot is in use
+FPickupClaimHandle FPickupClaimTable::Register(int32 Quantity)
+{
+	check(IsInGameThread());
+	if (FreeSlots.Num() == 0) return FPickupClaimHandle();
+	const int32 Index = FreeSlots.Pop(false);
+	uint32 Generation = GetGeneration(States[Index].Load()) + 1;
+	if (Generation == 0) Generation = 1; // wrapped, 0 is never handed out
+	States[Index].Store(MakeState(Generation, FMath::Max(Quantity, 0)));
+	return FPickupClaimHandle(Index, Generation);
+}
+
+// Stops tracking a pickup and returns the quantity that was still unclaimed
+// Claims racing with the release either finish first or see the new generation and take nothing
+int32 FPickupClaimTable::Release(FPickupClaimHandle Handle)
+{
+	check(IsInGameThread());
+	if (!IsValidHandle(Handle)) return 0;
+	const int64 Previous = States[Handle.Index].Exchange(MakeState(Handle.Generation + 1, 0)); // the old handle stops matching right away
+	FreeSlots.Add(Handle.Index);
+	return GetRemaining(Previous);
+}
+
+// Takes up to Quantity from the pickup, returns what was taken, 0 when it is empty or the handle was released
+// Retries only when another claim changed the pickup between the read and the swap, no claimant ever waits on a lock
+int32 FPickupClaimTable::Claim(FPickupClaimHandle Handle, int32 Quantity)
+{
+	if (Handle.Index < 0 || Handle.Index >= Capacity || Quantity <= 0) return 0;
+	TAtomic<int64>& State = States[Handle.Index];
+	int64 Expected = State.Load(EMemoryOrder::Relaxed);
+	while (true)
+	{
+		if (GetGeneration(Expected) != Handle.Generation) return 0;
+		const int32 Claimed = FMath::Min(Quantity, GetRemaining(Expected));
+		if (Claimed <= 0) return 0;
+		if (State.CompareExchange(Expected, MakeState(Handle.Generation, GetRemaining(Expected) - Claimed))) return Claimed;
+		// Expected now holds the current state
+	}
+}
+
+// Puts Quantity back into the pickup, used when a drop is merged into it, returns false if the handle was released
+bool FPickupClaimTable::AddQuantity(FPickupClaimHandle Handle, int32 Quantity)
+{
+	if (Handle.Index < 0 || Handle.Index >= Capacity) return false;
+	TAtomic<int64>& State = States[Handle.Index];
+	int64 Expected = State.Load(EMemoryOrder::Relaxed);
+	while (true)
+	{
+		if (GetGeneration(Expected) != Handle.Generation) return false;
+		const int32 Remaining = (int32)FMath::Min((int64)GetRemaining(Expected) + FMath::Max(Quantity, 0), (int64)MAX_int32);
+		if (State.CompareExchange(Expected, MakeState(Handle.Generation, Remaining))) return true;
+	}
+}
+
+// Quantity not yet claimed, 0 if the handle was released
+int32 FPickupClaimTable::GetRemaining(FPickupClaimHandle Handle) const
+{
+	if (Handle.Index < 0 || Handle.Index >= Capacity) return 0;
+	const int64 State = States[Handle.Index].Load();
+	return (GetGeneration(State) == Handle.Generation) ? GetRemaining(State) : 0;
+}
+
+bool FPickupClaimTable::IsValidHandle(FPickupClaimHandle Handle) const
+{
+	return (Handle.Index >= 0) && (Handle.Index < Capacity) && (Handle.Generation != 0) && (GetGeneration(States[Handle.Index].Load()) == Handle.Generation);
+}
+
+#if !UE_BUILD_SHIPPING
+// Every worker claims from the same pickup at the same time, Claimants attempts per pickup with random requests of 1 to 8
+// Each pickup starts with about half of what its claimants ask for, so full, partial and empty claims all happen
+// Passes when the claimed and remaining quantities of every pickup add up to what it started with
+static void RunPickupClaimStress(const TArray<FString>& Args)
+{
+	const int32 NumPickups = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1024;
+	const int32 NumClaimants = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 256;
+	const int32 NumWorkers = Args.IsValidIndex(2) ? FMath::Max(FCString::Atoi(*Args[2]), 1) : FMath::Max(FPlatformMisc::NumberOfWorkerThreadsToSpawn(), 2);
+	const int32 NumAttempts = NumPickups * NumClaimants;
+
+	FPickupClaimTable Claims(NumPickups);
+	TArray<FPickupClaimHandle> Handles;
+	TArray<int32> StartQuantities;
+	FRandomStream Random(NumAttempts);
+	for (int32 i = 0; i < NumPickups; i++)
+	{
+		StartQuantities.Add(Random.RandRange(NumClaimants, NumClaimants * 3));
+		Handles.Add(Claims.Register(StartQuantities[i]));
+	}
+	TArray<int32> Requested;
+	Requested.SetNumUninitialized(NumAttempts);
+	for (int32& Quantity : Requested)
+	{
+		Quantity = Random.RandRange(1, 8);
+	}
+	TArray<int32> Claimed;
+	Claimed.SetNumZeroed(NumAttempts); // each attempt is written by the one worker that made it
+
+	// Attempt i belongs to pickup i / NumClaimants and worker i % NumWorkers, so every worker is on the same pickup at the same step
+	const double StartTime = FPlatformTime::Seconds();
+	ParallelFor(NumWorkers, [&](int32 WorkerIndex)
+	{
+		for (int32 Attempt = WorkerIndex; Attempt < NumAttempts; Attempt += NumWorkers)
+		{
+			Claimed[Attempt] = Claims.Claim(Handles[Attempt / NumClaimants], Requested[Attempt]);
+		}
+	});
+	const double Elapsed = FPlatformTime::Seconds() - StartTime;
+
+	int32 NumPartial = 0;
+	int32 NumEmpty = 0;
+	int32 NumBadPickups = 0;
+	for (int32 PickupIndex = 0; PickupIndex < NumPickups; PickupIndex++)
+	{
+		int64 Total = Claims.GetRemaining(Handles[PickupIndex]);
+		for (int32 Attempt = PickupIndex * NumClaimants; Attempt < (PickupIndex + 1) * NumClaimants; Attempt++)
+		{
+			Total += Claimed[Attempt];
+			if (Claimed[Attempt] == 0) NumEmpty++;
+			else if (Claimed[Attempt] < Requested[Attempt]) NumPartial++;
+		}
+		if (Total != StartQuantities[PickupIndex]) NumBadPickups++;
+	}
+
+	// A handle kept after its pickup was released must not claim from the pickup that reuses the slot
+	const FPickupClaimHandle Stale = Handles[0];
+	Claims.Release(Stale);
+	const FPickupClaimHandle Reused = Claims.Register(10);
+	const bool bIsStaleRejected = (Reused.Index == Stale.Index) && (Claims.Claim(Stale, 10) == 0) && (Claims.GetRemaining(Reused) == 10);
+
+	UE_LOG(LogTemp, Log, TEXT("Inventory.ClaimStress: %d claims on %d pickups from %d threads in %.2f ms, %.0f claims per second"),
+		NumAttempts, NumPickups, NumWorkers, Elapsed * 1000.0, (Elapsed > 0.0) ? (NumAttempts / Elapsed) : 0.0);
+	UE_LOG(LogTemp, Log, TEXT("Inventory.ClaimStress: %d partial claims, %d found the pickup empty, %d pickups lost or duplicated quantity, stale handle %s, %s"),
+		NumPartial, NumEmpty, NumBadPickups, bIsStaleRejected ? TEXT("rejected") : TEXT("ACCEPTED"), (NumBadPickups == 0 && bIsStaleRejected) ? TEXT("passed") : TEXT("FAILED"));
+}
+#endif
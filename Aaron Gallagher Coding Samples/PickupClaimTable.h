@@ -0,0 +1,76 @@
+#pragma once
+/* Aaron Gallagher's Inventory Core Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Refers to one registered pickup, a handle kept after its pickup was released claims nothing */
+struct FPickupClaimHandle
+{
+public:
+
+	FPickupClaimHandle()
+	{
+		Index = INDEX_NONE;
+		Generation = 0;
+	}
+
+	FPickupClaimHandle(int32 InIndex, uint32 InGeneration)
+	{
+		Index = InIndex;
+		Generation = InGeneration;
+	}
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+
+	int32 Index;
+
+	uint32 Generation; // must match the slot's generation, changes every time the slot is released
+};
+
+
+/* Remaining quantity of every contested pickup, claimed with a compare and swap so any number of claimants can take from one pickup at once */
+/* A claim takes what is left when less than the requested quantity remains, two claims can never take the same unit */
+/* Register and Release are game thread only, Claim, AddQuantity and GetRemaining can be called from any thread */
+/* Only uses Core types, the World side lives in UPickupClaimSubsystem */
+class FPickupClaimTable
+{
+public:
+
+	explicit FPickupClaimTable(int32 InCapacity = 4096);
+
+	// Starts tracking a pickup holding Quantity, returns an invalid handle when every slot is in use
+	FPickupClaimHandle Register(int32 Quantity);
+
+	// Stops tracking a pickup and returns the quantity that was still unclaimed
+	int32 Release(FPickupClaimHandle Handle);
+
+	// Takes up to Quantity from the pickup, returns what was taken, 0 when it is empty or the handle was released
+	int32 Claim(FPickupClaimHandle Handle, int32 Quantity);
+
+	// Puts Quantity back into the pickup, used when a drop is merged into it, returns false if the handle was released
+	bool AddQuantity(FPickupClaimHandle Handle, int32 Quantity);
+
+	// Quantity not yet claimed, 0 if the handle was released
+	int32 GetRemaining(FPickupClaimHandle Handle) const;
+
+	bool IsValidHandle(FPickupClaimHandle Handle) const;
+
+	int32 Num() const { return Capacity - FreeSlots.Num(); }
+
+	int32 GetCapacity() const { return Capacity; }
+
+private:
+
+	// Generation in the high 32 bits and the remaining quantity in the low 32 bits, so one compare and swap checks both
+	static int64 MakeState(uint32 Generation, int32 Remaining) { return (int64)(((uint64)Generation << 32) | (uint32)Remaining); }
+
+	static uint32 GetGeneration(int64 State) { return (uint32)((uint64)State >> 32); }
+
+	static int32 GetRemaining(int64 State) { return (int32)(uint32)State; }
+
+	TUniquePtr<TAtomic<int64>[]> States; // allocated once so slots never move while other threads claim from them
+
+	TArray<int32> FreeSlots;
+
+	int32 Capacity;
+};
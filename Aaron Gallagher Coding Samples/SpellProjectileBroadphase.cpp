@@ -0,0 +1,289 @@
+/* Aaron Gallagher's Spell System Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+#if !UE_BUILD_SHIPPING
+static void RunSpellProjectileBenchmark(const TArray<FString>& Args);
+
+// Spells.ProjectileBench <Projectiles> <Targets>, steps analytic projectiles against a spatial hash and against every target
+static FAutoConsoleCommandWithArgs GSpellProjectileBenchCommand(
+	TEXT("Spells.ProjectileBench"),
+	TEXT("Spells.ProjectileBench <Projectiles> <Targets>: times FSpellProjectileSimulator steps and the per frame capsule positions at 60 frames a second, with the spatial hash against one cell holding every target, and checks both hit the same targets"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunSpellProjectileBenchmark));
+#endif
+
+// Clears the grid and inserts every target into each cell its bounds overlap
+void FSpellSpatialHash::Build(const TArray<FSpellTargetBounds>& InTargets, float InCellSize)
+{
+	CellSize = FMath::Max(InCellSize, 1.f);
+	Targets = InTargets;
+	for (TPair<FIntVector, TArray<int32>>& Cell : Cells)
+	{
+		Cell.Value.Reset(); // keeps the allocations of cells that are used again next frame
+	}
+
+	for (int32 i = 0; i < Targets.Num(); i++)
+	{
+		const FVector Extent(Targets[i].Radius);
+		const FIntVector Min = ToCell(Targets[i].Center - Extent);
+		const FIntVector Max = ToCell(Targets[i].Center + Extent);
+		for (int32 X = Min.X; X <= Max.X; X++)
+		{
+			for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+			{
+				for (int32 Z = Min.Z; Z <= Max.Z; Z++)
+				{
+					Cells.FindOrAdd(FIntVector(X, Y, Z)).Add(i);
+				}
+			}
+		}
+	}
+}
+
+// Sweeps a sphere of Radius from Start to End and returns the index into the built targets of the earliest hit, or INDEX_NONE
+// Targets with IgnoreID or already in AlreadyHit are skipped, OutTime is the hit time along the sweep from 0 to 1
+int32 FSpellSpatialHash::SweepFirstHit(const FVector& Start, const FVector& End, float Radius, int32 IgnoreID, const TSet<int32>* AlreadyHit, float& OutTime) const
+{
+	const FVector Extent(Radius);
+	const FIntVector Min = ToCell(Start.ComponentMin(End) - Extent);
+	const FIntVector Max = ToCell(Start.ComponentMax(End) + Extent);
+	const FVector Delta = End - Start;
+	const float DeltaSizeSquared = Delta.SizeSquared();
+
+	int32 BestIndex = INDEX_NONE;
+	float BestTime = MAX_flt;
+	for (int32 X = Min.X; X <= Max.X; X++)
+	{
+		for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+		{
+			for (int32 Z = Min.Z; Z <= Max.Z; Z++)
+			{
+				const TArray<int32>* Cell = Cells.Find(FIntVector(X, Y, Z));
+				if (!Cell) continue;
+				for (int32 TargetIndex : *Cell)
+				{
+					const FSpellTargetBounds& Target = Targets[TargetIndex];
+					if (Target.TargetID == IgnoreID) continue;
+					if (AlreadyHit && AlreadyHit->Contains(Target.TargetID)) continue;
+
+					// Earliest Time in [0, 1] where |Start + Delta * Time - Center| <= Radius + Target.Radius
+					const float CombinedRadius = Radius + Target.Radius;
+					const FVector ToStart = Start - Target.Center;
+					const float C = ToStart.SizeSquared() - (CombinedRadius * CombinedRadius);
+					float Time = 0.f;
+					if (C > 0.f)
+					{
+						if (DeltaSizeSquared <= SMALL_NUMBER) continue;
+						const float B = FVector::DotProduct(ToStart, Delta);
+						const float Discriminant = (B * B) - (DeltaSizeSquared * C);
+						if (B >= 0.f || Discriminant < 0.f) continue; // moving away or missing
+						Time = (-B - FMath::Sqrt(Discriminant)) / DeltaSizeSquared;
+						if (Time > 1.f) continue;
+					}
+
+					const bool bIsEarlier = (Time < BestTime) || ((Time == BestTime) && (Target.TargetID < Targets[BestIndex].TargetID));
+					if (bIsEarlier)
+					{
+						BestTime = Time;
+						BestIndex = TargetIndex;
+					}
+				}
+			}
+		}
+	}
+	OutTime = BestTime;
+	return BestIndex;
+}
+
+// Appends the index into the built targets of every target overlapping the capsule from Start to End with Radius
+// Each target is appended once in TargetID order even when it spans several cells, targets with IgnoreID are skipped
+void FSpellSpatialHash::OverlapCapsule(const FVector& Start, const FVector& End, float Radius, int32 IgnoreID, TArray<int32>& OutIndices) const
+{
+	const FVector Extent(Radius);
+	const FIntVector Min = ToCell(Start.ComponentMin(End) - Extent);
+	const FIntVector Max = ToCell(Start.ComponentMax(End) + Extent);
+	const int32 FirstIndex = OutIndices.Num();
+	for (int32 X = Min.X; X <= Max.X; X++)
+	{
+		for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+		{
+			for (int32 Z = Min.Z; Z <= Max.Z; Z++)
+			{
+				const TArray<int32>* Cell = Cells.Find(FIntVector(X, Y, Z));
+				if (!Cell) continue;
+				for (int32 TargetIndex : *Cell)
+				{
+					const FSpellTargetBounds& Target = Targets[TargetIndex];
+					if (Target.TargetID == IgnoreID) continue;
+					if (FMath::PointDistToSegmentSquared(Target.Center, Start, End) > FMath::Square(Radius + Target.Radius)) continue;
+					OutIndices.Add(TargetIndex);
+				}
+			}
+		}
+	}
+
+	// A target is stored in every cell its bounds overlap, sort the new indices and drop the repeats
+	TArrayView<int32> Found(OutIndices.GetData() + FirstIndex, OutIndices.Num() - FirstIndex);
+	Algo::Sort(Found, [this](int32 A, int32 B) { return (Targets[A].TargetID < Targets[B].TargetID) || ((Targets[A].TargetID == Targets[B].TargetID) && (A < B)); });
+	int32 WriteIndex = FirstIndex;
+	for (int32 i = FirstIndex; i < OutIndices.Num(); i++)
+	{
+		if (WriteIndex > FirstIndex && OutIndices[WriteIndex - 1] == OutIndices[i]) continue;
+		OutIndices[WriteIndex++] = OutIndices[i];
+	}
+	OutIndices.SetNum(WriteIndex, false);
+}
+
+FIntVector FSpellSpatialHash::ToCell(const FVector& Location) const
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
+
+// Returns an ID that is reported in FSpellProjectileHit
+int32 FSpellProjectileSimulator::Launch(const FVector& Origin, const FVector& Velocity, float GravityZ, float Radius, float MaxLifeTime, int32 OwnerID, double Now)
+{
+	FSpellProjectile& Projectile = Projectiles.AddDefaulted_GetRef();
+	Projectile.Origin = Origin;
+	Projectile.Velocity = Velocity;
+	Projectile.GravityZ = GravityZ;
+	Projectile.Radius = Radius;
+	Projectile.LaunchTime = Now;
+	Projectile.LastStepTime = Now;
+	Projectile.MaxLifeTime = MaxLifeTime;
+	Projectile.OwnerID = OwnerID;
+	Projectile.ProjectileID = NextProjectileID++;
+	return Projectile.ProjectileID;
+}
+
+void FSpellProjectileSimulator::Remove(int32 ProjectileID)
+{
+	const int32 Index = Projectiles.IndexOfByPredicate([ProjectileID](const FSpellProjectile& Projectile) { return Projectile.ProjectileID == ProjectileID; });
+	if (Index != INDEX_NONE) Projectiles.RemoveAt(Index, 1, false);
+}
+
+// Moves every projectile to Now, appends the first hit of each projectile in ProjectileID order and removes the projectiles that hit or expired
+// The IDs of projectiles that expired without a hit are appended to OutExpired
+void FSpellProjectileSimulator::Step(double Now, const FSpellSpatialHash& SpatialHash, TArray<FSpellProjectileHit>& OutHits, TArray<int32>& OutExpired)
+{
+	int32 WriteIndex = 0;
+	for (int32 i = 0; i < Projectiles.Num(); i++)
+	{
+		FSpellProjectile& Projectile = Projectiles[i];
+		const double EndTime = FMath::Min(Now, Projectile.LaunchTime + Projectile.MaxLifeTime);
+		const FVector Start = Projectile.GetLocationAt(Projectile.LastStepTime);
+		const FVector End = Projectile.GetLocationAt(EndTime);
+
+		float HitTime = 0.f;
+		const int32 TargetIndex = SpatialHash.SweepFirstHit(Start, End, Projectile.Radius, Projectile.OwnerID, &Projectile.TargetsHit, HitTime);
+		if (TargetIndex != INDEX_NONE)
+		{
+			FSpellProjectileHit& Hit = OutHits.AddDefaulted_GetRef();
+			Hit.ProjectileID = Projectile.ProjectileID;
+			Hit.TargetID = SpatialHash.GetTarget(TargetIndex).TargetID;
+			Hit.Location = FMath::Lerp(Start, End, HitTime);
+			Hit.Time = FMath::Lerp(Projectile.LastStepTime, EndTime, (double)HitTime);
+			Projectile.TargetsHit.Add(Hit.TargetID);
+			continue; // only the first target is hit, the projectile is removed
+		}
+		if (EndTime >= Projectile.LaunchTime + Projectile.MaxLifeTime)
+		{
+			OutExpired.Add(Projectile.ProjectileID);
+			continue;
+		}
+
+		Projectile.LastStepTime = EndTime;
+		if (WriteIndex != i) Projectiles[WriteIndex] = MoveTemp(Projectile);
+		++WriteIndex;
+	}
+	Projectiles.SetNum(WriteIndex, false);
+}
+
+#if !UE_BUILD_SHIPPING
+// Projectiles are launched from a ring of casters toward the middle of an arena full of targets, the way a large fight fills the air
+// The brute force side uses the same sweep with a cell large enough to hold every target, so every projectile tests every target
+// Each frame also reads the location and velocity of every projectile still in flight, the transform USpellProjectileSubsystem gives each capsule
+static void RunSpellProjectileBenchmark(const TArray<FString>& Args)
+{
+	const int32 NumProjectiles = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 5000;
+	const int32 NumTargets = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 2000;
+	const double FrameTime = 1.0 / 60.0;
+	const float ArenaRadius = 10000.f;
+	const float GravityZ = -980.f;
+	const float MaxLifeTime = 3.f;
+	const int32 NumFrames = FMath::CeilToInt(MaxLifeTime / FrameTime) + 1;
+
+	FRandomStream Random(NumProjectiles);
+	TArray<FSpellTargetBounds> Targets;
+	for (int32 i = 0; i < NumTargets; i++)
+	{
+		FSpellTargetBounds& Target = Targets.AddDefaulted_GetRef();
+		Target.Center = FVector(Random.FRandRange(-ArenaRadius, ArenaRadius), Random.FRandRange(-ArenaRadius, ArenaRadius), 90.f);
+		Target.Radius = 45.f;
+		Target.TargetID = i;
+	}
+
+	auto Run = [&](float CellSize, TArray<FSpellProjectileHit>& OutHits, double& OutSeconds)
+	{
+		FRandomStream LaunchRandom(NumProjectiles);
+		FSpellProjectileSimulator Simulator;
+		for (int32 i = 0; i < NumProjectiles; i++)
+		{
+			const FVector Origin = Targets[i % NumTargets].Center;
+			const FVector Direction = FVector(LaunchRandom.FRandRange(-1.f, 1.f), LaunchRandom.FRandRange(-1.f, 1.f), LaunchRandom.FRandRange(0.05f, 0.3f)).GetSafeNormal();
+			Simulator.Launch(Origin, Direction * LaunchRandom.FRandRange(1500.f, 3000.f), GravityZ, 20.f, MaxLifeTime, i % NumTargets, 0.0);
+		}
+
+		FSpellSpatialHash SpatialHash;
+		TArray<int32> Expired;
+		FVector Checksum = FVector::ZeroVector; // keeps the transform reads from being optimised away
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 1; Frame <= NumFrames && Simulator.Num() > 0; Frame++)
+		{
+			SpatialHash.Build(Targets, CellSize);
+			Simulator.Step(Frame * FrameTime, SpatialHash, OutHits, Expired);
+			for (const FSpellProjectile& Projectile : Simulator.GetProjectiles())
+			{
+				Checksum += Projectile.GetLocationAt(Projectile.LastStepTime) + Projectile.GetVelocityAt(Projectile.LastStepTime);
+			}
+		}
+		OutSeconds = FPlatformTime::Seconds() - StartTime;
+		return Checksum;
+	};
+
+	TArray<FSpellProjectileHit> HashHits;
+	TArray<FSpellProjectileHit> BruteForceHits;
+	double HashSeconds = 0.0;
+	double BruteForceSeconds = 0.0;
+	const FVector Checksum = Run(200.f, HashHits, HashSeconds) - Run(4.f * ArenaRadius, BruteForceHits, BruteForceSeconds);
+
+	int32 NumMismatches = FMath::Abs(HashHits.Num() - BruteForceHits.Num());
+	for (int32 i = 0; i < FMath::Min(HashHits.Num(), BruteForceHits.Num()); i++)
+	{
+		if (HashHits[i].ProjectileID != BruteForceHits[i].ProjectileID || HashHits[i].TargetID != BruteForceHits[i].TargetID) NumMismatches++;
+	}
+
+	// A projectile stepped frame by frame has to be where the closed form puts it, the capsule is moved to that point every tick
+	FSpellProjectileSimulator Simulator;
+	FSpellSpatialHash EmptyHash;
+	EmptyHash.Build(TArray<FSpellTargetBounds>(), 200.f);
+	TArray<FSpellProjectileHit> NoHits;
+	TArray<int32> Expired;
+	const FVector Origin(0.f, 0.f, 100.f);
+	const FVector Velocity(2000.f, 0.f, 500.f);
+	Simulator.Launch(Origin, Velocity, GravityZ, 20.f, MaxLifeTime, INDEX_NONE, 0.0);
+	for (int32 Frame = 1; Frame <= 30; Frame++)
+	{
+		Simulator.Step(Frame * FrameTime, EmptyHash, NoHits, Expired);
+	}
+	const float Elapsed = (float)(30 * FrameTime);
+	const FVector Expected = Origin + (Velocity * Elapsed) + FVector(0.f, 0.f, 0.5f * GravityZ * Elapsed * Elapsed);
+	const bool bIsOnArc = (Simulator.Num() == 1) && Simulator.GetProjectiles()[0].GetLocationAt(Simulator.GetProjectiles()[0].LastStepTime).Equals(Expected, 0.1f)
+		&& !Simulator.GetProjectiles()[0].GetLocationAt(Simulator.GetProjectiles()[0].LastStepTime).Equals(Origin, 1.f);
+
+	const bool bPassed = (NumMismatches == 0) && bIsOnArc;
+	UE_LOG(LogTemp, Log, TEXT("Spells.ProjectileBench: %d projectiles, %d targets, up to %d frames, %d hits, checksum %s"), NumProjectiles, NumTargets, NumFrames, HashHits.Num(), *Checksum.ToString());
+	UE_LOG(LogTemp, Log, TEXT("Spells.ProjectileBench: spatial hash %.3f ms a frame, every target %.3f ms a frame, %.2fx, %d hits differ, projectile %s, %s"),
+		HashSeconds * 1000.0 / NumFrames, BruteForceSeconds * 1000.0 / NumFrames, (HashSeconds > 0.0) ? (BruteForceSeconds / HashSeconds) : 0.0,
+		NumMismatches, bIsOnArc ? TEXT("on its arc") : TEXT("NOT ON ITS ARC"), bPassed ? TEXT("passed") : TEXT("FAILED"));
+}
+#endif
@@ -0,0 +1,135 @@
+#pragma once
+/* Aaron Gallagher's Spell System Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Bounding sphere of a character that spell projectiles can hit */
+struct FSpellTargetBounds
+{
+	FVector Center;
+
+	float Radius;
+
+	int32 TargetID; // caller defined, lower IDs win ties so the first hit is deterministic
+};
+
+
+/* Uniform grid of target bounds, rebuilt every frame before projectiles are stepped */
+/* Only uses Core types so it can be driven without a World */
+class FSpellSpatialHash
+{
+public:
+
+	FSpellSpatialHash()
+	{
+		CellSize = 200.f;
+	}
+
+	// Clears the grid and inserts every target into each cell its bounds overlap
+	void Build(const TArray<FSpellTargetBounds>& InTargets, float InCellSize);
+
+	// Sweeps a sphere of Radius from Start to End and returns the index into the built targets of the earliest hit, or INDEX_NONE
+	// Targets with IgnoreID or already in AlreadyHit are skipped, OutTime is the hit time along the sweep from 0 to 1
+	int32 SweepFirstHit(const FVector& Start, const FVector& End, float Radius, int32 IgnoreID, const TSet<int32>* AlreadyHit, float& OutTime) const;
+
+	// Appends the index into the built targets of every target overlapping the capsule from Start to End with Radius
+	// Each target is appended once in TargetID order even when it spans several cells, targets with IgnoreID are skipped
+	void OverlapCapsule(const FVector& Start, const FVector& End, float Radius, int32 IgnoreID, TArray<int32>& OutIndices) const;
+
+	const FSpellTargetBounds& GetTarget(int32 Index) const { return Targets[Index]; }
+
+	int32 Num() const { return Targets.Num(); }
+
+private:
+
+	FIntVector ToCell(const FVector& Location) const;
+
+	TArray<FSpellTargetBounds> Targets;
+
+	TMap<FIntVector, TArray<int32>> Cells; // indices into Targets
+
+	float CellSize;
+};
+
+
+/* A spell projectile that moves along an analytic arc instead of being simulated by physics */
+struct FSpellProjectile
+{
+	FVector Origin;
+
+	FVector Velocity;
+
+	float GravityZ;
+
+	float Radius;
+
+	double LaunchTime;
+
+	double LastStepTime;
+
+	float MaxLifeTime;
+
+	int32 OwnerID; // target ID of the caster, never hit by its own projectile
+
+	int32 ProjectileID;
+
+	TSet<int32> TargetsHit; // O(1) membership, replaces the CharactersHit TArray
+
+	// Position at Time seconds after the launch
+	FVector GetLocationAt(double Time) const
+	{
+		const float Elapsed = (float)(Time - LaunchTime);
+		return Origin + (Velocity * Elapsed) + FVector(0.f, 0.f, 0.5f * GravityZ * Elapsed * Elapsed);
+	}
+
+	// Velocity at Time seconds after the launch
+	FVector GetVelocityAt(double Time) const
+	{
+		return Velocity + FVector(0.f, 0.f, GravityZ * (float)(Time - LaunchTime));
+	}
+};
+
+
+/* First hit found for a projectile during a step */
+struct FSpellProjectileHit
+{
+	int32 ProjectileID;
+
+	int32 TargetID;
+
+	FVector Location;
+
+	double Time;
+};
+
+
+/* Steps every active spell projectile against the spatial hash in one pass */
+class FSpellProjectileSimulator
+{
+public:
+
+	FSpellProjectileSimulator()
+	{
+		NextProjectileID = 1;
+	}
+
+	// Returns an ID that is reported in FSpellProjectileHit
+	int32 Launch(const FVector& Origin, const FVector& Velocity, float GravityZ, float Radius, float MaxLifeTime, int32 OwnerID, double Now);
+
+	void Remove(int32 ProjectileID);
+
+	// Moves every projectile to Now, appends the first hit of each projectile in ProjectileID order and removes the projectiles that hit or expired
+	// The IDs of projectiles that expired without a hit are appended to OutExpired
+	void Step(double Now, const FSpellSpatialHash& SpatialHash, TArray<FSpellProjectileHit>& OutHits, TArray<int32>& OutExpired);
+
+	int32 Num() const { return Projectiles.Num(); }
+
+	// Projectiles still in flight, LastStepTime is the time of the last Step()
+	const TArray<FSpellProjectile>& GetProjectiles() const { return Projectiles; }
+
+private:
+
+	TArray<FSpellProjectile> Projectiles; // kept in launch order
+
+	int32 NextProjectileID;
+};
@@ -0,0 +1,72 @@
+/* Aaron Gallagher's Spell System Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+// Fires a projectile for Spell, Spell->OnProjectileHit() is called with the first character it reaches
+int32 USpellProjectileSubsystem::LaunchProjectile(ADamageOverTimeSpellBase* Spell, const FVector& Origin, const FVector& Velocity, float Radius, float MaxLifeTime)
+{
+	if (!Spell) return INDEX_NONE;
+	const AActor* Caster = Spell->GetOwner();
+	const int32 OwnerID = Caster ? (int32)Caster->GetUniqueID() : INDEX_NONE;
+	const int32 ProjectileID = Simulator.Launch(Origin, Velocity, GetWorld()->GetGravityZ(), Radius, MaxLifeTime, OwnerID, GetWorld()->GetTimeSeconds());
+	SpellsByProjectileID.Add(ProjectileID, Spell);
+	return ProjectileID;
+}
+
+// Steps every projectile in one pass, hands the hits back to their spells and moves the spells still in flight
+void USpellProjectileSubsystem::Tick(float DeltaTime)
+{
+	BuildTargets();
+
+	PendingHits.Reset();
+	ExpiredProjectiles.Reset();
+	Simulator.Step(GetWorld()->GetTimeSeconds(), SpatialHash, PendingHits, ExpiredProjectiles);
+
+	for (const FSpellProjectileHit& Hit : PendingHits)
+	{
+		TWeakObjectPtr<ADamageOverTimeSpellBase> Spell;
+		if (!SpellsByProjectileID.RemoveAndCopyValue(Hit.ProjectileID, Spell) || !Spell.IsValid()) continue;
+		if (ACharacter* Character = CharactersByTargetID.FindRef(Hit.TargetID).Get())
+		{
+			Spell->OnProjectileHit(Character, Hit.Location);
+		}
+	}
+
+	for (int32 ProjectileID : ExpiredProjectiles)
+	{
+		TWeakObjectPtr<ADamageOverTimeSpellBase> Spell;
+		if (SpellsByProjectileID.RemoveAndCopyValue(ProjectileID, Spell) && Spell.IsValid())
+		{
+			Spell->ReturnSpellMesh(); // missed, return the spell mesh the same way a hit does
+		}
+	}
+
+	// Projectiles still in flight carry their spell's capsule and particle along the arc
+	for (const FSpellProjectile& Projectile : Simulator.GetProjectiles())
+	{
+		if (ADamageOverTimeSpellBase* Spell = SpellsByProjectileID.FindRef(Projectile.ProjectileID).Get())
+		{
+			Spell->OnProjectileMoved(Projectile.GetLocationAt(Projectile.LastStepTime), Projectile.GetVelocityAt(Projectile.LastStepTime));
+		}
+	}
+}
+
+// Rebuilds the spatial hash from the capsule of every character in the World
+void USpellProjectileSubsystem::BuildTargets()
+{
+	TargetBounds.Reset();
+	CharactersByTargetID.Reset();
+	for (TActorIterator<ACharacter> It(GetWorld()); It; ++It)
+	{
+		ACharacter* Character = *It;
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+		if (!Capsule) continue;
+
+		FSpellTargetBounds& Bounds = TargetBounds.AddDefaulted_GetRef();
+		Bounds.Center = Capsule->GetComponentLocation();
+		Bounds.Radius = Capsule->GetScaledCapsuleHalfHeight(); // sphere around the whole capsule
+		Bounds.TargetID = (int32)Character->GetUniqueID();
+		CharactersByTargetID.Add(Bounds.TargetID, Character);
+	}
+	SpatialHash.Build(TargetBounds, CellSize);
+}
@@ -0,0 +1,45 @@
+#pragma once
+/* Aaron Gallagher's Spell System Samples */
+/* All samples are coded to Unreal Engine coding standards */
+
+
+/* Lightweight projectile mode for spells, projectiles follow an analytic arc and are tested against a spatial hash of every character */
+/* Replaces a physics simulated collision capsule and overlap events per projectile */
+UCLASS()
+class RPGFIX_API USpellProjectileSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	// Fires a projectile for Spell, Spell->OnProjectileHit() is called with the first character it reaches
+	int32 LaunchProjectile(ADamageOverTimeSpellBase* Spell, const FVector& Origin, const FVector& Velocity, float Radius, float MaxLifeTime);
+
+	// Size of a grid cell, roughly the diameter of the largest character
+	UPROPERTY(EditAnywhere, Category = "Spells")
+	float CellSize = 200.f;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return !IsTemplate() && Simulator.Num() > 0; }
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(USpellProjectileSubsystem, STATGROUP_Tickables); }
+
+private:
+
+	// Rebuilds the spatial hash from the capsule of every character in the World
+	void BuildTargets();
+
+	FSpellProjectileSimulator Simulator;
+
+	FSpellSpatialHash SpatialHash;
+
+	TMap<int32, TWeakObjectPtr<ADamageOverTimeSpellBase>> SpellsByProjectileID;
+
+	TMap<int32, TWeakObjectPtr<ACharacter>> CharactersByTargetID; // rebuilt every frame with the spatial hash
+
+	TArray<FSpellTargetBounds> TargetBounds; // reused every frame
+
+	TArray<FSpellProjectileHit> PendingHits; // reused every frame
+
+	TArray<int32> ExpiredProjectiles; // reused every frame
+};